@@ -31,13 +31,27 @@
 #include <Arduino.h>
 #include <M5Core2.h>
 
+#define ASSIST_NOW_CLIENT_BUFFER 1024
+#define ASSIST_NOW_CLIENT_RING 4096
+#define ASSIST_NOW_CLIENT_ACK_TIMEOUT 100
+#define ASSIST_NOW_CLIENT_REFRESH 3600000
+#define ASSIST_NOW_CLIENT_RETRY 60000
+
 struct assist_now_client
 {
     bool update;
     bool active;
+    uint16_t messages;
+    uint32_t first_message;
+    uint32_t duration;
+    uint32_t peak_heap;
 };
 
 void assist_now_client_transfer(struct assist_now_client *assist_now_client_data);
+bool assist_now_client_push(const uint8_t *data, uint16_t length);
+void assist_now_client_inject(void);
+bool assist_now_client_queue(const uint8_t *data, uint16_t length);
 bool assist_now_client(struct sd_card_config2 *sd_card_config2_data);
+void assist_now_client_init(struct assist_now_client *assist_now_client_data);
 
 #endif
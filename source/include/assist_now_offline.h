@@ -0,0 +1,46 @@
+/**
+ * @file assist_now_offline.h
+ *
+ * @brief AssistNow Offline related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef ASSISTNOWOFFLINE_H_
+#define ASSISTNOWOFFLINE_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "sd_card.h"
+
+#define ASSIST_NOW_OFFLINE_FILE "/data/mga_ano.ubx"
+#define ASSIST_NOW_OFFLINE_TEMP "/data/mga_ano.tmp"
+#define ASSIST_NOW_OFFLINE_META "/data/mga_ano.txt"
+#define ASSIST_NOW_OFFLINE_REFRESH 86400
+#define ASSIST_NOW_OFFLINE_ID_ANO 0x20
+
+bool assist_now_offline_meta(unsigned long *download, unsigned int *period);
+bool assist_now_offline_inject(void);
+bool assist_now_offline(struct sd_card_config2 *sd_card_config2_data);
+
+#endif
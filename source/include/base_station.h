@@ -0,0 +1,63 @@
+/**
+ * @file base_station.h
+ *
+ * @brief Base station related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef BASESTATION_H_
+#define BASESTATION_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "sd_card.h"
+
+#define BASE_STATION_MODE_OFF 0
+#define BASE_STATION_MODE_SURVEY_IN 1
+#define BASE_STATION_MODE_FIXED 2
+#define BASE_STATION_BUFFER 8192
+#define BASE_STATION_TIMEOUT 30000
+
+struct base_station
+{
+    bool update;
+    uint8_t mode;
+    bool survey_in_active;
+    bool survey_in_valid;
+    uint32_t survey_in_duration;
+    float survey_in_accuracy;
+    bool server_active;
+    uint32_t bytes_per_second;
+    uint32_t frames;
+    uint32_t drops;
+};
+
+void base_station_transfer(struct base_station *base_station_data);
+void base_station_survey(void);
+void base_station(void);
+bool base_station_server(void);
+bool base_station_server_init(struct sd_card_config2 *sd_card_config2_data);
+bool base_station_init(struct base_station *base_station_data, struct sd_card_config2 *sd_card_config2_data);
+
+#endif
@@ -36,6 +36,7 @@ struct battery
     bool update;
     float level;
     bool charging;
+    float current;
 };
 
 void battery_transfer(struct battery *battery_data);
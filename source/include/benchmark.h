@@ -0,0 +1,54 @@
+/**
+ * @file benchmark.h
+ *
+ * @brief Benchmark related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "sd_card.h"
+
+#define BENCHMARK_FILE "/data/benchmark.csv"
+#define BENCHMARK_START_NORMAL 0
+#define BENCHMARK_START_HOT 1
+#define BENCHMARK_START_WARM 2
+#define BENCHMARK_START_COLD 3
+#define BENCHMARK_RECEIVER_UP 0
+#define BENCHMARK_FIX_OK 1
+#define BENCHMARK_DGNSS 2
+#define BENCHMARK_FLOAT 3
+#define BENCHMARK_FIXED 4
+#define BENCHMARK_MILESTONES 5
+
+void benchmark_milestone(uint8_t milestone);
+bool benchmark_save(void);
+void benchmark(void);
+bool benchmark_reset(void);
+void benchmark_init(struct sd_card_config2 *sd_card_config2_data);
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file ble_packet.h
+ *
+ * @brief BLE packet related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef BLEPACKET_H_
+#define BLEPACKET_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BLE_PACKET_MTU_DEFAULT 23
+#define BLE_PACKET_ATT_HEADER 3
+#define BLE_PACKET_PAYLOAD_MAX 244
+#define BLE_PACKET_FIX_SYNC_CHAR_1 0xA5
+#define BLE_PACKET_FIX_SYNC_CHAR_2 0x5A
+#define BLE_PACKET_FIX_VERSION 1
+#define BLE_PACKET_FIX_LENGTH 26
+#define BLE_PACKET_FIX_FRAME_LENGTH (BLE_PACKET_FIX_LENGTH + 6)
+
+typedef void (*ble_packet_send)(const uint8_t *data, uint16_t length);
+
+struct ble_packet_fix
+{
+    uint32_t timestamp;
+    int32_t lat;
+    int32_t lon;
+    int8_t lat_hp;
+    int8_t lon_hp;
+    int32_t height;
+    uint32_t acc;
+    uint8_t fix_type;
+    uint8_t carr_soln;
+    uint8_t num_sv;
+    uint8_t flags;
+};
+
+struct ble_packetizer
+{
+    uint8_t buffer[BLE_PACKET_PAYLOAD_MAX];
+    uint16_t length;
+    uint16_t payload;
+    uint32_t packets;
+    uint32_t bytes;
+};
+
+uint16_t ble_packet_fix_encode(const struct ble_packet_fix *ble_packet_fix_data, uint8_t *frame);
+bool ble_packet_fix_decode(const uint8_t *frame, uint16_t length, struct ble_packet_fix *ble_packet_fix_data);
+void ble_packet_write(struct ble_packetizer *ble_packetizer_data, const uint8_t *data, uint16_t length, ble_packet_send send);
+void ble_packet_flush(struct ble_packetizer *ble_packetizer_data, ble_packet_send send);
+void ble_packet_init(struct ble_packetizer *ble_packetizer_data, uint16_t mtu);
+
+#endif
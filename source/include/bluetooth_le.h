@@ -0,0 +1,57 @@
+/**
+ * @file bluetooth_le.h
+ *
+ * @brief Bluetooth LE related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef BLUETOOTHLE_H_
+#define BLUETOOTHLE_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "sd_card.h"
+
+#define BLUETOOTH_LE_SERVICE_UUID "6E400001-B5A3-F393-E0A9-E50E24DCCA9E"
+#define BLUETOOTH_LE_RX_UUID "6E400002-B5A3-F393-E0A9-E50E24DCCA9E"
+#define BLUETOOTH_LE_TX_UUID "6E400003-B5A3-F393-E0A9-E50E24DCCA9E"
+#define BLUETOOTH_LE_OUTPUT_NMEA 0
+#define BLUETOOTH_LE_OUTPUT_BINARY 1
+#define BLUETOOTH_LE_MTU 247
+
+struct bluetooth_le
+{
+    bool update;
+    bool active;
+    uint16_t mtu;
+    uint32_t bytes_per_second;
+    uint32_t notifications;
+    uint32_t drops;
+};
+
+void bluetooth_le_transfer(struct bluetooth_le *bluetooth_le_data);
+void bluetooth_le(void);
+bool bluetooth_le_init(struct bluetooth_le *bluetooth_le_data, struct sd_card_config2 *sd_card_config2_data);
+
+#endif
@@ -30,15 +30,28 @@
 
 #include <Arduino.h>
 #include <M5Core2.h>
+#include "sd_card.h"
+
+#define BLUETOOTH_SERIAL_BUFFER 4096
+#define BLUETOOTH_SERIAL_INBOUND 1024
+#define BLUETOOTH_SERIAL_WAIT 100
 
 struct bluetooth_serial
 {
     bool update;
     bool active;
+    uint32_t writes;
+    uint32_t bytes_per_write;
+    uint32_t latency;
+    uint32_t latency_max;
+    uint32_t splits;
+    uint32_t drops;
 };
 
 void bluetooth_serial_transfer(struct bluetooth_serial *bluetooth_serial_data);
-void bluetooth_serial(void);
-bool bluetooth_serial_init(struct bluetooth_serial *bluetooth_serial_data);
+void bluetooth_serial_wait(void);
+void bluetooth_serial_output(void);
+bool bluetooth_serial(void);
+bool bluetooth_serial_init(struct bluetooth_serial *bluetooth_serial_data, struct sd_card_config2 *sd_card_config2_data);
 
 #endif
@@ -0,0 +1,103 @@
+/**
+ * @file bus.h
+ *
+ * @brief Publish/subscribe data bus related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef BUS_H_
+#define BUS_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "gnss.h"
+#include "correction.h"
+
+#define BUS_TOPIC_GNSS 0
+#define BUS_TOPIC_SATELLITES 1
+#define BUS_TOPIC_LINK 2
+#define BUS_TOPIC_SURVEY 3
+#define BUS_TOPIC_CORRECTION 4
+#define BUS_TOPICS 5
+#define BUS_SUBSCRIBERS 4
+#define BUS_RETRIES 8
+
+struct bus_gnss
+{
+    uint32_t i_tow;
+    uint32_t i_tow_hp;
+    uint8_t fix_type;
+    bool gnss_fix_ok;
+    bool diff_soln;
+    uint8_t carr_soln;
+    uint8_t num_sv;
+    double g_speed;
+    double head_mot;
+    uint8_t a_status;
+    double lon;
+    double lat;
+    double height;
+    double p_acc;
+    double rel_pos_length;
+    double acc_length;
+};
+
+struct bus_satellites
+{
+    struct gnss_satellite_info gnss_satellite_info_gps_data[16];
+    struct gnss_satellite_info gnss_satellite_info_galileo_data[16];
+    struct gnss_satellite_info gnss_satellite_info_glonass_data[16];
+    struct gnss_satellite_info gnss_satellite_info_beidou_data[16];
+    struct gnss_satellite_info gnss_satellite_info_sbas_data[16];
+};
+
+struct bus_link
+{
+    bool wlan_client_active;
+    bool assist_now_client_active;
+    bool ntrip_client_active;
+    bool base_station_server_active;
+    bool bluetooth_serial_active;
+};
+
+struct bus_survey
+{
+    bool survey_in_active;
+    bool survey_in_valid;
+    uint32_t survey_in_duration;
+    float survey_in_accuracy;
+};
+
+struct bus_correction
+{
+    uint8_t source;
+    uint32_t source_millis;
+};
+
+void bus_publish(uint8_t topic, const void *data);
+bool bus_read(uint8_t topic, void *data, uint32_t *version);
+bool bus_subscribe(uint8_t topic, TaskHandle_t handle);
+void bus_init(void);
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file correction.h
+ *
+ * @brief Correction related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef CORRECTION_H_
+#define CORRECTION_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+
+#define CORRECTION_GAP_BUCKETS 6
+#define CORRECTION_MESSAGE_TYPES 12
+#define CORRECTION_SOURCE_NTRIP 0
+#define CORRECTION_SOURCE_BLUETOOTH 1
+#define CORRECTION_SOURCE_REPLAY 2
+#define CORRECTION_SOURCES 3
+#define CORRECTION_SOURCE_NONE UINT8_MAX
+#define CORRECTION_SOURCE_TIMEOUT 5000
+
+struct correction_message_type
+{
+    uint16_t type;
+    uint32_t count;
+};
+
+struct correction
+{
+    bool update;
+    uint32_t bytes_per_second;
+    uint32_t age;
+    uint32_t reconnects;
+    uint32_t frames;
+    uint32_t frame_errors;
+    uint32_t gap_histogram[CORRECTION_GAP_BUCKETS];
+    struct correction_message_type message_types[CORRECTION_MESSAGE_TYPES];
+    uint8_t source;
+    uint32_t source_bytes_per_second[CORRECTION_SOURCES];
+    uint32_t source_frame_errors[CORRECTION_SOURCES];
+    uint32_t source_drops[CORRECTION_SOURCES];
+};
+
+void correction_transfer(struct correction *correction_data);
+bool correction_push(uint8_t source, uint8_t *data, uint16_t length);
+void correction_connect(void);
+void correction_init(struct correction *correction_data);
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file diagnostics.h
+ *
+ * @brief Runtime diagnostics related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef DIAGNOSTICS_H_
+#define DIAGNOSTICS_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_system.h>
+#include <esp_heap_caps.h>
+#include "sd_card.h"
+#include "task_load.h"
+#include "frame.h"
+
+#define DIAGNOSTICS_STACK_LOW 512
+#define DIAGNOSTICS_FRAGMENTATION_HIGH 50
+#define DIAGNOSTICS_REPORT 600000
+
+struct diagnostics
+{
+    bool update;
+    uint8_t reset_reason;
+    uint32_t heap_free;
+    uint32_t heap_min;
+    uint32_t heap_largest;
+    uint32_t heap_largest_min;
+    uint8_t fragmentation;
+    uint32_t alloc_failures;
+    uint32_t alloc_failed_size;
+    uint32_t psram_free;
+    uint32_t psram_largest;
+    uint8_t load[TASK_LOAD_TASKS];
+    uint8_t load_max[TASK_LOAD_TASKS];
+    uint32_t stack_size[TASK_LOAD_TASKS];
+    uint32_t stack_free[TASK_LOAD_TASKS];
+    uint8_t frames_per_second;
+    uint32_t frame_time_max;
+};
+
+const char *diagnostics_reset_text(uint8_t reset_reason);
+void diagnostics_alloc_failed(size_t size, uint32_t caps, const char *function_name);
+void diagnostics_task(uint8_t task, TaskHandle_t handle, uint32_t stack_size);
+void diagnostics_transfer(struct diagnostics *diagnostics_data, struct task_load *task_load_data, struct frame *frame_data);
+void diagnostics_init(struct diagnostics *diagnostics_data, struct sd_card_config2 *sd_card_config2_data);
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file frame.h
+ *
+ * @brief Frame pacing of the user interface related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+
+#define FRAME_RATE 15
+#define FRAME_IDLE 250
+#define FRAME_TOUCH_HOLD 500
+#define FRAME_REPORT 60000
+
+struct frame
+{
+    bool update;
+    uint8_t frames_per_second;
+    uint8_t wakeups_per_second;
+    uint8_t idle;
+    uint32_t frame_time;
+    uint32_t frame_time_max;
+};
+
+void frame_touch(void);
+void frame_wait(void);
+bool frame_due(void);
+void frame_begin(void);
+void frame_end(bool drawn);
+void frame_transfer(struct frame *frame_data);
+void frame_init(struct frame *frame_data);
+
+#endif
@@ -30,6 +30,7 @@
 
 #include <Arduino.h>
 #include <M5Core2.h>
+#include "sd_card.h"
 
 #define GNSS_EN 19
 
@@ -66,6 +67,6 @@ struct gnss
 
 void gnss_transfer(struct gnss *gnss_data);
 void gnss(struct gnss *gnss_data);
-bool gnss_init(struct gnss *gnss_data);
+bool gnss_init(struct gnss *gnss_data, struct sd_card_config2 *sd_card_config2_data);
 
 #endif
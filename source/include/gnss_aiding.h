@@ -0,0 +1,54 @@
+/**
+ * @file gnss_aiding.h
+ *
+ * @brief GNSS aiding related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef GNSSAIDING_H_
+#define GNSSAIDING_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+
+#define GNSS_AIDING_NAMESPACE "gnss"
+#define GNSS_AIDING_KEY_POSITION "position"
+#define GNSS_AIDING_TTFF "/data/ttff.csv"
+#define GNSS_AIDING_PERIOD 600000
+#define GNSS_AIDING_POSITION_ACC_MIN 1000
+
+struct gnss_aiding_position
+{
+    int32_t lat;
+    int32_t lon;
+    int32_t height;
+    uint32_t acc;
+};
+
+void gnss_aiding_ttff(uint32_t ttff);
+bool gnss_aiding_save(void);
+void gnss_aiding(void);
+bool gnss_aiding_init(void);
+
+#endif
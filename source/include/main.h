@@ -31,7 +31,33 @@
 #include <Arduino.h>
 #include <M5Core2.h>
 
+#define TASK_PRIORITY_UART 5
+#define TASK_PRIORITY_GNSS 4
+#define TASK_PRIORITY_NETWORK 3
+#define TASK_PRIORITY_BLUETOOTH 3
+#define TASK_PRIORITY_UI 2
+#define TASK_PRIORITY_CONNECT 1
+#define TASK_CORE_ANY 2
+#define TASK_STACK_UART 3000
+#define TASK_STACK_GNSS 5000
+#define TASK_STACK_NETWORK 10000
+#define TASK_STACK_BLUETOOTH 4000
+#define TASK_STACK_CONNECT 6000
+#define TASK_GNSS_PERIOD 5
+#define TASK_NETWORK_PERIOD 1
+#define TASK_JOB_NTRIP_CLIENT 0
+#define TASK_JOB_NTRIP_SERVER 1
+#define TASK_JOB_ASSIST_NOW_OFFLINE 2
+#define TASK_JOB_ASSIST_NOW 3
+#define TASK_JOBS 4
+#define TASK_JOB_IDLE 0
+#define TASK_JOB_QUEUED 1
+#define TASK_JOB_DONE 2
+
 void subtask1(void *parameter);
 void subtask2(void *parameter);
+void subtask3(void *parameter);
+void subtask4(void *parameter);
+void subtask5(void *parameter);
 
 #endif
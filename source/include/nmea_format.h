@@ -0,0 +1,82 @@
+/**
+ * @file nmea_format.h
+ *
+ * @brief NMEA format related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef NMEAFORMAT_H_
+#define NMEAFORMAT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define NMEA_FORMAT_SATELLITES 64
+#define NMEA_FORMAT_PRECISION_STANDARD 0
+#define NMEA_FORMAT_PRECISION_HIGH 1
+
+struct nmea_satellite
+{
+    uint8_t gnss_id;
+    uint8_t sv_id;
+    int8_t elevation;
+    int16_t azimuth;
+    uint8_t cno;
+    bool used;
+};
+
+struct nmea_epoch
+{
+    bool time_valid;
+    bool date_valid;
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    int32_t nano;
+    uint8_t fix_type;
+    bool fix_ok;
+    bool diff_soln;
+    uint8_t carr_soln;
+    uint8_t num_sv;
+    int64_t lat;
+    int64_t lon;
+    int32_t height;
+    int32_t height_msl;
+    uint32_t h_acc;
+    uint32_t v_acc;
+    int32_t speed;
+    int32_t course;
+    uint16_t pdop;
+    uint16_t hdop;
+    uint16_t vdop;
+    uint8_t satellites;
+    struct nmea_satellite satellite[NMEA_FORMAT_SATELLITES];
+};
+
+uint16_t nmea_format(const struct nmea_epoch *nmea_epoch_data, uint32_t sentences, uint8_t precision, char *data, uint16_t size);
+
+#endif
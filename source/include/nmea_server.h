@@ -0,0 +1,61 @@
+/**
+ * @file nmea_server.h
+ *
+ * @brief NMEA server related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef NMEASERVER_H_
+#define NMEASERVER_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <WiFiClient.h>
+#include "output_hub.h"
+#include "sd_card.h"
+
+#define NMEA_SERVER_CLIENTS 4
+#define NMEA_SERVER_TIMEOUT 30000
+
+struct nmea_server_client
+{
+    WiFiClient wifi_client;
+    bool active;
+    unsigned long timestamp;
+    struct output_hub_sink output_hub_sink_data;
+};
+
+struct nmea_server
+{
+    bool update;
+    uint8_t clients;
+    uint32_t bytes_per_second;
+    uint32_t drops;
+};
+
+void nmea_server_transfer(struct nmea_server *nmea_server_data);
+void nmea_server(void);
+bool nmea_server_init(struct nmea_server *nmea_server_data, struct sd_card_config2 *sd_card_config2_data);
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file ntrip_caster.h
+ *
+ * @brief NTRIP caster related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef NTRIPCASTER_H_
+#define NTRIPCASTER_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <WiFiClient.h>
+#include "ring_buffer.h"
+
+#define NTRIP_CASTER_CLIENTS 10
+#define NTRIP_CASTER_BUFFER 4096
+#define NTRIP_CASTER_TIMEOUT 30000
+#define NTRIP_CASTER_STATE_FREE 0
+#define NTRIP_CASTER_STATE_REQUEST 1
+#define NTRIP_CASTER_STATE_STREAM 2
+
+struct ntrip_caster_client
+{
+    WiFiClient wifi_client;
+    uint8_t state;
+    char request[256];
+    uint16_t request_length;
+    unsigned long timestamp;
+    struct ring_buffer ring_buffer_data;
+};
+
+void ntrip_caster_stop(struct ntrip_caster_client *ntrip_caster_client_data);
+void ntrip_caster_request(struct ntrip_caster_client *ntrip_caster_client_data);
+void ntrip_caster_push(const uint8_t *data, uint16_t length);
+void ntrip_caster(void);
+bool ntrip_caster_reserve(void);
+bool ntrip_caster_init(struct sd_card_config2 *sd_card_config2_data);
+
+#endif
@@ -31,6 +31,9 @@
 #include <Arduino.h>
 #include <M5Core2.h>
 
+#define NTRIP_CLIENT_TIMEOUT 10000
+#define NTRIP_CLIENT_RETRY 5000
+
 struct ntrip_client
 {
     bool update;
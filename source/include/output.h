@@ -0,0 +1,65 @@
+/**
+ * @file output.h
+ *
+ * @brief Output related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef OUTPUT_H_
+#define OUTPUT_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "output_hub.h"
+#include "nmea_format.h"
+#include "sd_card.h"
+
+#define OUTPUT_HUB_SIZE 16384
+#define OUTPUT_EPOCH 4096
+#define OUTPUT_EPOCH_IDLE 50
+#define OUTPUT_SOURCE_RECEIVER 0
+#define OUTPUT_SOURCE_UBX 1
+#define OUTPUT_SUBSCRIBERS 2
+#define OUTPUT_USB_BAUD 115200
+
+struct output
+{
+    bool update;
+    uint32_t epochs;
+    uint32_t bytes_per_second;
+    uint32_t overflows;
+    uint32_t usb_drops;
+};
+
+bool output_subscribe(TaskHandle_t handle);
+uint32_t output_peek(struct output_hub_sink *output_hub_sink_data, const uint8_t **data, bool *end, uint32_t *timestamp);
+bool output_consume(struct output_hub_sink *output_hub_sink_data, uint32_t length);
+void output_sink_init(struct output_hub_sink *output_hub_sink_data, const char *sentences, uint8_t decimation, uint8_t precision);
+void output_nmea(const struct nmea_epoch *nmea_epoch_data, bool satellites);
+void output_transfer(struct output *output_data);
+void output_usb(void);
+void output_usb_start(struct sd_card_config2 *sd_card_config2_data);
+bool output_init(struct output *output_data, struct sd_card_config2 *sd_card_config2_data);
+
+#endif
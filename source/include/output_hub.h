@@ -0,0 +1,84 @@
+/**
+ * @file output_hub.h
+ *
+ * @brief Output hub related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef OUTPUTHUB_H_
+#define OUTPUTHUB_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define OUTPUT_HUB_HEADER 16
+#define OUTPUT_HUB_PAD 0xFFFFFFFF
+#define OUTPUT_HUB_SENTENCE_GGA 0x00000001
+#define OUTPUT_HUB_SENTENCE_GLL 0x00000002
+#define OUTPUT_HUB_SENTENCE_GSA 0x00000004
+#define OUTPUT_HUB_SENTENCE_GST 0x00000008
+#define OUTPUT_HUB_SENTENCE_GSV 0x00000010
+#define OUTPUT_HUB_SENTENCE_RMC 0x00000020
+#define OUTPUT_HUB_SENTENCE_VTG 0x00000040
+#define OUTPUT_HUB_SENTENCE_ZDA 0x00000080
+#define OUTPUT_HUB_SENTENCE_GNS 0x00000100
+#define OUTPUT_HUB_SENTENCE_TXT 0x00000200
+#define OUTPUT_HUB_SENTENCE_OTHER 0x80000000
+#define OUTPUT_HUB_SENTENCE_ALL 0xFFFFFFFF
+#define OUTPUT_HUB_VARIANT_ALL 0xFFFFFFFF
+
+struct output_hub
+{
+    uint8_t *data;
+    uint32_t size;
+    uint32_t head;
+    uint32_t reserve;
+    uint32_t last;
+    uint32_t epochs;
+    uint32_t overflows;
+};
+
+struct output_hub_sink
+{
+    uint32_t tail;
+    uint32_t offset;
+    bool started;
+    uint32_t filter;
+    uint32_t variant;
+    uint8_t decimation;
+    uint8_t decimation_counter;
+    uint32_t epochs;
+    uint32_t bytes;
+    uint32_t drops;
+};
+
+uint32_t output_hub_sentence(const uint8_t *sentence, uint32_t length);
+uint32_t output_hub_filter(const char *list);
+bool output_hub_publish(struct output_hub *output_hub_data, const uint8_t *data, uint32_t length, uint32_t timestamp, uint32_t variant);
+uint32_t output_hub_peek(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data, const uint8_t **data, bool *end, uint32_t *timestamp);
+bool output_hub_consume(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data, uint32_t length);
+void output_hub_sink_init(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data, uint32_t filter, uint32_t variant, uint8_t decimation);
+void output_hub_init(struct output_hub *output_hub_data, uint8_t *data, uint32_t size);
+
+#endif
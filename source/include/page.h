@@ -31,6 +31,9 @@
 #include <Arduino.h>
 #include <M5Core2.h>
 #include "gnss.h"
+#include "correction.h"
+#include "base_station.h"
+#include "diagnostics.h"
 
 #define LIGHTBLUE    0xB6DF
 #define LIGHTTEAL    0xBF5F
@@ -52,7 +55,7 @@
 #define DARKPINK     0x9009
 #define DARKPURPLE   0x4010
 
-#define PAGE_TOTAL 11
+#define PAGE_TOTAL 14
 
 #define PAGE_CLOCK_X 200
 #define PAGE_CLOCK_Y 110
@@ -126,7 +129,58 @@ struct page_satellite_info
     struct gnss_satellite_info gnss_satellite_info_data[16];
 };
 
-void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real_time_clock *real_time_clock_data, struct battery *battery_data, struct gnss *gnss_data, struct bluetooth_serial *bluetooth_serial_data, struct wlan_client *wlan_client_data, struct assist_now_client *assist_now_client_data, struct ntrip_client *ntrip_client_data);
+struct page_correction
+{
+    uint8_t actual_page;
+    bool play;
+    bool ntrip_client_active;
+    uint32_t bytes_per_second;
+    uint32_t age;
+    uint32_t reconnects;
+    uint32_t frames;
+    uint32_t frame_errors;
+    uint32_t gap_histogram[CORRECTION_GAP_BUCKETS];
+    struct correction_message_type message_types[CORRECTION_MESSAGE_TYPES];
+    uint8_t source;
+};
+
+struct page_base_station
+{
+    uint8_t actual_page;
+    bool play;
+    uint8_t mode;
+    bool survey_in_active;
+    bool survey_in_valid;
+    uint32_t survey_in_duration;
+    float survey_in_accuracy;
+    bool server_active;
+    uint32_t bytes_per_second;
+    uint32_t frames;
+    uint32_t drops;
+};
+
+struct page_diagnostics
+{
+    uint8_t actual_page;
+    bool play;
+    uint8_t reset_reason;
+    uint32_t heap_free;
+    uint32_t heap_min;
+    uint32_t heap_largest;
+    uint32_t heap_largest_min;
+    uint8_t fragmentation;
+    uint32_t alloc_failures;
+    uint32_t psram_free;
+    uint32_t psram_largest;
+    uint8_t load[TASK_LOAD_TASKS];
+    uint8_t load_max[TASK_LOAD_TASKS];
+    uint32_t stack_size[TASK_LOAD_TASKS];
+    uint32_t stack_free[TASK_LOAD_TASKS];
+    uint8_t frames_per_second;
+    uint32_t frame_time_max;
+};
+
+bool page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real_time_clock *real_time_clock_data, struct battery *battery_data, struct gnss *gnss_data, struct bluetooth_serial *bluetooth_serial_data, struct wlan_client *wlan_client_data, struct assist_now_client *assist_now_client_data, struct ntrip_client *ntrip_client_data, struct correction *correction_data, struct base_station *base_station_data, struct diagnostics *diagnostics_data);
 void page_clock(struct page_clock *page_clock_data);
 void page_status1(struct page_status1 *page_status1_data);
 void page_status2(struct page_status2 *page_status2_data);
@@ -134,6 +188,11 @@ void page_navigation1(struct page_navigation1 *page_navigation1_data);
 void page_navigation2(struct page_navigation2 *page_navigation2_data);
 void page_relative_navigation(struct page_relative_navigation *page_relative_navigation_data);
 void page_satellite_info(struct page_satellite_info *page_satellite_info_data);
+void page_correction(struct page_correction *page_correction_data);
+void page_base_station(struct page_base_station *page_base_station_data);
+void page_diagnostics(struct page_diagnostics *page_diagnostics_data);
+void page_startup(void);
 void page_error(uint8_t error_code);
+bool page_init(void);
 
 #endif
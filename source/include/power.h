@@ -0,0 +1,55 @@
+/**
+ * @file power.h
+ *
+ * @brief Power management related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "sd_card.h"
+#include "battery.h"
+
+#define POWER_MODE_OFF 0
+#define POWER_MODE_DFS 1
+#define POWER_FREQUENCY_MAX 240
+#define POWER_FREQUENCY_MIN 80
+#define POWER_REPORT 600000
+
+struct power
+{
+    uint8_t mode;
+    bool display_on;
+    float current_display_on;
+    float current_display_off;
+};
+
+void power_display(bool display_on);
+void power_transfer(struct power *power_data, struct battery *battery_data, bool display_on);
+bool power_init(struct power *power_data, struct sd_card_config2 *sd_card_config2_data);
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * @file ring_buffer.h
+ *
+ * @brief Ring buffer related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef RINGBUFFER_H_
+#define RINGBUFFER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct ring_buffer
+{
+    uint8_t *data;
+    uint32_t size;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t drops;
+};
+
+uint32_t ring_buffer_used(struct ring_buffer *ring_buffer_data);
+uint32_t ring_buffer_free(struct ring_buffer *ring_buffer_data);
+bool ring_buffer_write(struct ring_buffer *ring_buffer_data, const uint8_t *data, uint32_t length);
+uint32_t ring_buffer_peek(struct ring_buffer *ring_buffer_data, const uint8_t **data);
+void ring_buffer_consume(struct ring_buffer *ring_buffer_data, uint32_t length);
+uint32_t ring_buffer_read(struct ring_buffer *ring_buffer_data, uint8_t *data, uint32_t length);
+void ring_buffer_clear(struct ring_buffer *ring_buffer_data);
+void ring_buffer_init(struct ring_buffer *ring_buffer_data, uint8_t *data, uint32_t size);
+
+#endif
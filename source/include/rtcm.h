@@ -0,0 +1,65 @@
+/**
+ * @file rtcm.h
+ *
+ * @brief RTCM related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef RTCM_H_
+#define RTCM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define RTCM_PREAMBLE 0xD3
+#define RTCM_FRAME_LENGTH_MAX 1029
+#define RTCM_PACER_RESYNC 60000
+
+struct rtcm_parser
+{
+    uint8_t frame[RTCM_FRAME_LENGTH_MAX];
+    uint16_t length;
+    uint16_t frame_length;
+    uint16_t pending;
+    bool resync;
+    uint32_t errors;
+};
+
+struct rtcm_pacer
+{
+    bool started;
+    uint16_t system;
+    uint32_t epoch;
+    uint32_t timestamp;
+};
+
+uint32_t rtcm_crc24q(const uint8_t *data, uint16_t length);
+uint16_t rtcm_message_type(const uint8_t *frame);
+bool rtcm_parse(struct rtcm_parser *rtcm_parser_data, uint8_t data);
+void rtcm_parser_init(struct rtcm_parser *rtcm_parser_data);
+bool rtcm_msm_epoch(const uint8_t *frame, uint16_t *system, uint32_t *epoch);
+uint32_t rtcm_pacer_delay(struct rtcm_pacer *rtcm_pacer_data, const uint8_t *frame, uint32_t timestamp);
+void rtcm_pacer_init(struct rtcm_pacer *rtcm_pacer_data);
+
+#endif
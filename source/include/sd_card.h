@@ -47,6 +47,10 @@ struct sd_card_config2
 {
     char wlan_ssid[256];
     char wlan_password[256];
+    char wlan2_ssid[256];
+    char wlan2_password[256];
+    char wlan3_ssid[256];
+    char wlan3_password[256];
     char assist_now_server[256];
     char assist_now_token[30];
     char ntrip_server[256];
@@ -54,6 +58,60 @@ struct sd_card_config2
     char ntrip_mount_point[256];
     char ntrip_user[256];
     char ntrip_password[256];
+    uint8_t ntrip_caster_enable;
+    uint16_t ntrip_caster_port;
+    char ntrip_caster_mount_point[256];
+    uint8_t base_mode;
+    uint32_t base_survey_in_duration;
+    float base_survey_in_accuracy;
+    double base_ecef_x;
+    double base_ecef_y;
+    double base_ecef_z;
+    char base_server[256];
+    uint16_t base_port;
+    char base_mount_point[256];
+    char base_user[256];
+    char base_password[256];
+    uint8_t base_version;
+    uint8_t replay_enable;
+    char replay_file[256];
+    uint8_t replay_loop;
+    uint8_t assist_now_offline_enable;
+    char assist_now_offline_server[256];
+    uint8_t assist_now_offline_period;
+    uint8_t benchmark_enable;
+    uint8_t benchmark_start;
+    uint16_t benchmark_timeout;
+    uint8_t benchmark_restart;
+    uint8_t bluetooth_le_enable;
+    uint8_t bluetooth_le_output;
+    char bluetooth_le_sentences[64];
+    uint8_t bluetooth_le_decimation;
+    uint8_t bluetooth_le_precision;
+    char output_bluetooth_sentences[64];
+    uint8_t output_bluetooth_decimation;
+    uint8_t output_bluetooth_precision;
+    uint8_t output_tcp_enable;
+    uint16_t output_tcp_port;
+    char output_tcp_sentences[64];
+    uint8_t output_tcp_decimation;
+    uint8_t output_tcp_precision;
+    uint8_t output_usb_enable;
+    char output_usb_sentences[64];
+    uint8_t output_usb_decimation;
+    uint8_t output_usb_precision;
+    uint8_t ubx_bridge_enable;
+    uint8_t ubx_bridge_transport;
+    uint16_t ubx_bridge_port;
+    uint8_t nmea_source;
+    char nmea_sentences[64];
+    uint8_t nmea_rate;
+    uint8_t task_uart_core;
+    uint8_t task_gnss_core;
+    uint8_t task_network_core;
+    uint8_t diagnostics_csv;
+    uint16_t diagnostics_period;
+    uint8_t power_mode;
 };
 
 bool sd_card_config_read(struct sd_card_config1 *sd_card_config1_data, struct sd_card_config2 *sd_card_config2_data);
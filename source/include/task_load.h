@@ -0,0 +1,56 @@
+/**
+ * @file task_load.h
+ *
+ * @brief Task load related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef TASK_LOAD_H_
+#define TASK_LOAD_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+
+#define TASK_LOAD_UART 0
+#define TASK_LOAD_GNSS 1
+#define TASK_LOAD_NETWORK 2
+#define TASK_LOAD_UI 3
+#define TASK_LOAD_BLUETOOTH 4
+#define TASK_LOAD_CONNECT 5
+#define TASK_LOAD_TASKS 6
+#define TASK_LOAD_REPORT 60000
+
+struct task_load
+{
+    bool update;
+    uint8_t load[TASK_LOAD_TASKS];
+    uint8_t load_max[TASK_LOAD_TASKS];
+};
+
+void task_load_begin(uint8_t task);
+void task_load_end(uint8_t task);
+void task_load_transfer(struct task_load *task_load_data);
+void task_load_init(struct task_load *task_load_data);
+
+#endif
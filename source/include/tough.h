@@ -31,6 +31,8 @@
 #include <Arduino.h>
 #include <M5Core2.h>
 
+#define TOUCH_INT 39
+
 void touch_left(Event& e);
 void touch_middle(Event& e);
 void touch_right(Event& e);
@@ -0,0 +1,71 @@
+/**
+ * @file uart_reader.h
+ *
+ * @brief UART reader related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef UARTREADER_H_
+#define UARTREADER_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "ring_buffer.h"
+
+#define UART_READER_RX_BUFFER 4096
+#define UART_READER_BUFFER 8192
+#define UART_READER_CHUNK 256
+#define UART_READER_WAIT 20
+#define UART_READER_SINKS 4
+#define UART_READER_SENTENCE 100
+
+typedef void (*uart_reader_sink)(const char *sentence, uint8_t length, uint32_t timestamp);
+
+class uart_reader_stream : public Stream
+{
+    public:
+    int available(void);
+    int read(void);
+    int peek(void);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t length);
+};
+
+struct uart_reader
+{
+    bool update;
+    uint32_t bytes_per_second;
+    uint32_t sentences;
+    uint32_t checksum_errors;
+    uint32_t drops;
+};
+
+void uart_reader_transfer(struct uart_reader *uart_reader_data);
+bool uart_reader_subscribe(uart_reader_sink sink);
+void uart_reader_tap(struct ring_buffer *ring_buffer_data);
+void uart_reader_wait(void);
+void uart_reader(void);
+void uart_reader_init(struct uart_reader *uart_reader_data);
+
+#endif
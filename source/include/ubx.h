@@ -0,0 +1,53 @@
+/**
+ * @file ubx.h
+ *
+ * @brief UBX related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef UBX_H_
+#define UBX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define UBX_SYNC_CHAR_1 0xB5
+#define UBX_SYNC_CHAR_2 0x62
+#define UBX_PAYLOAD_LENGTH_MAX 1024
+#define UBX_FRAME_LENGTH_MAX (UBX_PAYLOAD_LENGTH_MAX + 8)
+#define UBX_CLASS_MGA 0x13
+
+struct ubx_parser
+{
+    uint8_t frame[UBX_FRAME_LENGTH_MAX];
+    uint16_t length;
+    uint16_t frame_length;
+    uint32_t errors;
+};
+
+void ubx_checksum(const uint8_t *data, uint16_t length, uint8_t *checksum_a, uint8_t *checksum_b);
+bool ubx_parse(struct ubx_parser *ubx_parser_data, uint8_t data);
+void ubx_parser_init(struct ubx_parser *ubx_parser_data);
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file ubx_bridge.h
+ *
+ * @brief UBX bridge related functionality declaration.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+	 Subject to your compliance with these terms,you may use this software and
+	 any derivatives exclusively with Forstner Michael products.It is your responsibility
+	 to comply with third party license terms applicable to your use of third party
+	 software (including open source software) that may accompany Forstner Michael software.
+
+	 THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+	 EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+	 WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+	 PARTICULAR PURPOSE.
+
+	 IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+	 INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+	 WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+	 BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+	 FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+	 ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+	 THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#ifndef UBXBRIDGE_H_
+#define UBXBRIDGE_H_
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include "sd_card.h"
+
+#define UBX_BRIDGE_TRANSPORT_TCP 0
+#define UBX_BRIDGE_TRANSPORT_BLUETOOTH 1
+#define UBX_BRIDGE_BUFFER 16384
+#define UBX_BRIDGE_CHUNK 1024
+#define UBX_BRIDGE_TIMEOUT 30000
+
+struct ubx_bridge
+{
+    bool update;
+    bool active;
+    uint32_t rx_bytes_per_second;
+    uint32_t tx_bytes_per_second;
+    uint32_t drops;
+};
+
+bool ubx_bridge_active(void);
+bool ubx_bridge_bluetooth(void);
+void ubx_bridge_transfer(struct ubx_bridge *ubx_bridge_data);
+void ubx_bridge(void);
+bool ubx_bridge_reserve(void);
+bool ubx_bridge_init(struct ubx_bridge *ubx_bridge_data, struct sd_card_config2 *sd_card_config2_data);
+
+#endif
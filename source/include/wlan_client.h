@@ -30,6 +30,25 @@
 
 #include <Arduino.h>
 #include <M5Core2.h>
+#include "sd_card.h"
+
+#define WLAN_CLIENT_STATE_IDLE 0
+#define WLAN_CLIENT_STATE_CONNECTING 1
+#define WLAN_CLIENT_STATE_CONNECTED 2
+#define WLAN_CLIENT_STATE_WAITING 3
+#define WLAN_CLIENT_STATE_SCANNING 4
+#define WLAN_CLIENT_STATE_DISCONNECTING 5
+
+#define WLAN_CLIENT_PROFILES 3
+#define WLAN_CLIENT_NAMESPACE "wlan"
+#define WLAN_CLIENT_KEY_PROFILE "profile"
+
+#define WLAN_CLIENT_CONNECT_TIMEOUT 15000
+#define WLAN_CLIENT_FAST_CONNECT_TIMEOUT 5000
+#define WLAN_CLIENT_SCAN_TIMEOUT 10000
+#define WLAN_CLIENT_DISCONNECT_TIMEOUT 1000
+#define WLAN_CLIENT_RETRY_MIN 1000
+#define WLAN_CLIENT_RETRY_MAX 30000
 
 struct wlan_client
 {
@@ -37,7 +56,15 @@ struct wlan_client
     bool active;
 };
 
+struct wlan_client_cache
+{
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
 void wlan_client_transfer(struct wlan_client *wlan_client_data);
-bool wlan_client(struct sd_card_config2 *sd_card_config2_data);
+bool wlan_client(void);
+void wlan_client_init(struct sd_card_config2 *sd_card_config2_data);
 
 #endif
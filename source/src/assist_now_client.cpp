@@ -33,11 +33,24 @@
 #include "assist_now_client.h"
 #include "sd_card.h"
 #include "gnss.h"
+#include "ubx.h"
+#include "ubx_bridge.h"
+#include "bus.h"
+#include "ring_buffer.h"
 
-WiFiClient wifi_client;
-extern portMUX_TYPE subtask2_taskmux; 
+WiFiClient assist_now_client_wifi_client;
+portMUX_TYPE assist_now_client_taskmux = portMUX_INITIALIZER_UNLOCKED;
+struct ubx_parser assist_now_client_parser;
+uint8_t assist_now_client_buffer[ASSIST_NOW_CLIENT_BUFFER];
+struct ring_buffer assist_now_client_ring_buffer;
+uint8_t assist_now_client_ring[ASSIST_NOW_CLIENT_RING];
+bool assist_now_client_push_error = false;
+unsigned long assist_now_client_push_first = 0;
+uint16_t assist_now_client_messages = 0;
+uint32_t assist_now_client_first_message = 0;
+uint32_t assist_now_client_duration = 0;
+uint32_t assist_now_client_peak_heap = 0;
 extern SFE_UBLOX_GNSS_SERIAL gnss_serial;
-extern bool assist_now_client_active;
 
 /**
  * @brief Transfer data from the AssistNow client
@@ -47,24 +60,88 @@ void assist_now_client_transfer(struct assist_now_client *assist_now_client_data
 {
     unsigned long curr_millis = 0;
     static unsigned long last_millis = millis();
+    static struct bus_link bus_link_data;
+    static uint32_t version = 0;
  
     esp_task_wdt_reset();
-    curr_millis = millis();
-    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    if (bus_read(BUS_TOPIC_LINK, &bus_link_data, &version) == true)
     {
-        portENTER_CRITICAL(&subtask2_taskmux);
-        if (assist_now_client_data->active != assist_now_client_active)
+        if (assist_now_client_data->active != bus_link_data.assist_now_client_active)
         {
-            assist_now_client_data->active = assist_now_client_active;
+            assist_now_client_data->active = bus_link_data.assist_now_client_active;
             assist_now_client_data->update = true;
         }
-        portEXIT_CRITICAL(&subtask2_taskmux);
+    }
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&assist_now_client_taskmux);
+        assist_now_client_data->messages = assist_now_client_messages;
+        assist_now_client_data->first_message = assist_now_client_first_message;
+        assist_now_client_data->duration = assist_now_client_duration;
+        assist_now_client_data->peak_heap = assist_now_client_peak_heap;
+        portEXIT_CRITICAL(&assist_now_client_taskmux);
         last_millis = curr_millis;
     }
 }
 
 /**
- * @brief Communication from the AssistNow client
+ * @brief Push complete MGA messages with MGA-ACK flow control to the GNSS
+ * @param [in] data, length
+ * @return error
+ */
+bool assist_now_client_push(const uint8_t *data, uint16_t length)
+{
+    bool error = false;
+
+    esp_task_wdt_reset();
+    if (ubx_bridge_active() == true) error = true;
+    else if (length > 0)
+    {
+        if (gnss_serial.pushAssistNowData(data, (size_t)length, SFE_UBLOX_MGA_ASSIST_ACK_YES, ASSIST_NOW_CLIENT_ACK_TIMEOUT) != (size_t)length) error = true;
+    }
+
+    return error;
+}
+
+/**
+ * @brief Push the next downloaded MGA message to the GNSS (called in the network task, which owns the GNSS serial)
+ */
+void assist_now_client_inject(void)
+{
+    uint16_t length = 0;
+
+    esp_task_wdt_reset();
+    if (ring_buffer_used(&assist_now_client_ring_buffer) < 6) return;
+    ring_buffer_read(&assist_now_client_ring_buffer, assist_now_client_buffer, 6);
+    length = (uint16_t)(assist_now_client_buffer[4] | (assist_now_client_buffer[5] << 8)) + 2;
+    ring_buffer_read(&assist_now_client_ring_buffer, &assist_now_client_buffer[6], length);
+    if (assist_now_client_push(assist_now_client_buffer, length + 6) == true) __atomic_store_n(&assist_now_client_push_error, true, __ATOMIC_RELEASE);
+    else if (__atomic_load_n(&assist_now_client_push_first, __ATOMIC_ACQUIRE) == 0) __atomic_store_n(&assist_now_client_push_first, millis(), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Queue a downloaded MGA message for the network task
+ * @param [in] data, length
+ * @return error
+ */
+bool assist_now_client_queue(const uint8_t *data, uint16_t length)
+{
+    bool error = false;
+    unsigned long timeout = millis();
+
+    while ((ring_buffer_free(&assist_now_client_ring_buffer) < length) && (error == false))
+    {
+        if ((__atomic_load_n(&assist_now_client_push_error, __ATOMIC_ACQUIRE) == true) || ((unsigned long)(millis() - timeout) > 5000)) error = true;
+        else delay(1);
+    }
+    if (error == false) ring_buffer_write(&assist_now_client_ring_buffer, data, length);
+
+    return error;
+}
+
+/**
+ * @brief Download the AssistNow data and queue it for the network task (called in the connection task)
  * @param [in] sd_card_config2_data
  * @return error
  */
@@ -72,14 +149,22 @@ bool assist_now_client(struct sd_card_config2 *sd_card_config2_data)
 {
     bool error = false;
     uint16_t counter = 0;
+    int length = 0;
+    uint16_t messages = 0;
+    uint32_t heap_start = 0;
+    uint32_t heap_min = 0;
+    unsigned long start = millis();
     unsigned long timeout = millis();
     char data[512];
     char temp[128];
-    String payload;
 
     esp_task_wdt_reset();
+    __atomic_store_n(&assist_now_client_push_error, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&assist_now_client_push_first, 0, __ATOMIC_RELEASE);
+    heap_start = ESP.getFreeHeap();
+    heap_min = heap_start;
     sprintf(data, "%s", sd_card_config2_data->assist_now_server);
-    if (wifi_client.connect(data, 80) == true)
+    if (assist_now_client_wifi_client.connect(data, 80) == true)
     {
         snprintf(data, sizeof(data), "GET http://%s/GetOnlineData.ashx?token=%s;gnss=gps,qzss,glo,bds,gal;datatype=eph,alm,aux,pos; HTTP/1.0\r\n", sd_card_config2_data->assist_now_server, sd_card_config2_data->assist_now_token);
         snprintf(temp, sizeof(temp), "Host: %s", sd_card_config2_data->assist_now_server);
@@ -90,30 +175,35 @@ bool assist_now_client(struct sd_card_config2 *sd_card_config2_data)
         strncat(data, temp, sizeof(temp));
         snprintf(temp, sizeof(temp), "Connection: close\r\n");
         strncat(data, temp, sizeof(temp));
-        wifi_client.write(data, strlen(data));
-        wifi_client.print("\r\n");
-        if (wifi_client.connected() == true)
+        assist_now_client_wifi_client.write(data, strlen(data));
+        assist_now_client_wifi_client.print("\r\n");
+        if (assist_now_client_wifi_client.connected() == true)
         {
-             do
+            do
             {
                 if ((unsigned long)(millis() - timeout) > 5000) error = true;
-                else error = false;
+                else
+                {
+                    error = false;
+                    if (assist_now_client_wifi_client.available() == 0) delay(1);
+                }
             }
-            while ((wifi_client.available() == 0) && (error == false));
+            while ((assist_now_client_wifi_client.available() == 0) && (error == false));
             if (error == false)
             {
                 counter = 0;
-                while (wifi_client.available() > 0)
+                while (assist_now_client_wifi_client.available() > 0)
                 {
-                    data[counter] = (char)wifi_client.read();
+                    data[counter] = (char)assist_now_client_wifi_client.read();
                     counter = counter + 1;
+                    data[counter] = '\0';
                     if (strstr(data, "200") != nullptr)
                     {
                         error = false;
                         break;
                     }
                     else error = true;
-                    if (counter == sizeof(data))
+                    if (counter == (sizeof(data) - 1))
                     {
                         error = true;
                         break;
@@ -122,17 +212,18 @@ bool assist_now_client(struct sd_card_config2 *sd_card_config2_data)
                 if (error == false)
                 {
                     counter = 0;
-                    while (wifi_client.available() > 0)
+                    while (assist_now_client_wifi_client.available() > 0)
                     {
-                        data[counter] = (char)wifi_client.read();
+                        data[counter] = (char)assist_now_client_wifi_client.read();
                         counter = counter + 1;
+                        data[counter] = '\0';
                         if (strstr(data, "\r\n\r\n") != nullptr)
                         {
                             error = false;
                             break;
                         }
                         else error = true;
-                        if (counter == sizeof(data))
+                        if (counter == (sizeof(data) - 1))
                         {
                             error = true;
                             break;
@@ -140,13 +231,46 @@ bool assist_now_client(struct sd_card_config2 *sd_card_config2_data)
                     }
                     if (error == false)
                     {
-                        payload = wifi_client.readString();
-                        if (payload.length() > 0)
+                        ubx_parser_init(&assist_now_client_parser);
+                        timeout = millis();
+                        while ((error == false) && ((assist_now_client_wifi_client.connected() == true) || (assist_now_client_wifi_client.available() > 0)) && ((unsigned long)(millis() - timeout) < 5000))
                         {
-                            if ((unsigned int)gnss_serial.pushAssistNowData(payload, (size_t)payload.length()) == payload.length()) error = false;
-                            else error = true;
+                            esp_task_wdt_reset();
+                            length = 0;
+                            if (assist_now_client_wifi_client.available() > 0) length = assist_now_client_wifi_client.read((uint8_t *)data, sizeof(data));
+                            if (length > 0)
+                            {
+                                timeout = millis();
+                                for (counter = 0; counter < length; counter = counter + 1)
+                                {
+                                    if ((ubx_parse(&assist_now_client_parser, (uint8_t)data[counter]) == true) && (assist_now_client_parser.frame[2] == UBX_CLASS_MGA) && (assist_now_client_parser.frame_length <= sizeof(assist_now_client_buffer)))
+                                    {
+                                        if (error == false) error = assist_now_client_queue(assist_now_client_parser.frame, assist_now_client_parser.frame_length);
+                                        messages = messages + 1;
+                                    }
+                                }
+                                if (ESP.getFreeHeap() < heap_min) heap_min = ESP.getFreeHeap();
+                            }
+                            delay(1);                                                            //Give the lower priority tasks on this core time between the chunks
+                        }
+                        timeout = millis();
+                        while ((error == false) && (ring_buffer_used(&assist_now_client_ring_buffer) > 0))
+                        {
+                            if ((unsigned long)(millis() - timeout) > 5000) error = true;
+                            else delay(1);
+                        }
+                        if (__atomic_load_n(&assist_now_client_push_error, __ATOMIC_ACQUIRE) == true) error = true;
+                        if (messages == 0) error = true;
+                        if (error == false)
+                        {
+                            portENTER_CRITICAL(&assist_now_client_taskmux);
+                            assist_now_client_messages = messages;
+                            assist_now_client_first_message = (uint32_t)(__atomic_load_n(&assist_now_client_push_first, __ATOMIC_ACQUIRE) - start);
+                            assist_now_client_duration = (uint32_t)(millis() - start);
+                            assist_now_client_peak_heap = heap_start - heap_min;
+                            portEXIT_CRITICAL(&assist_now_client_taskmux);
+                            Serial.printf("%u messages, first after %lu ms, done after %lu ms, peak heap %lu bytes... ", messages, (unsigned long)assist_now_client_first_message, (unsigned long)assist_now_client_duration, (unsigned long)assist_now_client_peak_heap);
                         }
-                        else error = true;
                     }
                 }
             }
@@ -154,7 +278,22 @@ bool assist_now_client(struct sd_card_config2 *sd_card_config2_data)
         else error = true;
     }
     else error = true;
-    wifi_client.stop();
+    assist_now_client_wifi_client.stop();
     
     return error;
 }
+
+/**
+ * @brief Initialize the AssistNow client
+ * @param [in] assist_now_client_data
+ */
+void assist_now_client_init(struct assist_now_client *assist_now_client_data)
+{
+    esp_task_wdt_reset();
+    ring_buffer_init(&assist_now_client_ring_buffer, assist_now_client_ring, sizeof(assist_now_client_ring));
+    assist_now_client_data->active = false;
+    assist_now_client_data->messages = 0;
+    assist_now_client_data->first_message = 0;
+    assist_now_client_data->duration = 0;
+    assist_now_client_data->peak_heap = 0;
+}
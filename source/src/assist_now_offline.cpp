@@ -0,0 +1,233 @@
+/**
+ * @file assist_now_offline.cpp
+ *
+ * @brief AssistNow Offline related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <WiFiClient.h>
+#include <time.h>
+#include "assist_now_offline.h"
+#include "assist_now_client.h"
+#include "sd_card.h"
+#include "ubx.h"
+
+struct ubx_parser assist_now_offline_parser;
+uint8_t assist_now_offline_buffer[ASSIST_NOW_CLIENT_BUFFER];
+uint16_t assist_now_offline_messages = 0;
+
+/**
+ * @brief Read the metadata of the AssistNow Offline cache
+ * @param [out] download, period
+ * @return error
+ */
+bool assist_now_offline_meta(unsigned long *download, unsigned int *period)
+{
+    bool error = true;
+    char string[64];
+    size_t length = 0;
+    File datafile;
+
+    esp_task_wdt_reset();
+    datafile = SD.open(ASSIST_NOW_OFFLINE_META, FILE_READ);
+    if (datafile)
+    {
+        length = datafile.readBytesUntil('\0', string, sizeof(string) - 1);
+        string[length] = '\0';
+        datafile.close();
+        if (sscanf(string, "%lu %u", download, period) == 2) error = false;
+    }
+
+    return error;
+}
+
+/**
+ * @brief Inject the MGA-ANO messages of the current day from the cache into the GNSS
+ * @return error
+ */
+bool assist_now_offline_inject(void)
+{
+    bool error = false;
+    uint8_t data[256];
+    unsigned long download = 0;
+    unsigned int period = 0;
+    int length = 0;
+    int counter = 0;
+    uint16_t buffer_length = 0;
+    time_t timestamp = (time_t)0;
+    struct tm timestamp_data;
+    File datafile;
+
+    esp_task_wdt_reset();
+    assist_now_offline_messages = 0;
+    time(&timestamp);
+    gmtime_r(&timestamp, &timestamp_data);
+    if (assist_now_offline_meta(&download, &period) == true) return true;
+    if (((unsigned long)timestamp < download) || ((unsigned long)timestamp >= (download + (unsigned long)period * 604800UL))) return true;
+    datafile = SD.open(ASSIST_NOW_OFFLINE_FILE, FILE_READ);
+    if (datafile)
+    {
+        ubx_parser_init(&assist_now_offline_parser);
+        do
+        {
+            esp_task_wdt_reset();
+            length = datafile.read(data, sizeof(data));
+            for (counter = 0; counter < length; counter = counter + 1)
+            {
+                if ((ubx_parse(&assist_now_offline_parser, data[counter]) == true) &&
+                    (assist_now_offline_parser.frame[2] == UBX_CLASS_MGA) &&
+                    (assist_now_offline_parser.frame[3] == ASSIST_NOW_OFFLINE_ID_ANO) &&
+                    (assist_now_offline_parser.frame_length <= sizeof(assist_now_offline_buffer)) &&
+                    (assist_now_offline_parser.frame[10] == (uint8_t)(timestamp_data.tm_year - 100)) &&
+                    (assist_now_offline_parser.frame[11] == (uint8_t)(timestamp_data.tm_mon + 1)) &&
+                    (assist_now_offline_parser.frame[12] == (uint8_t)timestamp_data.tm_mday))
+                {
+                    if ((buffer_length + assist_now_offline_parser.frame_length) > sizeof(assist_now_offline_buffer))
+                    {
+                        if (error == false) error = assist_now_client_push(assist_now_offline_buffer, buffer_length);
+                        buffer_length = 0;
+                    }
+                    memcpy(&assist_now_offline_buffer[buffer_length], assist_now_offline_parser.frame, assist_now_offline_parser.frame_length);
+                    buffer_length = buffer_length + assist_now_offline_parser.frame_length;
+                    assist_now_offline_messages = assist_now_offline_messages + 1;
+                }
+            }
+        }
+        while (length > 0);
+        datafile.close();
+        if (error == false) error = assist_now_client_push(assist_now_offline_buffer, buffer_length);
+        if (assist_now_offline_messages == 0) error = true;
+    }
+    else error = true;
+
+    return error;
+}
+
+/**
+ * @brief Download the AssistNow Offline data into the cache if it is missing or outdated
+ * @param [in] sd_card_config2_data
+ * @return error
+ */
+bool assist_now_offline(struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+    uint16_t counter = 0;
+    int length = 0;
+    uint32_t messages = 0;
+    unsigned long download = 0;
+    unsigned int period = 0;
+    unsigned long timeout = 0;
+    time_t timestamp = (time_t)0;
+    char data[512];
+    File datafile;
+    WiFiClient wifi_client;
+
+    esp_task_wdt_reset();
+    time(&timestamp);
+    if (assist_now_offline_meta(&download, &period) == false)
+    {
+        if (((unsigned long)timestamp >= download) && ((unsigned long)(timestamp - download) < ASSIST_NOW_OFFLINE_REFRESH)) return false;
+    }
+    if (wifi_client.connect(sd_card_config2_data->assist_now_offline_server, 80) == true)
+    {
+        snprintf(data, sizeof(data), "GET /GetOfflineData.ashx?token=%s;gnss=gps,gal,bds,glo;format=mga;period=%u;resolution=1 HTTP/1.0\r\nHost: %s\r\nUser-Agent: M5Stack Core2\r\nAccept: */*\r\nConnection: close\r\n\r\n",
+                 sd_card_config2_data->assist_now_token, sd_card_config2_data->assist_now_offline_period, sd_card_config2_data->assist_now_offline_server);
+        wifi_client.write(data, strlen(data));
+        counter = 0;
+        error = true;
+        timeout = millis();
+        while (((wifi_client.connected() == true) || (wifi_client.available() > 0)) && ((unsigned long)(millis() - timeout) < 5000) && (counter < (sizeof(data) - 1)))
+        {
+            if (wifi_client.available() > 0)
+            {
+                data[counter] = (char)wifi_client.read();
+                counter = counter + 1;
+                data[counter] = '\0';
+                if (strstr(data, "\r\n\r\n") != nullptr)
+                {
+                    if (strstr(data, " 200") != nullptr) error = false;
+                    break;
+                }
+            }
+            else delay(1);
+        }
+        if (error == false)
+        {
+            datafile = SD.open(ASSIST_NOW_OFFLINE_TEMP, FILE_WRITE);
+            if (datafile)
+            {
+                ubx_parser_init(&assist_now_offline_parser);
+                timeout = millis();
+                while (((wifi_client.connected() == true) || (wifi_client.available() > 0)) && ((unsigned long)(millis() - timeout) < 5000))
+                {
+                    esp_task_wdt_reset();
+                    length = 0;
+                    if (wifi_client.available() > 0) length = wifi_client.read((uint8_t *)data, sizeof(data));
+                    if (length > 0)
+                    {
+                        timeout = millis();
+                        for (counter = 0; counter < length; counter = counter + 1)
+                        {
+                            if ((ubx_parse(&assist_now_offline_parser, (uint8_t)data[counter]) == true) &&
+                                (assist_now_offline_parser.frame[2] == UBX_CLASS_MGA) &&
+                                (assist_now_offline_parser.frame[3] == ASSIST_NOW_OFFLINE_ID_ANO))
+                            {
+                                if (datafile.write(assist_now_offline_parser.frame, assist_now_offline_parser.frame_length) != assist_now_offline_parser.frame_length) error = true;
+                                messages = messages + 1;
+                            }
+                        }
+                    }
+                    delay(1);                                                                    //Give the lower priority tasks on this core time between the chunks
+                }
+                datafile.close();
+                if (messages == 0) error = true;
+                if (error == false)
+                {
+                    SD.remove(ASSIST_NOW_OFFLINE_FILE);
+                    error = !SD.rename(ASSIST_NOW_OFFLINE_TEMP, ASSIST_NOW_OFFLINE_FILE);
+                }
+                else SD.remove(ASSIST_NOW_OFFLINE_TEMP);
+                if (error == false)
+                {
+                    datafile = SD.open(ASSIST_NOW_OFFLINE_META, FILE_WRITE);
+                    if (datafile)
+                    {
+                        datafile.printf("%lu %u\n", (unsigned long)timestamp, sd_card_config2_data->assist_now_offline_period);
+                        datafile.close();
+                        Serial.printf("%lu MGA-ANO messages... ", (unsigned long)messages);
+                    }
+                    else error = true;
+                }
+            }
+            else error = true;
+        }
+    }
+    else error = true;
+    wifi_client.stop();
+
+    return error;
+}
@@ -0,0 +1,342 @@
+/**
+ * @file base_station.cpp
+ *
+ * @brief Base station related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <SparkFun_u-blox_GNSS_v3.h>
+#include <WiFiClient.h>
+#include <mbedtls/base64.h>
+#include <lwip/sockets.h>
+#include "base_station.h"
+#include "sd_card.h"
+#include "rtcm.h"
+#include "ring_buffer.h"
+#include "ntrip_caster.h"
+#include "bus.h"
+
+class base_station_output : public Print
+{
+    public:
+    size_t write(uint8_t data);
+};
+
+portMUX_TYPE base_station_taskmux = portMUX_INITIALIZER_UNLOCKED;
+WiFiClient base_station_wifi_client;
+base_station_output base_station_rtcm_output;
+struct rtcm_parser base_station_rtcm_parser;
+struct ring_buffer base_station_ring_buffer;
+uint8_t base_station_buffer[BASE_STATION_BUFFER];
+uint8_t base_station_mode = BASE_STATION_MODE_OFF;
+uint32_t base_station_bytes = 0;
+uint32_t base_station_frames = 0;
+unsigned long base_station_timestamp = 0;
+const uint32_t base_station_rtcm_keys[6] = {UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1005_UART1, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1074_UART1, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1084_UART1, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1094_UART1, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1124_UART1, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1230_UART1};
+const uint8_t base_station_rtcm_rates[6] = {10, 1, 1, 1, 1, 10};
+extern SFE_UBLOX_GNSS gnss_i2c;
+extern SFE_UBLOX_GNSS_SERIAL gnss_serial;
+
+/**
+ * @brief Collect the RTCM output of the GNSS into complete frames
+ * @param [in] data
+ * @return length
+ */
+size_t base_station_output::write(uint8_t data)
+{
+    if (rtcm_parse(&base_station_rtcm_parser, data) == true)
+    {
+        ntrip_caster_push(base_station_rtcm_parser.frame, base_station_rtcm_parser.frame_length);
+        ring_buffer_write(&base_station_ring_buffer, base_station_rtcm_parser.frame, base_station_rtcm_parser.frame_length);
+
+        portENTER_CRITICAL(&base_station_taskmux);
+        base_station_frames = base_station_frames + 1;
+        portEXIT_CRITICAL(&base_station_taskmux);
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Transfer data from the base station
+ * @param [in] base_station_data
+ */
+void base_station_transfer(struct base_station *base_station_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static uint32_t last_bytes = 0;
+    static struct bus_survey bus_survey_data;
+    static uint32_t survey_version = 0;
+    static struct bus_link bus_link_data;
+    static uint32_t link_version = 0;
+
+    esp_task_wdt_reset();
+    if (bus_read(BUS_TOPIC_SURVEY, &bus_survey_data, &survey_version) == true)
+    {
+        base_station_data->survey_in_active = bus_survey_data.survey_in_active;
+        base_station_data->survey_in_valid = bus_survey_data.survey_in_valid;
+        base_station_data->survey_in_duration = bus_survey_data.survey_in_duration;
+        base_station_data->survey_in_accuracy = bus_survey_data.survey_in_accuracy;
+        base_station_data->update = true;
+    }
+    if (bus_read(BUS_TOPIC_LINK, &bus_link_data, &link_version) == true)
+    {
+        if (base_station_data->server_active != bus_link_data.base_station_server_active)
+        {
+            base_station_data->server_active = bus_link_data.base_station_server_active;
+            base_station_data->update = true;
+        }
+    }
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&base_station_taskmux);
+        base_station_data->bytes_per_second = (uint32_t)((uint64_t)(base_station_bytes - last_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        last_bytes = base_station_bytes;
+        base_station_data->frames = base_station_frames;
+        base_station_data->drops = base_station_ring_buffer.drops;
+        portEXIT_CRITICAL(&base_station_taskmux);
+        base_station_data->update = true;
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Poll the survey-in status of the GNSS and publish it on the data bus
+ */
+void base_station_survey(void)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    struct bus_survey bus_survey_data;
+
+    esp_task_wdt_reset();
+    if (base_station_mode != BASE_STATION_MODE_SURVEY_IN) return;
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        if (gnss_i2c.getSurveyStatus() == true)
+        {
+            bus_survey_data.survey_in_active = (gnss_i2c.packetUBXNAVSVIN->data.active != 0);
+            bus_survey_data.survey_in_valid = (gnss_i2c.packetUBXNAVSVIN->data.valid != 0);
+            bus_survey_data.survey_in_duration = gnss_i2c.packetUBXNAVSVIN->data.dur;
+            bus_survey_data.survey_in_accuracy = (float)gnss_i2c.packetUBXNAVSVIN->data.meanAcc * 1E-4f;
+            bus_publish(BUS_TOPIC_SURVEY, &bus_survey_data);
+        }
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Read the RTCM output of the GNSS
+ */
+void base_station(void)
+{
+    esp_task_wdt_reset();
+    if (base_station_mode == BASE_STATION_MODE_OFF) return;
+    gnss_serial.checkUblox();
+}
+
+/**
+ * @brief Communication to the NTRIP server
+ * @return error
+ */
+bool base_station_server(void)
+{
+    bool error = false;
+    uint32_t length = 0;
+    ssize_t sent = 0;
+    const uint8_t *data = nullptr;
+
+    esp_task_wdt_reset();
+    if (base_station_wifi_client.connected() == true)
+    {
+        length = ring_buffer_peek(&base_station_ring_buffer, &data);
+        if (length > 0)
+        {
+            sent = send(base_station_wifi_client.fd(), data, length, MSG_DONTWAIT);
+            if (sent > 0)
+            {
+                ring_buffer_consume(&base_station_ring_buffer, (uint32_t)sent);
+                base_station_timestamp = millis();
+
+                portENTER_CRITICAL(&base_station_taskmux);
+                base_station_bytes = base_station_bytes + (uint32_t)sent;
+                portEXIT_CRITICAL(&base_station_taskmux);
+            }
+            else if ((sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) error = true;
+            else if ((unsigned long)(millis() - base_station_timestamp) > BASE_STATION_TIMEOUT) error = true;
+        }
+        else base_station_timestamp = millis();
+    }
+    else error = true;
+    if (error == true)
+    {
+        if (base_station_wifi_client.connected() == true) base_station_wifi_client.stop();
+    }
+
+    return error;
+}
+
+/**
+ * @brief Initialize the connection to the NTRIP server
+ * @param [in] sd_card_config2_data
+ * @return error
+ */
+bool base_station_server_init(struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+    uint16_t counter = 0;
+    unsigned long timeout = 0;
+    char data[768];
+    char user_credentials[sizeof(sd_card_config2_data->base_user) + sizeof(sd_card_config2_data->base_password) + 1];
+    unsigned char encoded_credentials[((sizeof(user_credentials) + 2) / 3) * 4 + 1];
+    size_t encoded_length = 0;
+
+    esp_task_wdt_reset();
+    if (base_station_wifi_client.connect(sd_card_config2_data->base_server, sd_card_config2_data->base_port) == true)
+    {
+        if (sd_card_config2_data->base_version == 2)
+        {
+            snprintf(user_credentials, sizeof(user_credentials), "%s:%s", sd_card_config2_data->base_user, sd_card_config2_data->base_password);
+            mbedtls_base64_encode(encoded_credentials, sizeof(encoded_credentials), &encoded_length, (const unsigned char *)user_credentials, strlen(user_credentials));
+            encoded_credentials[encoded_length] = '\0';
+            snprintf(data, sizeof(data), "POST /%s HTTP/1.1\r\nHost: %s\r\nNtrip-Version: Ntrip/2.0\r\nUser-Agent: NTRIP M5Stack Core2\r\nAuthorization: Basic %s\r\nContent-Type: gnss/data\r\nConnection: close\r\n\r\n",
+                     sd_card_config2_data->base_mount_point, sd_card_config2_data->base_server, (char *)encoded_credentials);
+        }
+        else snprintf(data, sizeof(data), "SOURCE %s /%s\r\nSource-Agent: NTRIP M5Stack Core2\r\n\r\n", sd_card_config2_data->base_password, sd_card_config2_data->base_mount_point);
+        base_station_wifi_client.write(data, strlen(data));
+        timeout = millis();
+        do
+        {
+            if ((unsigned long)(millis() - timeout) > 5000) error = true;
+            else
+            {
+                error = false;
+                if (base_station_wifi_client.available() == 0) delay(1);
+            }
+        }
+        while ((base_station_wifi_client.available() == 0) && (error == false));
+        if (error == false)
+        {
+            error = true;
+            counter = 0;
+            while ((base_station_wifi_client.available() > 0) && (counter < (sizeof(data) - 1)))
+            {
+                data[counter] = (char)base_station_wifi_client.read();
+                counter = counter + 1;
+                data[counter] = '\0';
+                if (strstr(data, "200 OK\r\n") != nullptr)
+                {
+                    error = false;
+                    break;
+                }
+            }
+        }
+    }
+    else error = true;
+    if (error == true)
+    {
+        if (base_station_wifi_client.connected() == true) base_station_wifi_client.stop();
+    }
+    else
+    {
+        base_station_wifi_client.setNoDelay(true);
+        ring_buffer_clear(&base_station_ring_buffer);
+        base_station_timestamp = millis();
+    }
+
+    return error;
+}
+
+/**
+ * @brief Initialize the base station
+ * @param [in] base_station_data, sd_card_config2_data
+ * @return error
+ */
+bool base_station_init(struct base_station *base_station_data, struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+    uint8_t counter = 0;
+    int64_t position[3];
+
+    esp_task_wdt_reset();
+    base_station_mode = sd_card_config2_data->base_mode;
+    rtcm_parser_init(&base_station_rtcm_parser);
+    ring_buffer_init(&base_station_ring_buffer, base_station_buffer, sizeof(base_station_buffer));
+    if (base_station_mode == BASE_STATION_MODE_OFF)
+    {
+        error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_MODE, 0);
+        for (counter = 0; counter < 6; counter = counter + 1)
+        {
+            if (error == false) error = !gnss_i2c.setVal8(base_station_rtcm_keys[counter], 0);
+        }
+    }
+    else
+    {
+        error = !gnss_i2c.setUART1Output(COM_TYPE_UBX | COM_TYPE_NMEA | COM_TYPE_RTCM3);
+        for (counter = 0; counter < 6; counter = counter + 1)
+        {
+            if (error == false) error = !gnss_i2c.setVal8(base_station_rtcm_keys[counter], base_station_rtcm_rates[counter]);
+        }
+        if (base_station_mode == BASE_STATION_MODE_SURVEY_IN)
+        {
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_MODE, 0);                                                                        //Restart a running survey-in
+            if (error == false) error = !gnss_i2c.setVal32(UBLOX_CFG_TMODE_SVIN_MIN_DUR, sd_card_config2_data->base_survey_in_duration);                 //Minimum duration in s
+            if (error == false) error = !gnss_i2c.setVal32(UBLOX_CFG_TMODE_SVIN_ACC_LIMIT, (uint32_t)(sd_card_config2_data->base_survey_in_accuracy * 1E4f)); //Accuracy limit in 0.1 mm
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_MODE, 1);
+        }
+        else
+        {
+            position[0] = llround(sd_card_config2_data->base_ecef_x * 1E4);                                                                                 //Position in 0.1 mm
+            position[1] = llround(sd_card_config2_data->base_ecef_y * 1E4);
+            position[2] = llround(sd_card_config2_data->base_ecef_z * 1E4);
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_POS_TYPE, 0);                                                                    //ECEF
+            if (error == false) error = !gnss_i2c.setVal32(UBLOX_CFG_TMODE_ECEF_X, (uint32_t)(int32_t)(position[0] / 100));
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_ECEF_X_HP, (uint8_t)(int8_t)(position[0] % 100));
+            if (error == false) error = !gnss_i2c.setVal32(UBLOX_CFG_TMODE_ECEF_Y, (uint32_t)(int32_t)(position[1] / 100));
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_ECEF_Y_HP, (uint8_t)(int8_t)(position[1] % 100));
+            if (error == false) error = !gnss_i2c.setVal32(UBLOX_CFG_TMODE_ECEF_Z, (uint32_t)(int32_t)(position[2] / 100));
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_ECEF_Z_HP, (uint8_t)(int8_t)(position[2] % 100));
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_TMODE_MODE, 2);
+        }
+        gnss_serial.setRTCMOutputPort(base_station_rtcm_output);
+    }
+    base_station_data->mode = base_station_mode;
+    base_station_data->survey_in_active = false;
+    base_station_data->survey_in_valid = false;
+    base_station_data->survey_in_duration = 0;
+    base_station_data->survey_in_accuracy = 0.0f;
+    base_station_data->server_active = false;
+    base_station_data->bytes_per_second = 0;
+    base_station_data->frames = 0;
+    base_station_data->drops = 0;
+    base_station_data->update = true;
+
+    return error;
+}
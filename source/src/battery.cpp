@@ -45,6 +45,7 @@ void battery_transfer(struct battery *battery_data)
     {
         battery_data->level = M5.Axp.GetBatteryLevel();
         battery_data->charging = M5.Axp.isCharging();
+        battery_data->current = M5.Axp.GetBatCurrent();
         battery_data->update = true;
         last_millis = curr_millis;
     }
@@ -60,5 +61,6 @@ void battery_init(struct battery *battery_data)
     M5.Axp.SetCHGCurrent(10);                           //960mA
     battery_data->level = M5.Axp.GetBatteryLevel();
     battery_data->charging = M5.Axp.isCharging();
+    battery_data->current = M5.Axp.GetBatCurrent();
     battery_data->update = true;
 }
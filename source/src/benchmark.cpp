@@ -0,0 +1,184 @@
+/**
+ * @file benchmark.cpp
+ *
+ * @brief Benchmark related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <SparkFun_u-blox_GNSS_v3.h>
+#include <time.h>
+#include "benchmark.h"
+#include "sd_card.h"
+#include "bus.h"
+
+portMUX_TYPE benchmark_taskmux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t benchmark_enable = 0;
+uint8_t benchmark_start = BENCHMARK_START_NORMAL;
+uint32_t benchmark_timeout = 0;
+uint8_t benchmark_restart = 0;
+bool benchmark_done = false;
+uint32_t benchmark_milestones[BENCHMARK_MILESTONES];
+const char *benchmark_start_text[4] = {"normal", "hot", "warm", "cold"};
+extern SFE_UBLOX_GNSS gnss_i2c;
+
+/**
+ * @brief Timestamp the first occurrence of a milestone since boot
+ * @param [in] milestone
+ */
+void benchmark_milestone(uint8_t milestone)
+{
+    uint32_t timestamp = millis();
+
+    if (milestone >= BENCHMARK_MILESTONES) return;
+    portENTER_CRITICAL(&benchmark_taskmux);
+    if (benchmark_milestones[milestone] == UINT32_MAX)
+    {
+        benchmark_milestones[milestone] = timestamp;
+    }
+    portEXIT_CRITICAL(&benchmark_taskmux);
+}
+
+/**
+ * @brief Append the milestones of this run to the benchmark file on the SD
+ * @return error
+ */
+bool benchmark_save(void)
+{
+    bool error = false;
+    bool header = false;
+    uint8_t counter = 0;
+    uint32_t milestones[BENCHMARK_MILESTONES];
+    File datafile;
+
+    esp_task_wdt_reset();
+    portENTER_CRITICAL(&benchmark_taskmux);
+    for (counter = 0; counter < BENCHMARK_MILESTONES; counter = counter + 1) milestones[counter] = benchmark_milestones[counter];
+    portEXIT_CRITICAL(&benchmark_taskmux);
+    header = !SD.exists(BENCHMARK_FILE);
+    datafile = SD.open(BENCHMARK_FILE, FILE_APPEND);
+    if (datafile)
+    {
+        if (header == true) datafile.print("timestamp,start,receiver_up_ms,fix_ok_ms,dgnss_ms,float_ms,fixed_ms\n");
+        datafile.printf("%lu,%s", (unsigned long)time(NULL), benchmark_start_text[benchmark_start]);
+        for (counter = 0; counter < BENCHMARK_MILESTONES; counter = counter + 1)
+        {
+            if (milestones[counter] == UINT32_MAX) datafile.print(",");
+            else datafile.printf(",%lu", (unsigned long)milestones[counter]);
+        }
+        datafile.print("\n");
+        datafile.close();
+    }
+    else error = true;
+    Serial.printf("Save benchmark (%s start, fix %ld ms, fixed %ld ms)... %s\n", benchmark_start_text[benchmark_start], (milestones[BENCHMARK_FIX_OK] == UINT32_MAX) ? -1L : (long)milestones[BENCHMARK_FIX_OK], (milestones[BENCHMARK_FIXED] == UINT32_MAX) ? -1L : (long)milestones[BENCHMARK_FIXED], (error == true) ? "failed" : "ok");
+
+    return error;
+}
+
+/**
+ * @brief Track the milestones of the GNSS and finish the run
+ */
+void benchmark(void)
+{
+    bool fix_ok = false;
+    bool dgnss = false;
+    uint8_t carrier = 0;
+    struct bus_gnss bus_gnss_data;
+    uint32_t version = 0;
+
+    esp_task_wdt_reset();
+    if ((benchmark_enable == 0) || (benchmark_done == true)) return;
+    bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version);
+    fix_ok = bus_gnss_data.gnss_fix_ok;
+    dgnss = bus_gnss_data.diff_soln;
+    carrier = bus_gnss_data.carr_soln;
+    if (fix_ok == true) benchmark_milestone(BENCHMARK_FIX_OK);
+    if ((fix_ok == true) && (dgnss == true)) benchmark_milestone(BENCHMARK_DGNSS);
+    if ((fix_ok == true) && (carrier >= 1)) benchmark_milestone(BENCHMARK_FLOAT);
+    if ((fix_ok == true) && (carrier == 2)) benchmark_milestone(BENCHMARK_FIXED);
+    if ((carrier == 2) || (millis() > benchmark_timeout))
+    {
+        benchmark_save();
+        benchmark_done = true;
+        if (benchmark_restart == 1)
+        {
+            Serial.print(F("Restart for the next benchmark run... ok\n"));
+            Serial.flush();
+            ESP.restart();
+        }
+    }
+}
+
+/**
+ * @brief Reset the GNSS for a hot, warm or cold start benchmark
+ * @return error
+ */
+bool benchmark_reset(void)
+{
+    bool error = false;
+    uint8_t data[4];
+
+    esp_task_wdt_reset();
+    if ((benchmark_enable == 0) || (benchmark_start == BENCHMARK_START_NORMAL)) return false;
+    if (benchmark_start == BENCHMARK_START_COLD)
+    {
+        data[0] = 0xFF;                                                 //Clear all navigation data
+        data[1] = 0xFF;
+    }
+    else if (benchmark_start == BENCHMARK_START_WARM)
+    {
+        data[0] = 0x01;                                                 //Clear the ephemeris
+        data[1] = 0x00;
+    }
+    else
+    {
+        data[0] = 0x00;                                                 //Keep all navigation data
+        data[1] = 0x00;
+    }
+    data[2] = 0x02;                                                     //Controlled software reset of the GNSS only
+    data[3] = 0x00;
+    error = !gnss_i2c.cfgRST(data, sizeof(data));
+    delay(500);
+
+    return error;
+}
+
+/**
+ * @brief Initialize the benchmark
+ * @param [in] sd_card_config2_data
+ */
+void benchmark_init(struct sd_card_config2 *sd_card_config2_data)
+{
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    benchmark_enable = sd_card_config2_data->benchmark_enable;
+    benchmark_start = sd_card_config2_data->benchmark_start;
+    benchmark_timeout = (uint32_t)sd_card_config2_data->benchmark_timeout * 1000;
+    benchmark_restart = sd_card_config2_data->benchmark_restart;
+    benchmark_done = false;
+    for (counter = 0; counter < BENCHMARK_MILESTONES; counter = counter + 1) benchmark_milestones[counter] = UINT32_MAX;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file ble_packet.cpp
+ *
+ * @brief BLE packet related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "ble_packet.h"
+#include "ubx.h"
+
+/*
+ * The packetizer fills notifications up to the negotiated ATT MTU minus the
+ * 3 byte ATT header, so an epoch is sent with as few notifications as
+ * possible. The compact fix frame is sync (2), version (1), length (1),
+ * little endian payload and the UBX Fletcher checksum over version, length
+ * and payload.
+ */
+
+/**
+ * @brief Store a 32 bit value little endian
+ * @param [in] value
+ * @param [out] data
+ */
+static void ble_packet_put32(uint8_t *data, uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Load a 32 bit value little endian
+ * @param [in] data
+ * @return value
+ */
+static uint32_t ble_packet_get32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/**
+ * @brief Encode a compact fix frame
+ * @param [in] ble_packet_fix_data
+ * @param [out] frame (BLE_PACKET_FIX_FRAME_LENGTH bytes)
+ * @return length of the frame
+ */
+uint16_t ble_packet_fix_encode(const struct ble_packet_fix *ble_packet_fix_data, uint8_t *frame)
+{
+    uint8_t *payload = &frame[4];
+
+    frame[0] = BLE_PACKET_FIX_SYNC_CHAR_1;
+    frame[1] = BLE_PACKET_FIX_SYNC_CHAR_2;
+    frame[2] = BLE_PACKET_FIX_VERSION;
+    frame[3] = BLE_PACKET_FIX_LENGTH;
+    ble_packet_put32(&payload[0], ble_packet_fix_data->timestamp);
+    ble_packet_put32(&payload[4], (uint32_t)ble_packet_fix_data->lat);
+    ble_packet_put32(&payload[8], (uint32_t)ble_packet_fix_data->lon);
+    payload[12] = (uint8_t)ble_packet_fix_data->lat_hp;
+    payload[13] = (uint8_t)ble_packet_fix_data->lon_hp;
+    ble_packet_put32(&payload[14], (uint32_t)ble_packet_fix_data->height);
+    ble_packet_put32(&payload[18], ble_packet_fix_data->acc);
+    payload[22] = ble_packet_fix_data->fix_type;
+    payload[23] = ble_packet_fix_data->carr_soln;
+    payload[24] = ble_packet_fix_data->num_sv;
+    payload[25] = ble_packet_fix_data->flags;
+    ubx_checksum(&frame[2], BLE_PACKET_FIX_LENGTH + 2, &frame[BLE_PACKET_FIX_LENGTH + 4], &frame[BLE_PACKET_FIX_LENGTH + 5]);
+
+    return BLE_PACKET_FIX_FRAME_LENGTH;
+}
+
+/**
+ * @brief Decode a compact fix frame
+ * @param [in] frame, length
+ * @param [out] ble_packet_fix_data
+ * @return error
+ */
+bool ble_packet_fix_decode(const uint8_t *frame, uint16_t length, struct ble_packet_fix *ble_packet_fix_data)
+{
+    const uint8_t *payload = &frame[4];
+    uint8_t checksum_a = 0;
+    uint8_t checksum_b = 0;
+
+    if (length < BLE_PACKET_FIX_FRAME_LENGTH) return true;
+    if ((frame[0] != BLE_PACKET_FIX_SYNC_CHAR_1) || (frame[1] != BLE_PACKET_FIX_SYNC_CHAR_2)) return true;
+    if ((frame[2] != BLE_PACKET_FIX_VERSION) || (frame[3] != BLE_PACKET_FIX_LENGTH)) return true;
+    ubx_checksum(&frame[2], BLE_PACKET_FIX_LENGTH + 2, &checksum_a, &checksum_b);
+    if ((checksum_a != frame[BLE_PACKET_FIX_LENGTH + 4]) || (checksum_b != frame[BLE_PACKET_FIX_LENGTH + 5])) return true;
+    ble_packet_fix_data->timestamp = ble_packet_get32(&payload[0]);
+    ble_packet_fix_data->lat = (int32_t)ble_packet_get32(&payload[4]);
+    ble_packet_fix_data->lon = (int32_t)ble_packet_get32(&payload[8]);
+    ble_packet_fix_data->lat_hp = (int8_t)payload[12];
+    ble_packet_fix_data->lon_hp = (int8_t)payload[13];
+    ble_packet_fix_data->height = (int32_t)ble_packet_get32(&payload[14]);
+    ble_packet_fix_data->acc = ble_packet_get32(&payload[18]);
+    ble_packet_fix_data->fix_type = payload[22];
+    ble_packet_fix_data->carr_soln = payload[23];
+    ble_packet_fix_data->num_sv = payload[24];
+    ble_packet_fix_data->flags = payload[25];
+
+    return false;
+}
+
+/**
+ * @brief Send one notification and count it
+ * @param [in,out] ble_packetizer_data
+ * @param [in] data, length, send
+ */
+static void ble_packet_send_count(struct ble_packetizer *ble_packetizer_data, const uint8_t *data, uint16_t length, ble_packet_send send)
+{
+    send(data, length);
+    ble_packetizer_data->packets = ble_packetizer_data->packets + 1;
+    ble_packetizer_data->bytes = ble_packetizer_data->bytes + length;
+}
+
+/**
+ * @brief Append data and send every full notification
+ * @param [in,out] ble_packetizer_data
+ * @param [in] data, length, send
+ */
+void ble_packet_write(struct ble_packetizer *ble_packetizer_data, const uint8_t *data, uint16_t length, ble_packet_send send)
+{
+    uint16_t part = 0;
+
+    while (length > 0)
+    {
+        if ((ble_packetizer_data->length == 0) && (length >= ble_packetizer_data->payload))
+        {
+            part = ble_packetizer_data->payload;
+            ble_packet_send_count(ble_packetizer_data, data, part, send);
+        }
+        else
+        {
+            part = ble_packetizer_data->payload - ble_packetizer_data->length;
+            if (part > length) part = length;
+            memcpy(&ble_packetizer_data->buffer[ble_packetizer_data->length], data, part);
+            ble_packetizer_data->length = ble_packetizer_data->length + part;
+            if (ble_packetizer_data->length == ble_packetizer_data->payload)
+            {
+                ble_packet_send_count(ble_packetizer_data, ble_packetizer_data->buffer, ble_packetizer_data->length, send);
+                ble_packetizer_data->length = 0;
+            }
+        }
+        data = &data[part];
+        length = length - part;
+    }
+}
+
+/**
+ * @brief Send the partly filled notification
+ * @param [in,out] ble_packetizer_data
+ * @param [in] send
+ */
+void ble_packet_flush(struct ble_packetizer *ble_packetizer_data, ble_packet_send send)
+{
+    if (ble_packetizer_data->length == 0) return;
+    ble_packet_send_count(ble_packetizer_data, ble_packetizer_data->buffer, ble_packetizer_data->length, send);
+    ble_packetizer_data->length = 0;
+}
+
+/**
+ * @brief Initialize the packetizer for a negotiated ATT MTU
+ * @param [in] ble_packetizer_data, mtu
+ */
+void ble_packet_init(struct ble_packetizer *ble_packetizer_data, uint16_t mtu)
+{
+    if (mtu < BLE_PACKET_MTU_DEFAULT) mtu = BLE_PACKET_MTU_DEFAULT;
+    ble_packetizer_data->payload = mtu - BLE_PACKET_ATT_HEADER;
+    if (ble_packetizer_data->payload > BLE_PACKET_PAYLOAD_MAX) ble_packetizer_data->payload = BLE_PACKET_PAYLOAD_MAX;
+    ble_packetizer_data->length = 0;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file bluetooth_le.cpp
+ *
+ * @brief Bluetooth LE related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+#include "bluetooth_le.h"
+#include "ble_packet.h"
+#include "output.h"
+#include "sd_card.h"
+#include "bus.h"
+
+class bluetooth_le_callbacks : public BLEServerCallbacks
+{
+    public:
+    void onConnect(BLEServer *server, esp_ble_gatts_cb_param_t *param);
+    void onDisconnect(BLEServer *server);
+};
+
+portMUX_TYPE bluetooth_le_taskmux = portMUX_INITIALIZER_UNLOCKED;
+BLEServer *bluetooth_le_server = nullptr;
+BLECharacteristic *bluetooth_le_tx = nullptr;
+bool bluetooth_le_enable = false;
+uint8_t bluetooth_le_output = BLUETOOTH_LE_OUTPUT_NMEA;
+bool bluetooth_le_connected = false;
+uint16_t bluetooth_le_conn_id = 0;
+uint16_t bluetooth_le_mtu = BLE_PACKET_MTU_DEFAULT;
+struct ble_packetizer bluetooth_le_packetizer;
+struct output_hub_sink bluetooth_le_sink;
+uint32_t bluetooth_le_notifications = 0;
+uint32_t bluetooth_le_bytes = 0;
+
+/**
+ * @brief Connection of a central (called from the BLE task)
+ * @param [in] server, param
+ */
+void bluetooth_le_callbacks::onConnect(BLEServer *server, esp_ble_gatts_cb_param_t *param)
+{
+    portENTER_CRITICAL(&bluetooth_le_taskmux);
+    bluetooth_le_conn_id = param->connect.conn_id;
+    bluetooth_le_connected = true;
+    portEXIT_CRITICAL(&bluetooth_le_taskmux);
+}
+
+/**
+ * @brief Disconnection of the central (called from the BLE task)
+ * @param [in] server
+ */
+void bluetooth_le_callbacks::onDisconnect(BLEServer *server)
+{
+    portENTER_CRITICAL(&bluetooth_le_taskmux);
+    bluetooth_le_connected = false;
+    portEXIT_CRITICAL(&bluetooth_le_taskmux);
+    server->startAdvertising();
+}
+
+/**
+ * @brief Send one notification to the central
+ * @param [in] data, length
+ */
+void bluetooth_le_send(const uint8_t *data, uint16_t length)
+{
+    bluetooth_le_tx->setValue((uint8_t *)data, length);
+    bluetooth_le_tx->notify();
+
+    portENTER_CRITICAL(&bluetooth_le_taskmux);
+    bluetooth_le_notifications = bluetooth_le_notifications + 1;
+    bluetooth_le_bytes = bluetooth_le_bytes + length;
+    portEXIT_CRITICAL(&bluetooth_le_taskmux);
+}
+
+/**
+ * @brief Send the compact binary fix of a new epoch of the GNSS
+ *
+ * Time stamp, position and fix state are all taken from the same UBX epoch
+ * of the data bus (iTOW of NAV-PVT equal to iTOW of NAV-HPPOSLLH), the time
+ * stamp is the GPS time of week in ms.
+ */
+void bluetooth_le_fix(void)
+{
+    struct ble_packet_fix ble_packet_fix_data;
+    uint8_t frame[BLE_PACKET_FIX_FRAME_LENGTH];
+    int64_t value = 0;
+    static struct bus_gnss bus_gnss_data;
+    static uint32_t version = 0;
+    static uint32_t last_i_tow = UINT32_MAX;
+
+    esp_task_wdt_reset();
+    if (bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version) == false) return;
+    if ((bus_gnss_data.i_tow != bus_gnss_data.i_tow_hp) || (bus_gnss_data.i_tow == last_i_tow)) return;
+    last_i_tow = bus_gnss_data.i_tow;
+    ble_packet_fix_data.timestamp = bus_gnss_data.i_tow;
+    value = llround(bus_gnss_data.lat * 1E9);
+    ble_packet_fix_data.lat = (int32_t)(value / 100);
+    ble_packet_fix_data.lat_hp = (int8_t)(value % 100);
+    value = llround(bus_gnss_data.lon * 1E9);
+    ble_packet_fix_data.lon = (int32_t)(value / 100);
+    ble_packet_fix_data.lon_hp = (int8_t)(value % 100);
+    ble_packet_fix_data.height = (int32_t)lround(bus_gnss_data.height * 1E3);
+    ble_packet_fix_data.acc = (uint32_t)lround(bus_gnss_data.p_acc * 1E3);
+    ble_packet_fix_data.fix_type = bus_gnss_data.fix_type;
+    ble_packet_fix_data.carr_soln = bus_gnss_data.carr_soln;
+    ble_packet_fix_data.num_sv = bus_gnss_data.num_sv;
+    ble_packet_fix_data.flags = (bus_gnss_data.gnss_fix_ok == true) ? 0x01 : 0x00;
+    if (bus_gnss_data.diff_soln == true) ble_packet_fix_data.flags = ble_packet_fix_data.flags | 0x02;
+    ble_packet_write(&bluetooth_le_packetizer, frame, ble_packet_fix_encode(&ble_packet_fix_data, frame), bluetooth_le_send);
+    ble_packet_flush(&bluetooth_le_packetizer, bluetooth_le_send);
+}
+
+/**
+ * @brief Transfer data from the Bluetooth LE
+ * @param [in] bluetooth_le_data
+ */
+void bluetooth_le_transfer(struct bluetooth_le *bluetooth_le_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static uint32_t last_bytes = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&bluetooth_le_taskmux);
+        if (bluetooth_le_data->active != bluetooth_le_connected)
+        {
+            bluetooth_le_data->active = bluetooth_le_connected;
+            bluetooth_le_data->update = true;
+        }
+        bluetooth_le_data->bytes_per_second = (uint32_t)((uint64_t)(bluetooth_le_bytes - last_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        last_bytes = bluetooth_le_bytes;
+        bluetooth_le_data->notifications = bluetooth_le_notifications;
+        bluetooth_le_data->mtu = bluetooth_le_mtu;
+        portEXIT_CRITICAL(&bluetooth_le_taskmux);
+        bluetooth_le_data->drops = bluetooth_le_sink.drops;
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Send the NMEA sentences or the compact fix to the connected central
+ */
+void bluetooth_le(void)
+{
+    bool connected = false;
+    uint16_t conn_id = 0;
+    uint16_t mtu = 0;
+    const uint8_t *data = nullptr;
+    bool end = false;
+    uint32_t timestamp = 0;
+    uint32_t length = 0;
+
+    esp_task_wdt_reset();
+    if (bluetooth_le_enable == false) return;
+    portENTER_CRITICAL(&bluetooth_le_taskmux);
+    connected = bluetooth_le_connected;
+    conn_id = bluetooth_le_conn_id;
+    portEXIT_CRITICAL(&bluetooth_le_taskmux);
+    if (connected == false)
+    {
+        while (bluetooth_le_output == BLUETOOTH_LE_OUTPUT_NMEA)
+        {
+            length = output_peek(&bluetooth_le_sink, &data, &end, &timestamp);
+            if (length == 0) break;
+            output_consume(&bluetooth_le_sink, length);
+        }
+        bluetooth_le_packetizer.length = 0;
+        return;
+    }
+    mtu = bluetooth_le_server->getPeerMTU(conn_id);
+    if (mtu != bluetooth_le_mtu)
+    {
+        ble_packet_flush(&bluetooth_le_packetizer, bluetooth_le_send);
+        ble_packet_init(&bluetooth_le_packetizer, mtu);
+
+        portENTER_CRITICAL(&bluetooth_le_taskmux);
+        bluetooth_le_mtu = mtu;
+        portEXIT_CRITICAL(&bluetooth_le_taskmux);
+    }
+    if (bluetooth_le_output != BLUETOOTH_LE_OUTPUT_NMEA)
+    {
+        bluetooth_le_fix();
+        return;
+    }
+    while (1)
+    {
+        length = output_peek(&bluetooth_le_sink, &data, &end, &timestamp);
+        if (length == 0) break;
+        ble_packet_write(&bluetooth_le_packetizer, data, (uint16_t)length, bluetooth_le_send);
+        output_consume(&bluetooth_le_sink, length);
+        if (end == true) ble_packet_flush(&bluetooth_le_packetizer, bluetooth_le_send);
+    }
+}
+
+/**
+ * @brief Initialize the Bluetooth LE (Nordic UART service)
+ * @param [in] bluetooth_le_data, sd_card_config2_data
+ * @return error
+ */
+bool bluetooth_le_init(struct bluetooth_le *bluetooth_le_data, struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+    BLEService *service = nullptr;
+
+    esp_task_wdt_reset();
+    bluetooth_le_data->active = false;
+    bluetooth_le_data->mtu = BLE_PACKET_MTU_DEFAULT;
+    bluetooth_le_data->bytes_per_second = 0;
+    bluetooth_le_data->notifications = 0;
+    bluetooth_le_data->drops = 0;
+    bluetooth_le_data->update = true;
+    bluetooth_le_output = sd_card_config2_data->bluetooth_le_output;
+    if (bluetooth_le_output == BLUETOOTH_LE_OUTPUT_NMEA) output_sink_init(&bluetooth_le_sink, sd_card_config2_data->bluetooth_le_sentences, sd_card_config2_data->bluetooth_le_decimation, sd_card_config2_data->bluetooth_le_precision);
+    ble_packet_init(&bluetooth_le_packetizer, BLE_PACKET_MTU_DEFAULT);
+    BLEDevice::init("ZED-F9P");
+    BLEDevice::setMTU(BLUETOOTH_LE_MTU);
+    bluetooth_le_server = BLEDevice::createServer();
+    if (bluetooth_le_server != nullptr)
+    {
+        bluetooth_le_server->setCallbacks(new bluetooth_le_callbacks());
+        service = bluetooth_le_server->createService(BLUETOOTH_LE_SERVICE_UUID);
+        bluetooth_le_tx = service->createCharacteristic(BLUETOOTH_LE_TX_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+        bluetooth_le_tx->addDescriptor(new BLE2902());
+        service->createCharacteristic(BLUETOOTH_LE_RX_UUID, BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_WRITE_NR);
+        service->start();
+        bluetooth_le_server->getAdvertising()->addServiceUUID(BLUETOOTH_LE_SERVICE_UUID);
+        bluetooth_le_server->getAdvertising()->start();
+    }
+    else error = true;
+    if (error == false) bluetooth_le_enable = true;
+
+    return error;
+}
@@ -31,12 +31,77 @@
 #include <SparkFun_u-blox_GNSS_v3.h>
 #include <BluetoothSerial.h>
 #include "bluetooth_serial.h"
+#include "output.h"
+#include "ubx_bridge.h"
+#include "correction.h"
+#include "bus.h"
+
+/*
+ * The SPP writes block while the queue of the Bluetooth stack is full, e.g.
+ * with a phone that stops reading. They run in an own task, so a stalled
+ * client only delays itself, the output hub moves it to the newest epoch and
+ * counts the dropped epochs. The inbound corrections are read in the network
+ * task.
+ */
 
 portMUX_TYPE bluetooth_serial_taskmux = portMUX_INITIALIZER_UNLOCKED; 
+TaskHandle_t bluetooth_serial_handle = NULL;
 BluetoothSerial bt_serial;
-bool bluetooth_serial_active = false;
+struct output_hub_sink bluetooth_serial_sink;
+uint8_t bluetooth_serial_buffer[BLUETOOTH_SERIAL_BUFFER];
+uint16_t bluetooth_serial_length = 0;
+uint32_t bluetooth_serial_epoch_millis = 0;
+uint32_t bluetooth_serial_writes = 0;
+uint32_t bluetooth_serial_bytes = 0;
+uint32_t bluetooth_serial_latency = 0;
+uint32_t bluetooth_serial_latency_max = 0;
+uint32_t bluetooth_serial_splits = 0;
 extern SFE_UBLOX_GNSS_SERIAL gnss_serial;
 
+/**
+ * @brief Write the collected epoch with one SPP write to the client
+ */
+void bluetooth_serial_flush(void)
+{
+    uint32_t latency = 0;
+
+    esp_task_wdt_reset();
+    if (bluetooth_serial_length == 0) return;
+    if (bt_serial.hasClient() == true)
+    {
+        bt_serial.write(bluetooth_serial_buffer, bluetooth_serial_length);
+        latency = (uint32_t)(millis() - bluetooth_serial_epoch_millis);
+
+        portENTER_CRITICAL(&bluetooth_serial_taskmux);
+        bluetooth_serial_writes = bluetooth_serial_writes + 1;
+        bluetooth_serial_bytes = bluetooth_serial_bytes + bluetooth_serial_length;
+        bluetooth_serial_latency = latency;
+        if (latency > bluetooth_serial_latency_max) bluetooth_serial_latency_max = latency;
+        portEXIT_CRITICAL(&bluetooth_serial_taskmux);
+    }
+    bluetooth_serial_length = 0;
+}
+
+/**
+ * @brief Collect a run of NMEA sentences of the output hub into the epoch buffer
+ * @param [in] data, length, timestamp
+ */
+void bluetooth_serial_collect(const uint8_t *data, uint32_t length, uint32_t timestamp)
+{
+    if ((bluetooth_serial_length + length) > sizeof(bluetooth_serial_buffer))
+    {
+        bluetooth_serial_flush();
+
+        portENTER_CRITICAL(&bluetooth_serial_taskmux);
+        bluetooth_serial_splits = bluetooth_serial_splits + 1;
+        portEXIT_CRITICAL(&bluetooth_serial_taskmux);
+    }
+    if (length > sizeof(bluetooth_serial_buffer)) length = sizeof(bluetooth_serial_buffer);
+    if (bluetooth_serial_length == 0) bluetooth_serial_epoch_millis = timestamp;
+    memcpy(&bluetooth_serial_buffer[bluetooth_serial_length], data, length);
+    bluetooth_serial_length = bluetooth_serial_length + length;
+}
+
 /**
  * @brief Transfer data from the Bluetooth serial
  * @param [in] bluetooth_serial_data
@@ -45,56 +110,115 @@ void bluetooth_serial_transfer(struct bluetooth_serial *bluetooth_serial_data)
 {
     unsigned long curr_millis = 0;
     static unsigned long last_millis = millis();
+    static struct bus_link bus_link_data;
+    static uint32_t version = 0;
  
     esp_task_wdt_reset();
-    curr_millis = millis();
-    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    if (bus_read(BUS_TOPIC_LINK, &bus_link_data, &version) == true)
     {
-        portENTER_CRITICAL(&bluetooth_serial_taskmux);
-        if (bluetooth_serial_data->active != bluetooth_serial_active)
+        if (bluetooth_serial_data->active != bus_link_data.bluetooth_serial_active)
         {
-            bluetooth_serial_data->active = bluetooth_serial_active;
+            bluetooth_serial_data->active = bus_link_data.bluetooth_serial_active;
             bluetooth_serial_data->update = true;
         }
+    }
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&bluetooth_serial_taskmux);
+        bluetooth_serial_data->writes = bluetooth_serial_writes;
+        if (bluetooth_serial_writes > 0) bluetooth_serial_data->bytes_per_write = bluetooth_serial_bytes / bluetooth_serial_writes;
+        else bluetooth_serial_data->bytes_per_write = 0;
+        bluetooth_serial_data->latency = bluetooth_serial_latency;
+        bluetooth_serial_data->latency_max = bluetooth_serial_latency_max;
+        bluetooth_serial_data->splits = bluetooth_serial_splits;
         portEXIT_CRITICAL(&bluetooth_serial_taskmux);
+        bluetooth_serial_data->drops = bluetooth_serial_sink.drops;
         last_millis = curr_millis;
     }
 }
 
 /**
- * @brief Transfer data from the bluetooth serial
+ * @brief Wait for the next epoch of the output hub (or the wait time)
  */
-void bluetooth_serial(void)
+void bluetooth_serial_wait(void)
 {
     esp_task_wdt_reset();
-    if (bt_serial.hasClient() == true)
+    if (bluetooth_serial_handle == NULL)
     {
-        gnss_serial.checkUblox();
+        bluetooth_serial_handle = xTaskGetCurrentTaskHandle();
+        output_subscribe(bluetooth_serial_handle);
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BLUETOOTH_SERIAL_WAIT));
+}
 
-        portENTER_CRITICAL(&bluetooth_serial_taskmux);
-        bluetooth_serial_active = true;
-        portEXIT_CRITICAL(&bluetooth_serial_taskmux);
+/**
+ * @brief Write the NMEA sentences of the output hub to the client (own task)
+ */
+void bluetooth_serial_output(void)
+{
+    const uint8_t *run = nullptr;
+    bool end = false;
+    uint32_t timestamp = 0;
+    uint32_t length = 0;
+
+    while (1)
+    {
+        length = output_peek(&bluetooth_serial_sink, &run, &end, &timestamp);
+        if (length == 0) break;
+        if (ubx_bridge_bluetooth() == false) bluetooth_serial_collect(run, length, timestamp);
+        if (output_consume(&bluetooth_serial_sink, length) == true) bluetooth_serial_length = 0;
+        if (end == true) bluetooth_serial_flush();
     }
-    else
+}
+
+/**
+ * @brief Transfer data from the bluetooth serial
+ * @return error (no client connected)
+ */
+bool bluetooth_serial(void)
+{
+    bool error = true;
+    uint8_t data[BLUETOOTH_SERIAL_INBOUND];
+    int counter = 0;
+
+    esp_task_wdt_reset();
+    gnss_serial.checkUblox();
+    if (ubx_bridge_bluetooth() == true) return error;
+    if (bt_serial.hasClient() == true)
     {
-        portENTER_CRITICAL(&bluetooth_serial_taskmux);
-        bluetooth_serial_active = false;
-        portEXIT_CRITICAL(&bluetooth_serial_taskmux);
+        counter = bt_serial.available();
+        if (counter > 0)
+        {
+            if (counter > (int)sizeof(data)) counter = sizeof(data);
+            counter = (int)bt_serial.readBytes(data, (size_t)counter);
+            if (counter > 0) correction_push(CORRECTION_SOURCE_BLUETOOTH, data, (uint16_t)counter);
+        }
+        error = false;
     }
+
+    return error;
 }
 
 /**
  * @brief Initialize the Bluetooth serial
- * @param [in] gnss_data
+ * @param [in] bluetooth_serial_data, sd_card_config2_data
  * @return error
  */
-bool bluetooth_serial_init(struct bluetooth_serial *bluetooth_serial_data)
+bool bluetooth_serial_init(struct bluetooth_serial *bluetooth_serial_data, struct sd_card_config2 *sd_card_config2_data)
 {
     bool error = false;
 
     esp_task_wdt_reset();
     error = !bt_serial.begin("ZED-F9P");
+    output_sink_init(&bluetooth_serial_sink, sd_card_config2_data->output_bluetooth_sentences, sd_card_config2_data->output_bluetooth_decimation, sd_card_config2_data->output_bluetooth_precision);
     bluetooth_serial_data->active = false;
+    bluetooth_serial_data->writes = 0;
+    bluetooth_serial_data->bytes_per_write = 0;
+    bluetooth_serial_data->latency = 0;
+    bluetooth_serial_data->latency_max = 0;
+    bluetooth_serial_data->splits = 0;
+    bluetooth_serial_data->drops = 0;
 
     return error;
 }
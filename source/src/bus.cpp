@@ -0,0 +1,156 @@
+/**
+ * @file bus.cpp
+ *
+ * @brief Publish/subscribe data bus related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include "bus.h"
+
+/*
+ * Every topic has exactly one writing task and holds the latest value only.
+ * The version is odd while the writer copies the value, a reader copies the
+ * value and retries if the version was odd or changed meanwhile, so neither
+ * side takes a lock. Subscribed tasks get a task notification on every
+ * publication.
+ */
+
+struct bus_topic
+{
+    uint32_t version;
+    uint8_t *data;
+    uint32_t size;
+    TaskHandle_t subscriber[BUS_SUBSCRIBERS];
+    uint8_t subscribers;
+};
+
+struct bus_topic bus_topics[BUS_TOPICS];
+struct bus_gnss bus_gnss_data;
+struct bus_satellites bus_satellites_data;
+struct bus_link bus_link_data;
+struct bus_survey bus_survey_data;
+struct bus_correction bus_correction_data;
+
+/**
+ * @brief Publish a new value of a topic (only from the writing task of the topic)
+ * @param [in] topic, data
+ */
+void bus_publish(uint8_t topic, const void *data)
+{
+    struct bus_topic *bus_topic_data = &bus_topics[topic];
+    uint32_t version = bus_topic_data->version;
+    uint8_t counter = 0;
+
+    __atomic_store_n(&bus_topic_data->version, version + 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    memcpy(bus_topic_data->data, data, bus_topic_data->size);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    __atomic_store_n(&bus_topic_data->version, version + 2, __ATOMIC_SEQ_CST);
+    for (counter = 0; counter < bus_topic_data->subscribers; counter = counter + 1) xTaskNotifyGive(bus_topic_data->subscriber[counter]);
+}
+
+/**
+ * @brief Copy the latest value of a topic
+ * @param [in] topic, version
+ * @param [out] data, version
+ * @return true if the value is newer than the given version
+ */
+bool bus_read(uint8_t topic, void *data, uint32_t *version)
+{
+    struct bus_topic *bus_topic_data = &bus_topics[topic];
+    uint32_t version1 = 0;
+    uint32_t version2 = 0;
+    uint8_t counter = 0;
+    bool updated = false;
+
+    while (1)
+    {
+        version1 = __atomic_load_n(&bus_topic_data->version, __ATOMIC_SEQ_CST);
+        if ((version1 & 1) == 0)
+        {
+            memcpy(data, bus_topic_data->data, bus_topic_data->size);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            version2 = __atomic_load_n(&bus_topic_data->version, __ATOMIC_SEQ_CST);
+            if (version1 == version2) break;
+        }
+        counter = counter + 1;
+        if (counter > BUS_RETRIES) vTaskDelay(1);
+    }
+    updated = (version1 != *version);
+    *version = version1;
+
+    return updated;
+}
+
+/**
+ * @brief Wake a task on every publication of a topic (before the tasks are started)
+ * @param [in] topic, handle
+ * @return error
+ */
+bool bus_subscribe(uint8_t topic, TaskHandle_t handle)
+{
+    struct bus_topic *bus_topic_data = &bus_topics[topic];
+
+    esp_task_wdt_reset();
+    if (bus_topic_data->subscribers >= BUS_SUBSCRIBERS) return true;
+    bus_topic_data->subscriber[bus_topic_data->subscribers] = handle;
+    bus_topic_data->subscribers = bus_topic_data->subscribers + 1;
+
+    return false;
+}
+
+/**
+ * @brief Initialize the data bus
+ */
+void bus_init(void)
+{
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    memset(&bus_gnss_data, 0, sizeof(bus_gnss_data));
+    memset(&bus_satellites_data, 0, sizeof(bus_satellites_data));
+    memset(&bus_link_data, 0, sizeof(bus_link_data));
+    memset(&bus_survey_data, 0, sizeof(bus_survey_data));
+    memset(&bus_correction_data, 0, sizeof(bus_correction_data));
+    bus_gnss_data.a_status = 1;
+    bus_correction_data.source = CORRECTION_SOURCE_NONE;
+    bus_topics[BUS_TOPIC_GNSS].data = (uint8_t *)&bus_gnss_data;
+    bus_topics[BUS_TOPIC_GNSS].size = sizeof(bus_gnss_data);
+    bus_topics[BUS_TOPIC_SATELLITES].data = (uint8_t *)&bus_satellites_data;
+    bus_topics[BUS_TOPIC_SATELLITES].size = sizeof(bus_satellites_data);
+    bus_topics[BUS_TOPIC_LINK].data = (uint8_t *)&bus_link_data;
+    bus_topics[BUS_TOPIC_LINK].size = sizeof(bus_link_data);
+    bus_topics[BUS_TOPIC_SURVEY].data = (uint8_t *)&bus_survey_data;
+    bus_topics[BUS_TOPIC_SURVEY].size = sizeof(bus_survey_data);
+    bus_topics[BUS_TOPIC_CORRECTION].data = (uint8_t *)&bus_correction_data;
+    bus_topics[BUS_TOPIC_CORRECTION].size = sizeof(bus_correction_data);
+    for (counter = 0; counter < BUS_TOPICS; counter = counter + 1)
+    {
+        bus_topics[counter].version = 0;
+        bus_topics[counter].subscribers = 0;
+    }
+}
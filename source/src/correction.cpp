@@ -0,0 +1,257 @@
+/**
+ * @file correction.cpp
+ *
+ * @brief Correction related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <SparkFun_u-blox_GNSS_v3.h>
+#include "correction.h"
+#include "rtcm.h"
+#include "ntrip_caster.h"
+#include "ubx_bridge.h"
+#include "bus.h"
+
+portMUX_TYPE correction_taskmux = portMUX_INITIALIZER_UNLOCKED;
+struct rtcm_parser correction_rtcm_parser[CORRECTION_SOURCES];
+uint8_t correction_buffer[2048];
+uint32_t correction_bytes = 0;
+uint32_t correction_frames = 0;
+uint32_t correction_frame_errors = 0;
+uint8_t correction_source = CORRECTION_SOURCE_NONE;
+unsigned long correction_source_millis = 0;
+uint32_t correction_source_bytes[CORRECTION_SOURCES];
+uint32_t correction_source_frame_errors[CORRECTION_SOURCES];
+uint32_t correction_source_drops[CORRECTION_SOURCES];
+uint32_t correction_reconnects = 0;
+bool correction_connected = false;
+unsigned long correction_frame_millis = 0;
+uint32_t correction_gap_histogram[CORRECTION_GAP_BUCKETS];
+struct correction_message_type correction_message_types[CORRECTION_MESSAGE_TYPES];
+const unsigned long correction_gap_limits[CORRECTION_GAP_BUCKETS - 1] = {1500, 3000, 5000, 10000, 30000};
+extern SFE_UBLOX_GNSS_SERIAL gnss_serial;
+
+/**
+ * @brief Transfer data from the correction
+ * @param [in] correction_data
+ */
+void correction_transfer(struct correction *correction_data)
+{
+    uint8_t counter = 0;
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static uint32_t last_bytes = 0;
+    static uint32_t last_source_bytes[CORRECTION_SOURCES] = {0};
+    static struct bus_correction bus_correction_data = {CORRECTION_SOURCE_NONE, 0};
+    static uint32_t version = 0;
+
+    esp_task_wdt_reset();
+    bus_read(BUS_TOPIC_CORRECTION, &bus_correction_data, &version);
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&correction_taskmux);
+        correction_data->bytes_per_second = (uint32_t)((uint64_t)(correction_bytes - last_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        last_bytes = correction_bytes;
+        if (correction_frames > 0) correction_data->age = (uint32_t)(curr_millis - correction_frame_millis);
+        else correction_data->age = UINT32_MAX;
+        correction_data->reconnects = correction_reconnects;
+        correction_data->frames = correction_frames;
+        correction_data->frame_errors = correction_frame_errors;
+        for (counter = 0; counter < CORRECTION_GAP_BUCKETS; counter = counter + 1) correction_data->gap_histogram[counter] = correction_gap_histogram[counter];
+        for (counter = 0; counter < CORRECTION_MESSAGE_TYPES; counter = counter + 1)
+        {
+            correction_data->message_types[counter].type = correction_message_types[counter].type;
+            correction_data->message_types[counter].count = correction_message_types[counter].count;
+        }
+        for (counter = 0; counter < CORRECTION_SOURCES; counter = counter + 1)
+        {
+            correction_data->source_bytes_per_second[counter] = (uint32_t)((uint64_t)(correction_source_bytes[counter] - last_source_bytes[counter]) * 1000 / (unsigned long)(curr_millis - last_millis));
+            last_source_bytes[counter] = correction_source_bytes[counter];
+            correction_data->source_frame_errors[counter] = correction_source_frame_errors[counter];
+            correction_data->source_drops[counter] = correction_source_drops[counter];
+        }
+        portEXIT_CRITICAL(&correction_taskmux);
+        if ((bus_correction_data.source != CORRECTION_SOURCE_NONE) && ((uint32_t)(curr_millis - bus_correction_data.source_millis) <= CORRECTION_SOURCE_TIMEOUT)) correction_data->source = bus_correction_data.source;
+        else correction_data->source = CORRECTION_SOURCE_NONE;
+        correction_data->update = true;
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Push correction data of a source through the RTCM framing to the GNSS
+ *
+ * Every source has its own RTCM parser, so only complete frames reach the
+ * GNSS. The source that delivered the last frame owns the correction path
+ * until it is silent for CORRECTION_SOURCE_TIMEOUT, frames of the other
+ * sources are dropped meanwhile, so two streams never interleave. All sources
+ * are read in the network task, which owns the arbitration and publishes the
+ * active source on the data bus. While a client uses the UBX bridge the
+ * frames are not written to the GNSS.
+ * @param [in] source, data, length
+ * @return error
+ */
+bool correction_push(uint8_t source, uint8_t *data, uint16_t length)
+{
+    bool error = false;
+    bool accept = false;
+    uint16_t counter1 = 0;
+    uint8_t counter2 = 0;
+    uint16_t buffer_length = 0;
+    uint16_t type = 0;
+    unsigned long curr_millis = 0;
+    unsigned long gap = 0;
+    struct bus_correction bus_correction_data;
+
+    esp_task_wdt_reset();
+    for (counter1 = 0; counter1 < length; counter1 = counter1 + 1)
+    {
+        if (rtcm_parse(&correction_rtcm_parser[source], data[counter1]) == true)
+        {
+            curr_millis = millis();
+            if ((correction_source == source) || (correction_source == CORRECTION_SOURCE_NONE) || ((unsigned long)(curr_millis - correction_source_millis) > CORRECTION_SOURCE_TIMEOUT))
+            {
+                correction_source = source;
+                correction_source_millis = curr_millis;
+                bus_correction_data.source = correction_source;
+                bus_correction_data.source_millis = (uint32_t)correction_source_millis;
+                bus_publish(BUS_TOPIC_CORRECTION, &bus_correction_data);
+                accept = true;
+            }
+            else
+            {
+                portENTER_CRITICAL(&correction_taskmux);
+                correction_source_drops[source] = correction_source_drops[source] + 1;
+                portEXIT_CRITICAL(&correction_taskmux);
+                accept = false;
+            }
+            if (accept == false) continue;
+
+            if ((buffer_length + correction_rtcm_parser[source].frame_length) > sizeof(correction_buffer))
+            {
+                ntrip_caster_push(correction_buffer, buffer_length);
+                if ((ubx_bridge_active() == false) && (gnss_serial.pushRawData(correction_buffer, buffer_length, true) == false)) error = true;
+                buffer_length = 0;
+            }
+            memcpy(&correction_buffer[buffer_length], correction_rtcm_parser[source].frame, correction_rtcm_parser[source].frame_length);
+            buffer_length = buffer_length + correction_rtcm_parser[source].frame_length;
+            type = rtcm_message_type(correction_rtcm_parser[source].frame);
+
+            portENTER_CRITICAL(&correction_taskmux);
+            if (correction_frames > 0)
+            {
+                gap = (unsigned long)(curr_millis - correction_frame_millis);
+                if (gap > 250)
+                {
+                    for (counter2 = 0; counter2 < (CORRECTION_GAP_BUCKETS - 1); counter2 = counter2 + 1)
+                    {
+                        if (gap < correction_gap_limits[counter2]) break;
+                    }
+                    correction_gap_histogram[counter2] = correction_gap_histogram[counter2] + 1;
+                }
+            }
+            correction_frame_millis = curr_millis;
+            correction_frames = correction_frames + 1;
+            for (counter2 = 0; counter2 < CORRECTION_MESSAGE_TYPES; counter2 = counter2 + 1)
+            {
+                if ((correction_message_types[counter2].type == type) || (correction_message_types[counter2].type == 0))
+                {
+                    correction_message_types[counter2].type = type;
+                    correction_message_types[counter2].count = correction_message_types[counter2].count + 1;
+                    break;
+                }
+            }
+            portEXIT_CRITICAL(&correction_taskmux);
+        }
+    }
+    if (buffer_length > 0)
+    {
+        ntrip_caster_push(correction_buffer, buffer_length);
+        if ((ubx_bridge_active() == false) && (gnss_serial.pushRawData(correction_buffer, buffer_length, true) == false)) error = true;
+    }
+
+    portENTER_CRITICAL(&correction_taskmux);
+    correction_bytes = correction_bytes + length;
+    correction_source_bytes[source] = correction_source_bytes[source] + length;
+    correction_frame_errors = correction_frame_errors - correction_source_frame_errors[source] + correction_rtcm_parser[source].errors;
+    correction_source_frame_errors[source] = correction_rtcm_parser[source].errors;
+    portEXIT_CRITICAL(&correction_taskmux);
+
+    return error;
+}
+
+/**
+ * @brief Count a (re)connection of the correction source
+ */
+void correction_connect(void)
+{
+    portENTER_CRITICAL(&correction_taskmux);
+    if (correction_connected == true) correction_reconnects = correction_reconnects + 1;
+    correction_connected = true;
+    portEXIT_CRITICAL(&correction_taskmux);
+}
+
+/**
+ * @brief Initialize the correction
+ * @param [in] correction_data
+ */
+void correction_init(struct correction *correction_data)
+{
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    for (counter = 0; counter < CORRECTION_SOURCES; counter = counter + 1)
+    {
+        rtcm_parser_init(&correction_rtcm_parser[counter]);
+        correction_source_bytes[counter] = 0;
+        correction_source_frame_errors[counter] = 0;
+        correction_source_drops[counter] = 0;
+        correction_data->source_bytes_per_second[counter] = 0;
+        correction_data->source_frame_errors[counter] = 0;
+        correction_data->source_drops[counter] = 0;
+    }
+    correction_data->source = CORRECTION_SOURCE_NONE;
+    for (counter = 0; counter < CORRECTION_GAP_BUCKETS; counter = counter + 1)
+    {
+        correction_gap_histogram[counter] = 0;
+        correction_data->gap_histogram[counter] = 0;
+    }
+    for (counter = 0; counter < CORRECTION_MESSAGE_TYPES; counter = counter + 1)
+    {
+        correction_message_types[counter].type = 0;
+        correction_message_types[counter].count = 0;
+        correction_data->message_types[counter].type = 0;
+        correction_data->message_types[counter].count = 0;
+    }
+    correction_data->bytes_per_second = 0;
+    correction_data->age = UINT32_MAX;
+    correction_data->reconnects = 0;
+    correction_data->frames = 0;
+    correction_data->frame_errors = 0;
+    correction_data->update = true;
+}
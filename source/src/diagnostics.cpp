@@ -0,0 +1,183 @@
+/**
+ * @file diagnostics.cpp
+ *
+ * @brief Runtime diagnostics related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include "diagnostics.h"
+
+portMUX_TYPE diagnostics_taskmux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t diagnostics_handle[TASK_LOAD_TASKS];
+uint32_t diagnostics_stack_size[TASK_LOAD_TASKS];
+bool diagnostics_csv = false;
+uint32_t diagnostics_period = 10000;
+uint32_t diagnostics_alloc_failures = 0;
+uint32_t diagnostics_alloc_failed_size = 0;
+
+const char static PROGMEM diagnostics_reset_text_0[] = "unknown";
+const char static PROGMEM diagnostics_reset_text_1[] = "power on";
+const char static PROGMEM diagnostics_reset_text_2[] = "external";
+const char static PROGMEM diagnostics_reset_text_3[] = "software";
+const char static PROGMEM diagnostics_reset_text_4[] = "panic";
+const char static PROGMEM diagnostics_reset_text_5[] = "interrupt watchdog";
+const char static PROGMEM diagnostics_reset_text_6[] = "task watchdog";
+const char static PROGMEM diagnostics_reset_text_7[] = "watchdog";
+const char static PROGMEM diagnostics_reset_text_8[] = "deep sleep";
+const char static PROGMEM diagnostics_reset_text_9[] = "brownout";
+const char* const PROGMEM diagnostics_reset_text_list[] = {diagnostics_reset_text_0, diagnostics_reset_text_1, diagnostics_reset_text_2, diagnostics_reset_text_3, diagnostics_reset_text_4, diagnostics_reset_text_5, diagnostics_reset_text_6, diagnostics_reset_text_7, diagnostics_reset_text_8, diagnostics_reset_text_9};
+
+/**
+ * @brief Get the text of a reset reason
+ * @param [in] reset_reason
+ * @return text
+ */
+const char *diagnostics_reset_text(uint8_t reset_reason)
+{
+    if (reset_reason >= (sizeof(diagnostics_reset_text_list) / sizeof(diagnostics_reset_text_list[0]))) reset_reason = 0;
+
+    return diagnostics_reset_text_list[reset_reason];
+}
+
+/**
+ * @brief Count a failed heap allocation (called by the heap in the context of the allocating task)
+ * @param [in] size, caps, function_name
+ */
+void diagnostics_alloc_failed(size_t size, uint32_t caps, const char *function_name)
+{
+    portENTER_CRITICAL_SAFE(&diagnostics_taskmux);
+    diagnostics_alloc_failures = diagnostics_alloc_failures + 1;
+    diagnostics_alloc_failed_size = (uint32_t)size;
+    portEXIT_CRITICAL_SAFE(&diagnostics_taskmux);
+}
+
+/**
+ * @brief Register a task for the stack supervision
+ * @param [in] task, handle, stack_size
+ */
+void diagnostics_task(uint8_t task, TaskHandle_t handle, uint32_t stack_size)
+{
+    diagnostics_handle[task] = handle;
+    diagnostics_stack_size[task] = stack_size;
+}
+
+/**
+ * @brief Collect the diagnostics and stream them as CSV over the serial
+ * @param [in] diagnostics_data, task_load_data, frame_data
+ */
+void diagnostics_transfer(struct diagnostics *diagnostics_data, struct task_load *task_load_data, struct frame *frame_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static unsigned long csv_millis = millis();
+    static unsigned long report_millis = millis();
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        diagnostics_data->heap_free = ESP.getFreeHeap();
+        diagnostics_data->heap_min = ESP.getMinFreeHeap();
+        diagnostics_data->heap_largest = ESP.getMaxAllocHeap();
+        if ((diagnostics_data->heap_largest_min == 0) || (diagnostics_data->heap_largest < diagnostics_data->heap_largest_min)) diagnostics_data->heap_largest_min = diagnostics_data->heap_largest;
+        if (diagnostics_data->heap_free > 0) diagnostics_data->fragmentation = (uint8_t)(100 - (uint64_t)diagnostics_data->heap_largest * 100 / diagnostics_data->heap_free);
+        else diagnostics_data->fragmentation = 0;
+        portENTER_CRITICAL(&diagnostics_taskmux);
+        diagnostics_data->alloc_failures = diagnostics_alloc_failures;
+        diagnostics_data->alloc_failed_size = diagnostics_alloc_failed_size;
+        portEXIT_CRITICAL(&diagnostics_taskmux);
+        diagnostics_data->psram_free = ESP.getFreePsram();
+        diagnostics_data->psram_largest = ESP.getMaxAllocPsram();
+        for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1)
+        {
+            diagnostics_data->load[counter] = task_load_data->load[counter];
+            diagnostics_data->load_max[counter] = task_load_data->load_max[counter];
+            diagnostics_data->stack_size[counter] = diagnostics_stack_size[counter];
+            if (diagnostics_handle[counter] != NULL) diagnostics_data->stack_free[counter] = uxTaskGetStackHighWaterMark(diagnostics_handle[counter]);
+            else diagnostics_data->stack_free[counter] = 0;
+        }
+        diagnostics_data->frames_per_second = frame_data->frames_per_second;
+        diagnostics_data->frame_time_max = frame_data->frame_time_max;
+        diagnostics_data->update = true;
+        last_millis = curr_millis;
+
+        if ((diagnostics_csv == true) && ((unsigned long)(curr_millis - csv_millis) >= diagnostics_period))
+        {
+            Serial.printf("diag,%lu,%lu,%lu,%lu,%lu,%u,%lu,%lu,%lu", (unsigned long)curr_millis, (unsigned long)diagnostics_data->heap_free, (unsigned long)diagnostics_data->heap_min, (unsigned long)diagnostics_data->heap_largest, (unsigned long)diagnostics_data->heap_largest_min, diagnostics_data->fragmentation, (unsigned long)diagnostics_data->alloc_failures, (unsigned long)diagnostics_data->psram_free, (unsigned long)diagnostics_data->psram_largest);
+            for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1) Serial.printf(",%u,%lu", diagnostics_data->load[counter], (unsigned long)diagnostics_data->stack_free[counter]);
+            Serial.printf(",%u,%lu\n", diagnostics_data->frames_per_second, (unsigned long)diagnostics_data->frame_time_max);
+            csv_millis = curr_millis;
+        }
+
+        if ((unsigned long)(curr_millis - report_millis) >= DIAGNOSTICS_REPORT)
+        {
+            Serial.printf("Heap statistics (%lu free, %lu largest block, %lu lowest largest block, %u%% fragmentation, %lu failed allocations)... ", (unsigned long)diagnostics_data->heap_free, (unsigned long)diagnostics_data->heap_largest, (unsigned long)diagnostics_data->heap_largest_min, diagnostics_data->fragmentation, (unsigned long)diagnostics_data->alloc_failures);
+            if (diagnostics_data->alloc_failures > 0) Serial.printf("failed (last %lu bytes)\n", (unsigned long)diagnostics_data->alloc_failed_size);
+            else Serial.print(F("ok\n"));
+            report_millis = curr_millis;
+        }
+    }
+}
+
+/**
+ * @brief Initialize the diagnostics
+ * @param [in] diagnostics_data, sd_card_config2_data
+ */
+void diagnostics_init(struct diagnostics *diagnostics_data, struct sd_card_config2 *sd_card_config2_data)
+{
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    diagnostics_csv = (sd_card_config2_data->diagnostics_csv == 1);
+    diagnostics_period = (uint32_t)sd_card_config2_data->diagnostics_period * 1000;
+    diagnostics_data->update = false;
+    diagnostics_data->reset_reason = (uint8_t)esp_reset_reason();
+    diagnostics_data->heap_free = 0;
+    diagnostics_data->heap_min = 0;
+    diagnostics_data->heap_largest = 0;
+    diagnostics_data->heap_largest_min = 0;
+    diagnostics_data->fragmentation = 0;
+    diagnostics_data->alloc_failures = 0;
+    diagnostics_data->alloc_failed_size = 0;
+    diagnostics_data->psram_free = 0;
+    diagnostics_data->psram_largest = 0;
+    for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1)
+    {
+        diagnostics_handle[counter] = NULL;
+        diagnostics_stack_size[counter] = 0;
+        diagnostics_data->load[counter] = 0;
+        diagnostics_data->load_max[counter] = 0;
+        diagnostics_data->stack_size[counter] = 0;
+        diagnostics_data->stack_free[counter] = 0;
+    }
+    diagnostics_data->frames_per_second = 0;
+    diagnostics_data->frame_time_max = 0;
+    heap_caps_register_failed_alloc_callback(diagnostics_alloc_failed);
+    Serial.printf("Last reset (%s)... ok\n", diagnostics_reset_text(diagnostics_data->reset_reason));
+    if (diagnostics_csv == true) Serial.print(F("diag,millis,heap_free,heap_min,heap_largest,heap_largest_min,fragmentation,alloc_failures,psram_free,psram_largest,uart_load,uart_stack_free,gnss_load,gnss_stack_free,network_load,network_stack_free,ui_load,ui_stack_free,fps,frame_time_max\n"));
+}
@@ -0,0 +1,210 @@
+/**
+ * @file frame.cpp
+ *
+ * @brief Frame pacing of the user interface related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include "frame.h"
+#include "tough.h"
+
+/*
+ * The user interface task sleeps until a task notification (new GNSS data or
+ * a touch interrupt) or a deadline. Without activity it wakes every FRAME_IDLE
+ * for the clock and the transfer functions. Pages are drawn at most with
+ * FRAME_RATE, a notification before the next frame slot only shortens the
+ * sleep to that slot. After a touch the task polls with FRAME_RATE for
+ * FRAME_TOUCH_HOLD so the release of a tap is seen.
+ */
+
+TaskHandle_t frame_handle = NULL;
+volatile bool frame_touched = false;
+unsigned long frame_deadline = 0;
+unsigned long frame_touch_millis = 0;
+bool frame_pending = false;
+unsigned long frame_start = 0;
+uint32_t frame_frames = 0;
+uint32_t frame_wakeups = 0;
+uint64_t frame_time_sum = 0;
+uint32_t frame_time_max = 0;
+uint64_t frame_idle = 0;
+
+/**
+ * @brief Wake the user interface task from the touch interrupt
+ */
+void IRAM_ATTR frame_touch(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    frame_touched = true;
+    if (frame_handle != NULL) vTaskNotifyGiveFromISR(frame_handle, &woken);
+    if (woken == pdTRUE) portYIELD_FROM_ISR();
+}
+
+/**
+ * @brief Sleep until a notification, the next frame slot or the idle timeout
+ */
+void frame_wait(void)
+{
+    unsigned long curr_millis = 0;
+    uint32_t timeout = FRAME_IDLE;
+    unsigned long start = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if (frame_touched == true)
+    {
+        frame_touched = false;
+        frame_touch_millis = curr_millis;
+    }
+    if ((frame_pending == true) || ((unsigned long)(curr_millis - frame_touch_millis) < FRAME_TOUCH_HOLD) || (digitalRead(TOUCH_INT) == LOW))
+    {
+        if ((long)(frame_deadline - curr_millis) > 0) timeout = (uint32_t)(frame_deadline - curr_millis);
+        else timeout = 0;
+    }
+    if (timeout > 0)
+    {
+        start = micros();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout));
+        frame_idle = frame_idle + (unsigned long)(micros() - start);
+    }
+    frame_wakeups = frame_wakeups + 1;
+}
+
+/**
+ * @brief Check if the next frame slot is reached
+ * @return true if a page may be drawn, false if it has to wait for the next slot
+ */
+bool frame_due(void)
+{
+    unsigned long curr_millis = 0;
+
+    curr_millis = millis();
+    if ((long)(curr_millis - frame_deadline) < 0)
+    {
+        frame_pending = true;
+        return false;
+    }
+    frame_deadline = curr_millis + 1000 / FRAME_RATE;
+    frame_pending = false;
+
+    return true;
+}
+
+/**
+ * @brief Start the time measurement of a frame
+ */
+void frame_begin(void)
+{
+    frame_start = micros();
+}
+
+/**
+ * @brief Stop the time measurement of a frame
+ * @param [in] drawn
+ */
+void frame_end(bool drawn)
+{
+    uint32_t frame_time = 0;
+
+    if (drawn == false) return;
+    frame_time = (uint32_t)(micros() - frame_start);
+    frame_frames = frame_frames + 1;
+    frame_time_sum = frame_time_sum + frame_time;
+    if (frame_time > frame_time_max) frame_time_max = frame_time;
+}
+
+/**
+ * @brief Transfer the frame statistics
+ * @param [in] frame_data
+ */
+void frame_transfer(struct frame *frame_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static unsigned long report_millis = millis();
+    static uint32_t report_frames = 0;
+    static uint32_t report_wakeups = 0;
+    static uint64_t report_idle = 0;
+    static uint32_t report_time_max = 0;
+    uint32_t elapsed = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        elapsed = (uint32_t)(curr_millis - last_millis);
+        frame_data->frames_per_second = (uint8_t)((frame_frames * 1000 + elapsed / 2) / elapsed);
+        frame_data->wakeups_per_second = (uint8_t)((frame_wakeups * 1000 + elapsed / 2) / elapsed);
+        frame_data->idle = (uint8_t)(frame_idle / 10 / elapsed);
+        if (frame_data->idle > 100) frame_data->idle = 100;
+        if (frame_frames > 0) frame_data->frame_time = (uint32_t)(frame_time_sum / frame_frames);
+        frame_data->frame_time_max = frame_time_max;
+        frame_data->update = true;
+
+        report_frames = report_frames + frame_frames;
+        report_wakeups = report_wakeups + frame_wakeups;
+        report_idle = report_idle + frame_idle;
+        if (frame_time_max > report_time_max) report_time_max = frame_time_max;
+        frame_frames = 0;
+        frame_wakeups = 0;
+        frame_time_sum = 0;
+        frame_time_max = 0;
+        frame_idle = 0;
+        last_millis = curr_millis;
+    }
+    if ((unsigned long)(curr_millis - report_millis) > FRAME_REPORT)
+    {
+        elapsed = (uint32_t)(curr_millis - report_millis);
+        Serial.printf("Frame statistics (%lu frames/min, %lu wakeups/min, %lu us max frame time, %lu%% idle)... ok\n", (unsigned long)((uint64_t)report_frames * 60000 / elapsed), (unsigned long)((uint64_t)report_wakeups * 60000 / elapsed), (unsigned long)report_time_max, (unsigned long)(report_idle / 10 / elapsed));
+        report_frames = 0;
+        report_wakeups = 0;
+        report_idle = 0;
+        report_time_max = 0;
+        report_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Initialize the frame pacing for the calling task
+ * @param [in] frame_data
+ */
+void frame_init(struct frame *frame_data)
+{
+    esp_task_wdt_reset();
+    frame_handle = xTaskGetCurrentTaskHandle();
+    frame_deadline = millis();
+    frame_touch_millis = (unsigned long)(millis() - FRAME_TOUCH_HOLD);
+    pinMode(TOUCH_INT, INPUT);
+    attachInterrupt(digitalPinToInterrupt(TOUCH_INT), frame_touch, FALLING);
+    frame_data->update = false;
+    frame_data->frames_per_second = 0;
+    frame_data->wakeups_per_second = 0;
+    frame_data->idle = 0;
+    frame_data->frame_time = 0;
+    frame_data->frame_time_max = 0;
+}
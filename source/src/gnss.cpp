@@ -29,217 +29,73 @@
 #include <M5Core2.h>
 #include <esp_task_wdt.h>
 #include <SparkFun_u-blox_GNSS_v3.h>
-#include <BluetoothSerial.h>
 #include "gnss.h"
 #include "real_time_clock.h"
 #include "bluetooth_serial.h"
+#include "assist_now_offline.h"
+#include "navigation_database.h"
+#include "gnss_aiding.h"
+#include "uart_reader.h"
+#include "output.h"
+#include "nmea_format.h"
+#include "sd_card.h"
+#include "bus.h"
 
-portMUX_TYPE gnss_taskmux = portMUX_INITIALIZER_UNLOCKED;
 SFE_UBLOX_GNSS gnss_i2c;
 SFE_UBLOX_GNSS_SERIAL gnss_serial;
-uint8_t fix_type = 0;
-bool gnss_fix_ok = false;
-bool diff_soln = false;
-uint8_t carr_soln = 0;
-uint8_t num_sv = 0;
-double g_speed = 0.0;
-double head_mot = 0.0;
-uint8_t a_status = 1;
-double lon = 0.0;
-double lat = 0.0;
-double height = 0.0;
-double p_acc = 0.0;
-double rel_pos_length = 0.0;
-double acc_length = 0.0;
-struct gnss_satellite_info gnss_satellite_info_gps_data[16];
-struct gnss_satellite_info gnss_satellite_info_galileo_data[16];
-struct gnss_satellite_info gnss_satellite_info_glonass_data[16];
-struct gnss_satellite_info gnss_satellite_info_beidou_data[16];
-struct gnss_satellite_info gnss_satellite_info_sbas_data[16];
-extern BluetoothSerial bt_serial;
+struct bus_gnss gnss_bus_data;
+struct bus_satellites gnss_bus_satellites_data;
+unsigned long gnss_start_millis = 0;
+uint8_t gnss_nmea_source = OUTPUT_SOURCE_RECEIVER;
+struct nmea_epoch gnss_nmea_epoch;
+uint32_t gnss_nmea_itow_pvt = 0;
+uint32_t gnss_nmea_itow_hp = 1;
+uint32_t gnss_nmea_itow_last = 1;
+bool gnss_nmea_satellites = false;
+extern uart_reader_stream uart_reader_gnss;
 
 /**
  * @brief Transfer data from the GNSS
- * @param [in] wlan_client_data
+ * @param [in] gnss_data
  */
 void gnss_transfer(struct gnss *gnss_data)
 {
-    static uint8_t counter1 = UINT8_MAX;
-    uint8_t counter2 = 0;
-    unsigned long curr_millis = 0;
-    static unsigned long last_millis = millis();
+    static struct bus_gnss bus_gnss_data;
+    static struct bus_satellites bus_satellites_data;
+    static uint32_t gnss_version = 0;
+    static uint32_t satellites_version = 0;
+    uint8_t counter = 0;
  
     esp_task_wdt_reset();
-    curr_millis = millis();
-    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    if (bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &gnss_version) == true)
     {
-        counter1 = 0;
-        last_millis = curr_millis;
+        gnss_data->fix_type = bus_gnss_data.fix_type;
+        gnss_data->gnss_fix_ok = bus_gnss_data.gnss_fix_ok;
+        gnss_data->diff_soln = bus_gnss_data.diff_soln;
+        gnss_data->carr_soln = bus_gnss_data.carr_soln;
+        gnss_data->num_sv = bus_gnss_data.num_sv;
+        gnss_data->g_speed = bus_gnss_data.g_speed;
+        gnss_data->head_mot = bus_gnss_data.head_mot;
+        gnss_data->a_status = bus_gnss_data.a_status;
+        gnss_data->lon = bus_gnss_data.lon;
+        gnss_data->lat = bus_gnss_data.lat;
+        gnss_data->height = bus_gnss_data.height;
+        gnss_data->p_acc = bus_gnss_data.p_acc;
+        gnss_data->rel_pos_length = bus_gnss_data.rel_pos_length;
+        gnss_data->acc_length = bus_gnss_data.acc_length;
+        gnss_data->update = true;
     }
-
-    switch (counter1)
+    if (bus_read(BUS_TOPIC_SATELLITES, &bus_satellites_data, &satellites_version) == true)
     {
-        case 0:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->fix_type = fix_type;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 1:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->gnss_fix_ok = gnss_fix_ok;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 2:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->diff_soln = diff_soln;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 3:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->carr_soln = carr_soln;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 4:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->num_sv = num_sv;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 5:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->g_speed = g_speed;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 6:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->head_mot = head_mot;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 7:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->a_status = a_status;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 8:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->lon = lon;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 9:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->lat = lat;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 10:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->height = height;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 11:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->p_acc = p_acc;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 12:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->rel_pos_length = rel_pos_length;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 13:
-        portENTER_CRITICAL(&gnss_taskmux);
-        gnss_data->acc_length = acc_length;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 14:
-        portENTER_CRITICAL(&gnss_taskmux);
-        for (counter2 = 0; counter2 < 16; counter2 = counter2 + 1)
-        {
-            gnss_data->gnss_satellite_info_gps_data[counter2].sv_id = gnss_satellite_info_gps_data[counter2].sv_id;
-            gnss_data->gnss_satellite_info_gps_data[counter2].cno = gnss_satellite_info_gps_data[counter2].cno;
-            gnss_data->gnss_satellite_info_gps_data[counter2].sv_used = gnss_satellite_info_gps_data[counter2].sv_used;
-        }
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 15:
-        portENTER_CRITICAL(&gnss_taskmux);
-        for (counter2 = 0; counter2 < 16; counter2 = counter2 + 1)
-        {
-            gnss_data->gnss_satellite_info_galileo_data[counter2].sv_id = gnss_satellite_info_galileo_data[counter2].sv_id;
-            gnss_data->gnss_satellite_info_galileo_data[counter2].cno = gnss_satellite_info_galileo_data[counter2].cno;
-            gnss_data->gnss_satellite_info_galileo_data[counter2].sv_used = gnss_satellite_info_galileo_data[counter2].sv_used;
-        }
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 16:
-        portENTER_CRITICAL(&gnss_taskmux);
-        for (counter2 = 0; counter2 < 16; counter2 = counter2 + 1)
+        for (counter = 0; counter < 16; counter = counter + 1)
         {
-            gnss_data->gnss_satellite_info_glonass_data[counter2].sv_id = gnss_satellite_info_glonass_data[counter2].sv_id;
-            gnss_data->gnss_satellite_info_glonass_data[counter2].cno = gnss_satellite_info_glonass_data[counter2].cno;
-            gnss_data->gnss_satellite_info_glonass_data[counter2].sv_used = gnss_satellite_info_glonass_data[counter2].sv_used;
+            gnss_data->gnss_satellite_info_gps_data[counter] = bus_satellites_data.gnss_satellite_info_gps_data[counter];
+            gnss_data->gnss_satellite_info_galileo_data[counter] = bus_satellites_data.gnss_satellite_info_galileo_data[counter];
+            gnss_data->gnss_satellite_info_glonass_data[counter] = bus_satellites_data.gnss_satellite_info_glonass_data[counter];
+            gnss_data->gnss_satellite_info_beidou_data[counter] = bus_satellites_data.gnss_satellite_info_beidou_data[counter];
+            gnss_data->gnss_satellite_info_sbas_data[counter] = bus_satellites_data.gnss_satellite_info_sbas_data[counter];
         }
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 17:
-        portENTER_CRITICAL(&gnss_taskmux);
-        for (counter2 = 0; counter2 < 16; counter2 = counter2 + 1)
-        {
-            gnss_data->gnss_satellite_info_beidou_data[counter2].sv_id = gnss_satellite_info_beidou_data[counter2].sv_id;
-            gnss_data->gnss_satellite_info_beidou_data[counter2].cno = gnss_satellite_info_beidou_data[counter2].cno;
-            gnss_data->gnss_satellite_info_beidou_data[counter2].sv_used = gnss_satellite_info_beidou_data[counter2].sv_used;
-        }
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
-        break;
-
-        case 18:
-        portENTER_CRITICAL(&gnss_taskmux);
-        for (counter2 = 0; counter2 < 16; counter2 = counter2 + 1)
-        {
-            gnss_data->gnss_satellite_info_sbas_data[counter2].sv_id = gnss_satellite_info_sbas_data[counter2].sv_id;
-            gnss_data->gnss_satellite_info_sbas_data[counter2].cno = gnss_satellite_info_sbas_data[counter2].cno;
-            gnss_data->gnss_satellite_info_sbas_data[counter2].sv_used = gnss_satellite_info_sbas_data[counter2].sv_used;
-        }
-        portEXIT_CRITICAL(&gnss_taskmux);
-        counter1 = counter1 + 1;
         gnss_data->update = true;
-        break;
-
-        default:
-        break;
     }
 }
 
@@ -251,70 +107,109 @@ void gnss(struct gnss *gnss_data)
 {
     uint8_t counter1 = 0;
     uint8_t counter2 = 0;
+    bool changed = false;
 
     esp_task_wdt_reset();
     if (gnss_i2c.getPVT() == true)
     {
-        portENTER_CRITICAL(&gnss_taskmux);
-        fix_type = gnss_i2c.packetUBXNAVPVT->data.fixType;
-        gnss_fix_ok = (bool)gnss_i2c.packetUBXNAVPVT->data.flags.bits.gnssFixOK;
-        diff_soln = (bool)gnss_i2c.packetUBXNAVPVT->data.flags.bits.diffSoln;
-        carr_soln = gnss_i2c.packetUBXNAVPVT->data.flags.bits.carrSoln;
-        num_sv = gnss_i2c.packetUBXNAVPVT->data.numSV;
-        g_speed = (double)gnss_i2c.packetUBXNAVPVT->data.gSpeed * 1E-3;
-        head_mot = (double)gnss_i2c.packetUBXNAVPVT->data.headMot * 1E-5;
-        portEXIT_CRITICAL(&gnss_taskmux);
+        gnss_bus_data.i_tow = gnss_i2c.packetUBXNAVPVT->data.iTOW;
+        gnss_bus_data.fix_type = gnss_i2c.packetUBXNAVPVT->data.fixType;
+        gnss_bus_data.gnss_fix_ok = (bool)gnss_i2c.packetUBXNAVPVT->data.flags.bits.gnssFixOK;
+        gnss_bus_data.diff_soln = (bool)gnss_i2c.packetUBXNAVPVT->data.flags.bits.diffSoln;
+        gnss_bus_data.carr_soln = gnss_i2c.packetUBXNAVPVT->data.flags.bits.carrSoln;
+        gnss_bus_data.num_sv = gnss_i2c.packetUBXNAVPVT->data.numSV;
+        gnss_bus_data.g_speed = (double)gnss_i2c.packetUBXNAVPVT->data.gSpeed * 1E-3;
+        gnss_bus_data.head_mot = (double)gnss_i2c.packetUBXNAVPVT->data.headMot * 1E-5;
+        if (gnss_nmea_source == OUTPUT_SOURCE_UBX)
+        {
+            gnss_nmea_epoch.time_valid = (bool)gnss_i2c.packetUBXNAVPVT->data.valid.bits.validTime;
+            gnss_nmea_epoch.date_valid = (bool)gnss_i2c.packetUBXNAVPVT->data.valid.bits.validDate;
+            gnss_nmea_epoch.year = gnss_i2c.packetUBXNAVPVT->data.year;
+            gnss_nmea_epoch.month = gnss_i2c.packetUBXNAVPVT->data.month;
+            gnss_nmea_epoch.day = gnss_i2c.packetUBXNAVPVT->data.day;
+            gnss_nmea_epoch.hour = gnss_i2c.packetUBXNAVPVT->data.hour;
+            gnss_nmea_epoch.minute = gnss_i2c.packetUBXNAVPVT->data.min;
+            gnss_nmea_epoch.second = gnss_i2c.packetUBXNAVPVT->data.sec;
+            gnss_nmea_epoch.nano = gnss_i2c.packetUBXNAVPVT->data.nano;
+            gnss_nmea_epoch.fix_type = gnss_i2c.packetUBXNAVPVT->data.fixType;
+            gnss_nmea_epoch.fix_ok = (bool)gnss_i2c.packetUBXNAVPVT->data.flags.bits.gnssFixOK;
+            gnss_nmea_epoch.diff_soln = (bool)gnss_i2c.packetUBXNAVPVT->data.flags.bits.diffSoln;
+            gnss_nmea_epoch.carr_soln = gnss_i2c.packetUBXNAVPVT->data.flags.bits.carrSoln;
+            gnss_nmea_epoch.num_sv = gnss_i2c.packetUBXNAVPVT->data.numSV;
+            gnss_nmea_epoch.speed = gnss_i2c.packetUBXNAVPVT->data.gSpeed;
+            gnss_nmea_epoch.course = gnss_i2c.packetUBXNAVPVT->data.headMot;
+            gnss_nmea_epoch.pdop = gnss_i2c.packetUBXNAVPVT->data.pDOP;
+            gnss_nmea_itow_pvt = gnss_i2c.packetUBXNAVPVT->data.iTOW;
+        }
         gnss_i2c.packetUBXNAVPVT->moduleQueried.moduleQueried1.bits.all = false;
+        if ((gnss_start_millis != 0) && (gnss_i2c.packetUBXNAVPVT->data.flags.bits.gnssFixOK == 1) && (gnss_i2c.packetUBXNAVPVT->data.fixType >= 3))
+        {
+            gnss_aiding_ttff((uint32_t)(millis() - gnss_start_millis));
+            gnss_start_millis = 0;
+        }
+        changed = true;
     }
     if (gnss_i2c.getMONHW() == true)
     {
-        portENTER_CRITICAL(&gnss_taskmux);
-        a_status = gnss_i2c.packetUBXMONHW->data.aStatus;
-        portEXIT_CRITICAL(&gnss_taskmux);
+        gnss_bus_data.a_status = gnss_i2c.packetUBXMONHW->data.aStatus;
         gnss_i2c.flushMONHW();
+        changed = true;
     }
     if (gnss_i2c.getHPPOSLLH() == true)
     {
-        portENTER_CRITICAL(&gnss_taskmux);
-        lon = ((double)gnss_i2c.packetUBXNAVHPPOSLLH->data.lon + (double)gnss_i2c.packetUBXNAVHPPOSLLH->data.lonHp * 1E-2) * 1E-7;
-        lat = ((double)gnss_i2c.packetUBXNAVHPPOSLLH->data.lat + (double)gnss_i2c.packetUBXNAVHPPOSLLH->data.latHp * 1E-2) * 1E-7;
-        height = ((double)gnss_i2c.packetUBXNAVHPPOSLLH->data.height + (double)gnss_i2c.packetUBXNAVHPPOSLLH->data.heightHp * 1E-1) * 1E-3;
-        portEXIT_CRITICAL(&gnss_taskmux);
+        gnss_bus_data.i_tow_hp = gnss_i2c.packetUBXNAVHPPOSLLH->data.iTOW;
+        gnss_bus_data.lon = ((double)gnss_i2c.packetUBXNAVHPPOSLLH->data.lon + (double)gnss_i2c.packetUBXNAVHPPOSLLH->data.lonHp * 1E-2) * 1E-7;
+        gnss_bus_data.lat = ((double)gnss_i2c.packetUBXNAVHPPOSLLH->data.lat + (double)gnss_i2c.packetUBXNAVHPPOSLLH->data.latHp * 1E-2) * 1E-7;
+        gnss_bus_data.height = ((double)gnss_i2c.packetUBXNAVHPPOSLLH->data.height + (double)gnss_i2c.packetUBXNAVHPPOSLLH->data.heightHp * 1E-1) * 1E-3;
+        if (gnss_nmea_source == OUTPUT_SOURCE_UBX)
+        {
+            gnss_nmea_epoch.lat = (int64_t)gnss_i2c.packetUBXNAVHPPOSLLH->data.lat * 100 + gnss_i2c.packetUBXNAVHPPOSLLH->data.latHp;
+            gnss_nmea_epoch.lon = (int64_t)gnss_i2c.packetUBXNAVHPPOSLLH->data.lon * 100 + gnss_i2c.packetUBXNAVHPPOSLLH->data.lonHp;
+            gnss_nmea_epoch.height = gnss_i2c.packetUBXNAVHPPOSLLH->data.height * 10 + gnss_i2c.packetUBXNAVHPPOSLLH->data.heightHp;
+            gnss_nmea_epoch.height_msl = gnss_i2c.packetUBXNAVHPPOSLLH->data.hMSL * 10 + gnss_i2c.packetUBXNAVHPPOSLLH->data.hMSLHp;
+            gnss_nmea_epoch.h_acc = gnss_i2c.packetUBXNAVHPPOSLLH->data.hAcc;
+            gnss_nmea_epoch.v_acc = gnss_i2c.packetUBXNAVHPPOSLLH->data.vAcc;
+            gnss_nmea_itow_hp = gnss_i2c.packetUBXNAVHPPOSLLH->data.iTOW;
+        }
         gnss_i2c.flushHPPOSLLH();
+        changed = true;
+    }
+    if ((gnss_nmea_source == OUTPUT_SOURCE_UBX) && (gnss_i2c.getDOP() == true))
+    {
+        gnss_nmea_epoch.hdop = gnss_i2c.packetUBXNAVDOP->data.hDOP;
+        gnss_nmea_epoch.vdop = gnss_i2c.packetUBXNAVDOP->data.vDOP;
+        gnss_i2c.flushDOP();
     }
     if (gnss_i2c.getNAVHPPOSECEF() == true)
     {
-        portENTER_CRITICAL(&gnss_taskmux);
-        p_acc = (double)gnss_i2c.packetUBXNAVHPPOSECEF->data.pAcc * 1E-4;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        gnss_i2c.flushNAVHPPOSECEF(); 
+        gnss_bus_data.p_acc = (double)gnss_i2c.packetUBXNAVHPPOSECEF->data.pAcc * 1E-4;
+        gnss_i2c.flushNAVHPPOSECEF();
+        changed = true;
     }
     if(gnss_i2c.getRELPOSNED() == true)
     {
-        portENTER_CRITICAL(&gnss_taskmux);
-        rel_pos_length = ((double)gnss_i2c.packetUBXNAVRELPOSNED->data.relPosLength + (double)gnss_i2c.packetUBXNAVRELPOSNED->data.relPosHPLength * 1E-2) * 1E-2;
-        acc_length = (double)gnss_i2c.packetUBXNAVRELPOSNED->data.accLength * 1E-4;
-        portEXIT_CRITICAL(&gnss_taskmux);
+        gnss_bus_data.rel_pos_length = ((double)gnss_i2c.packetUBXNAVRELPOSNED->data.relPosLength + (double)gnss_i2c.packetUBXNAVRELPOSNED->data.relPosHPLength * 1E-2) * 1E-2;
+        gnss_bus_data.acc_length = (double)gnss_i2c.packetUBXNAVRELPOSNED->data.accLength * 1E-4;
         gnss_i2c.flushNAVRELPOSNED();
+        changed = true;
     } 
     if (gnss_i2c.getNAVSAT() == true)
     {
-        portENTER_CRITICAL(&gnss_taskmux);
         counter1 = 0;
         for (counter2 = 0; counter2 < gnss_i2c.packetUBXNAVSAT->data.header.numSvs; counter2 = counter2 + 1)
         {
             if (gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].gnssId == 0)
             {
-                gnss_satellite_info_gps_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
-                gnss_satellite_info_gps_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
-                gnss_satellite_info_gps_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
+                gnss_bus_satellites_data.gnss_satellite_info_gps_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
+                gnss_bus_satellites_data.gnss_satellite_info_gps_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
+                gnss_bus_satellites_data.gnss_satellite_info_gps_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
                 counter1 = counter1 + 1;
                 if (counter1 >= 16) break;
             }
         }
         while (counter1 < 16)
         {
-            gnss_satellite_info_gps_data[counter1].sv_id = 0;
+            gnss_bus_satellites_data.gnss_satellite_info_gps_data[counter1].sv_id = 0;
             counter1 = counter1 + 1;
         } 
         counter1 = 0;
@@ -322,16 +217,16 @@ void gnss(struct gnss *gnss_data)
         {
             if (gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].gnssId == 2)
             {
-                gnss_satellite_info_galileo_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
-                gnss_satellite_info_galileo_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
-                gnss_satellite_info_galileo_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
+                gnss_bus_satellites_data.gnss_satellite_info_galileo_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
+                gnss_bus_satellites_data.gnss_satellite_info_galileo_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
+                gnss_bus_satellites_data.gnss_satellite_info_galileo_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
                 counter1 = counter1 + 1;
                 if (counter1 >= 16) break;
             }
         }
         while (counter1 < 16)
         {
-            gnss_satellite_info_galileo_data[counter1].sv_id = 0;
+            gnss_bus_satellites_data.gnss_satellite_info_galileo_data[counter1].sv_id = 0;
             counter1 = counter1 + 1;
         }
         counter1 = 0;
@@ -339,16 +234,16 @@ void gnss(struct gnss *gnss_data)
         {
             if (gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].gnssId == 6)
             {
-                gnss_satellite_info_glonass_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
-                gnss_satellite_info_glonass_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
-                gnss_satellite_info_glonass_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
+                gnss_bus_satellites_data.gnss_satellite_info_glonass_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
+                gnss_bus_satellites_data.gnss_satellite_info_glonass_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
+                gnss_bus_satellites_data.gnss_satellite_info_glonass_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
                 counter1 = counter1 + 1;
                 if (counter1 >= 16) break;
             }
         }
         while (counter1 < 16)
         {
-            gnss_satellite_info_glonass_data[counter1].sv_id = 0;
+            gnss_bus_satellites_data.gnss_satellite_info_glonass_data[counter1].sv_id = 0;
             counter1 = counter1 + 1;
         }
         counter1 = 0;
@@ -356,16 +251,16 @@ void gnss(struct gnss *gnss_data)
         {
             if (gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].gnssId == 3)
             {
-                gnss_satellite_info_beidou_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
-                gnss_satellite_info_beidou_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
-                gnss_satellite_info_beidou_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
+                gnss_bus_satellites_data.gnss_satellite_info_beidou_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
+                gnss_bus_satellites_data.gnss_satellite_info_beidou_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
+                gnss_bus_satellites_data.gnss_satellite_info_beidou_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
                 counter1 = counter1 + 1;
                 if (counter1 >= 16) break;
             }
         }
         while (counter1 < 16)
         {
-            gnss_satellite_info_beidou_data[counter1].sv_id = 0;
+            gnss_bus_satellites_data.gnss_satellite_info_beidou_data[counter1].sv_id = 0;
             counter1 = counter1 + 1;
         }
         counter1 = 0;
@@ -373,45 +268,73 @@ void gnss(struct gnss *gnss_data)
         {
             if (gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].gnssId == 1)
             {
-                gnss_satellite_info_sbas_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
-                gnss_satellite_info_sbas_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
-                gnss_satellite_info_sbas_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
+                gnss_bus_satellites_data.gnss_satellite_info_sbas_data[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
+                gnss_bus_satellites_data.gnss_satellite_info_sbas_data[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
+                gnss_bus_satellites_data.gnss_satellite_info_sbas_data[counter1].sv_used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
                 counter1 = counter1 + 1;
                 if (counter1 >= 16) break;
             }
         }
         while (counter1 < 16)
         {
-            gnss_satellite_info_sbas_data[counter1].sv_id = 0;
+            gnss_bus_satellites_data.gnss_satellite_info_sbas_data[counter1].sv_id = 0;
             counter1 = counter1 + 1;
         }
-        portEXIT_CRITICAL(&gnss_taskmux);
+        bus_publish(BUS_TOPIC_SATELLITES, &gnss_bus_satellites_data);
+        if (gnss_nmea_source == OUTPUT_SOURCE_UBX)
+        {
+            counter1 = 0;
+            for (counter2 = 0; (counter2 < gnss_i2c.packetUBXNAVSAT->data.header.numSvs) && (counter1 < NMEA_FORMAT_SATELLITES); counter2 = counter2 + 1)
+            {
+                gnss_nmea_epoch.satellite[counter1].gnss_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].gnssId;
+                gnss_nmea_epoch.satellite[counter1].sv_id = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].svId;
+                gnss_nmea_epoch.satellite[counter1].elevation = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].elev;
+                gnss_nmea_epoch.satellite[counter1].azimuth = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].azim;
+                gnss_nmea_epoch.satellite[counter1].cno = gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].cno;
+                gnss_nmea_epoch.satellite[counter1].used = (bool)gnss_i2c.packetUBXNAVSAT->data.blocks[counter2].flags.bits.svUsed;
+                counter1 = counter1 + 1;
+            }
+            gnss_nmea_epoch.satellites = counter1;
+            gnss_nmea_satellites = true;
+        }
         gnss_i2c.flushNAVSAT();
     }
+    if (changed == true) bus_publish(BUS_TOPIC_GNSS, &gnss_bus_data);
+    if ((gnss_nmea_source == OUTPUT_SOURCE_UBX) && (gnss_nmea_itow_pvt == gnss_nmea_itow_hp) && (gnss_nmea_itow_pvt != gnss_nmea_itow_last))
+    {
+        output_nmea(&gnss_nmea_epoch, gnss_nmea_satellites);
+        gnss_nmea_satellites = false;
+        gnss_nmea_itow_last = gnss_nmea_itow_pvt;
+    }
 }
 
 /**
  * @brief Initialize the GNSS
- * @param [in] gnss_data
+ * @param [in] gnss_data, sd_card_config2_data
  * @return error
  */
-bool gnss_init(struct gnss *gnss_data)
+bool gnss_init(struct gnss *gnss_data, struct sd_card_config2 *sd_card_config2_data)
 {
     bool error = false;
     uint8_t counter = 0;
 
     esp_task_wdt_reset();
-    Serial2.begin(115200);
-    Serial2.flush();
+    gnss_nmea_source = sd_card_config2_data->nmea_source;
+    memset(&gnss_bus_data, 0, sizeof(gnss_bus_data));
+    memset(&gnss_bus_satellites_data, 0, sizeof(gnss_bus_satellites_data));
+    gnss_bus_data.a_status = 1;
+    memset(&gnss_nmea_epoch, 0, sizeof(gnss_nmea_epoch));
     pinMode(GNSS_EN, OUTPUT);
     digitalWrite(GNSS_EN, LOW);
     delay(500);
     digitalWrite(GNSS_EN, HIGH);
+    gnss_start_millis = millis();
     delay(1000);
     if (Wire.setClock(400000) == true)
     {
         if (gnss_i2c.begin(Wire, kUBLOXGNSSDefaultAddress) == true)
         {
+            if (gnss_aiding_init() == false) Serial.print(F("Time and position aiding injected... "));
             error = !gnss_i2c.setI2COutput(COM_TYPE_UBX);
             if (error == false) error = !gnss_i2c.setI2COutput(COM_TYPE_UBX);
             if (error == false) error = !gnss_i2c.setI2CInput(COM_TYPE_UBX);
@@ -431,24 +354,30 @@ bool gnss_init(struct gnss *gnss_data)
             if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_HW_ANT_CFG_SHORTDET, 1);            //Enable short antenna detection flag
             if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_HW_ANT_CFG_OPENDET, 1);             //Enable open antenna detection flag
             if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_HW_ANT_CFG_VOLTCTRL, 1);            //Enable active antenna voltage control flag
-            if (error == false) error = !gnss_serial.begin(Serial2);
-            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GGA_UART1, 1);
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_NAVSPG_ACKAIDING, 1);               //Acknowledge assistance messages with MGA-ACK
+            if (error == false) error = !gnss_serial.begin(uart_reader_gnss);
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GGA_UART1, (gnss_nmea_source == OUTPUT_SOURCE_RECEIVER) ? 1 : 0);
             if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GLL_UART1, 0);
-            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GSA_UART1, 1);
-            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GST_UART1, 1);
-            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GSV_UART1, 1);
-            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_RMC_UART1, 1);
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GSA_UART1, (gnss_nmea_source == OUTPUT_SOURCE_RECEIVER) ? 1 : 0);
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GST_UART1, (gnss_nmea_source == OUTPUT_SOURCE_RECEIVER) ? 1 : 0);
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_GSV_UART1, (gnss_nmea_source == OUTPUT_SOURCE_RECEIVER) ? 1 : 0);
+            if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_RMC_UART1, (gnss_nmea_source == OUTPUT_SOURCE_RECEIVER) ? 1 : 0);
             if (error == false) error = !gnss_i2c.setVal8(UBLOX_CFG_MSGOUT_NMEA_ID_VTG_UART1, 0);
             if (error == false) error = !gnss_i2c.setHighPrecisionMode(true); 
             if (error == false) error = !gnss_i2c.setPacketCfgPayloadSize(UBX_NAV_SAT_MAX_LEN); 
-            if (error == false) error = !gnss_i2c.setNavigationFrequency(1);          
+            if (error == false) error = !gnss_i2c.setNavigationFrequency(sd_card_config2_data->nmea_rate);
             if (error == false) error = !gnss_i2c.setAutoPVT(true);
             if (error == false) error = !gnss_i2c.setAutoMONHW(true);
             if (error == false) error = !gnss_i2c.setAutoHPPOSLLH(true);
             if (error == false) error = !gnss_i2c.setAutoNAVHPPOSECEF(true);
-            if (error == false) error = !gnss_i2c.setAutoNAVSAT(true);
+            if (error == false) error = !gnss_i2c.setAutoNAVSATrate(sd_card_config2_data->nmea_rate);
+            if ((error == false) && (gnss_nmea_source == OUTPUT_SOURCE_UBX)) error = !gnss_i2c.setAutoDOP(true);
             if (error == false) error = !gnss_i2c.setAutoRELPOSNED(true);
-            gnss_serial.setNMEAOutputPort(bt_serial);
+            if (error == false)
+            {
+                if (navigation_database_restore() == false) Serial.print(F("Navigation database restored... "));
+                if (assist_now_offline_inject() == false) Serial.print(F("AssistNow Offline injected... "));
+            }
         }
         else error = true;
     }
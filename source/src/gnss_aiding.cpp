@@ -0,0 +1,177 @@
+/**
+ * @file gnss_aiding.cpp
+ *
+ * @brief GNSS aiding related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <SparkFun_u-blox_GNSS_v3.h>
+#include <Preferences.h>
+#include <time.h>
+#include "gnss_aiding.h"
+#include "navigation_database.h"
+#include "sd_card.h"
+#include "bus.h"
+
+Preferences gnss_aiding_preferences;
+bool gnss_aiding_time = false;
+char gnss_aiding_source[8] = "none";
+extern SFE_UBLOX_GNSS gnss_i2c;
+extern uint16_t assist_now_offline_messages;
+
+/**
+ * @brief Log the time to first fix together with the used aiding
+ * @param [in] ttff
+ */
+void gnss_aiding_ttff(uint32_t ttff)
+{
+    bool header = false;
+    File datafile;
+
+    esp_task_wdt_reset();
+    Serial.printf("Time to first fix %lu ms (time aiding %s, position aiding %s, %u AssistNow Offline messages)... ok\n", (unsigned long)ttff, (gnss_aiding_time == true) ? "RTC" : "none", gnss_aiding_source, assist_now_offline_messages);
+    header = !SD.exists(GNSS_AIDING_TTFF);
+    datafile = SD.open(GNSS_AIDING_TTFF, FILE_APPEND);
+    if (datafile)
+    {
+        if (header == true) datafile.print("timestamp,ttff_ms,time_aiding,position_aiding,ano_messages\n");
+        datafile.printf("%lu,%lu,%s,%s,%u\n", (unsigned long)time(NULL), (unsigned long)ttff, (gnss_aiding_time == true) ? "rtc" : "none", gnss_aiding_source, assist_now_offline_messages);
+        datafile.close();
+    }
+}
+
+/**
+ * @brief Save the last fix into the NVS
+ * @return error
+ */
+bool gnss_aiding_save(void)
+{
+    bool error = false;
+    struct gnss_aiding_position gnss_aiding_position_data;
+    struct bus_gnss bus_gnss_data;
+    uint32_t version = 0;
+
+    esp_task_wdt_reset();
+    bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version);
+    gnss_aiding_position_data.lat = (int32_t)(bus_gnss_data.lat * 1E7);
+    gnss_aiding_position_data.lon = (int32_t)(bus_gnss_data.lon * 1E7);
+    gnss_aiding_position_data.height = (int32_t)(bus_gnss_data.height * 1E2);
+    gnss_aiding_position_data.acc = (uint32_t)(bus_gnss_data.p_acc * 1E2);
+    if (gnss_aiding_preferences.begin(GNSS_AIDING_NAMESPACE, false) == true)
+    {
+        if (gnss_aiding_preferences.putBytes(GNSS_AIDING_KEY_POSITION, &gnss_aiding_position_data, sizeof(gnss_aiding_position_data)) != sizeof(gnss_aiding_position_data)) error = true;
+        gnss_aiding_preferences.end();
+    }
+    else error = true;
+
+    return error;
+}
+
+/**
+ * @brief Save the last fix periodically
+ */
+void gnss_aiding(void)
+{
+    bool fix_ok = false;
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = (unsigned long)(millis() - GNSS_AIDING_PERIOD + 60000);
+    struct bus_gnss bus_gnss_data;
+    uint32_t version = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > GNSS_AIDING_PERIOD)
+    {
+        bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version);
+        fix_ok = (bus_gnss_data.gnss_fix_ok == true) && (bus_gnss_data.fix_type >= 3);
+        if (fix_ok == true)
+        {
+            gnss_aiding_save();
+            last_millis = curr_millis;
+        }
+    }
+}
+
+/**
+ * @brief Inject the RTC time and the last fix into the GNSS
+ * @return error
+ */
+bool gnss_aiding_init(void)
+{
+    bool error = false;
+    int length = 0;
+    double position_lon = 0.0;
+    double position_lat = 0.0;
+    double position_height = 0.0;
+    double position_acc = 0.0;
+    char string[96];
+    time_t timestamp = (time_t)0;
+    struct tm timestamp_data;
+    struct gnss_aiding_position gnss_aiding_position_data;
+    File datafile;
+
+    esp_task_wdt_reset();
+    gnss_aiding_time = false;
+    strcpy(gnss_aiding_source, "none");
+    time(&timestamp);
+    gmtime_r(&timestamp, &timestamp_data);
+    if (timestamp_data.tm_year < 123) return true;                                                   //RTC not set
+    gnss_aiding_time = gnss_i2c.setUTCTimeAssistance(timestamp_data.tm_year + 1900, timestamp_data.tm_mon + 1, timestamp_data.tm_mday, timestamp_data.tm_hour, timestamp_data.tm_min, timestamp_data.tm_sec, 0, 2, 0);
+    if (gnss_aiding_time == false) return true;
+
+    if (gnss_aiding_preferences.begin(GNSS_AIDING_NAMESPACE, true) == true)
+    {
+        if (gnss_aiding_preferences.getBytes(GNSS_AIDING_KEY_POSITION, &gnss_aiding_position_data, sizeof(gnss_aiding_position_data)) == sizeof(gnss_aiding_position_data)) strcpy(gnss_aiding_source, "nvs");
+        gnss_aiding_preferences.end();
+    }
+    if (strcmp(gnss_aiding_source, "none") == 0)
+    {
+        datafile = SD.open(NAVIGATION_DATABASE_POSITION, FILE_READ);
+        if (datafile)
+        {
+            length = datafile.readBytesUntil('\n', string, sizeof(string) - 1);
+            string[length] = '\0';
+            datafile.close();
+            if (sscanf(string, "%lf %lf %lf %lf", &position_lat, &position_lon, &position_height, &position_acc) == 4)
+            {
+                gnss_aiding_position_data.lat = (int32_t)(position_lat * 1E7);
+                gnss_aiding_position_data.lon = (int32_t)(position_lon * 1E7);
+                gnss_aiding_position_data.height = (int32_t)(position_height * 1E2);
+                gnss_aiding_position_data.acc = (uint32_t)(position_acc * 1E2);
+                strcpy(gnss_aiding_source, "sd");
+            }
+        }
+    }
+    if (strcmp(gnss_aiding_source, "none") != 0)
+    {
+        if (gnss_aiding_position_data.acc < GNSS_AIDING_POSITION_ACC_MIN * 100) gnss_aiding_position_data.acc = GNSS_AIDING_POSITION_ACC_MIN * 100;   //The GNSS may have been moved while switched off
+        error = !gnss_i2c.setPositionAssistanceLLH(gnss_aiding_position_data.lat, gnss_aiding_position_data.lon, gnss_aiding_position_data.height, gnss_aiding_position_data.acc);
+        if (error == true) strcpy(gnss_aiding_source, "none");
+    }
+
+    return error;
+}
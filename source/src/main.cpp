@@ -44,36 +44,124 @@
 #include "tough.h"
 #include "gnss.h"
 #include "bluetooth_serial.h"
+#include "bluetooth_le.h"
 #include "wlan_client.h"
 #include "assist_now_client.h"
+#include "assist_now_offline.h"
 #include "ntrip_client.h"
+#include "correction.h"
+#include "ntrip_caster.h"
+#include "base_station.h"
+#include "navigation_database.h"
+#include "gnss_aiding.h"
+#include "benchmark.h"
+#include "rtcm_replay.h"
+#include "uart_reader.h"
+#include "output.h"
+#include "nmea_server.h"
+#include "ubx_bridge.h"
+#include "frame.h"
+#include "bus.h"
+#include "task_load.h"
+#include "diagnostics.h"
+#include "power.h"
 #include "page.h"
 #include "led_bar.h"
 
 TaskHandle_t subtask1_handle = NULL;
 TaskHandle_t subtask2_handle = NULL;
-portMUX_TYPE subtask2_taskmux = portMUX_INITIALIZER_UNLOCKED;
-struct sd_card_config1 *sd_card_config1_data;
-struct sd_card_config2 *sd_card_config2_data;
-struct real_time_clock *real_time_clock_data;
-struct battery *battery_data;
-struct gnss *gnss_data;
-struct bluetooth_serial *bluetooth_serial_data;
-struct wlan_client *wlan_client_data;
-struct assist_now_client *assist_now_client_data;
-struct ntrip_client *ntrip_client_data;
-bool wlan_client_active = false;
-bool assist_now_client_active = false;
-bool ntrip_client_active = false;
+TaskHandle_t subtask3_handle = NULL;
+TaskHandle_t subtask4_handle = NULL;
+TaskHandle_t subtask5_handle = NULL;
+uint8_t task_job_state[TASK_JOBS] = {TASK_JOB_IDLE, TASK_JOB_IDLE, TASK_JOB_IDLE, TASK_JOB_IDLE};
+bool task_job_error[TASK_JOBS] = {true, true, true, true};
+struct sd_card_config1 sd_card_config1_storage;
+struct sd_card_config1 *sd_card_config1_data = &sd_card_config1_storage;
+struct sd_card_config2 sd_card_config2_storage;
+struct sd_card_config2 *sd_card_config2_data = &sd_card_config2_storage;
+struct real_time_clock real_time_clock_storage;
+struct real_time_clock *real_time_clock_data = &real_time_clock_storage;
+struct battery battery_storage;
+struct battery *battery_data = &battery_storage;
+struct gnss gnss_storage;
+struct gnss *gnss_data = &gnss_storage;
+struct bluetooth_serial bluetooth_serial_storage;
+struct bluetooth_serial *bluetooth_serial_data = &bluetooth_serial_storage;
+struct bluetooth_le bluetooth_le_storage;
+struct bluetooth_le *bluetooth_le_data = &bluetooth_le_storage;
+struct wlan_client wlan_client_storage;
+struct wlan_client *wlan_client_data = &wlan_client_storage;
+struct assist_now_client assist_now_client_storage;
+struct assist_now_client *assist_now_client_data = &assist_now_client_storage;
+struct ntrip_client ntrip_client_storage;
+struct ntrip_client *ntrip_client_data = &ntrip_client_storage;
+struct correction correction_storage;
+struct correction *correction_data = &correction_storage;
+struct base_station base_station_storage;
+struct base_station *base_station_data = &base_station_storage;
+struct uart_reader uart_reader_storage;
+struct uart_reader *uart_reader_data = &uart_reader_storage;
+struct output output_storage;
+struct output *output_data = &output_storage;
+struct nmea_server nmea_server_storage;
+struct nmea_server *nmea_server_data = &nmea_server_storage;
+struct ubx_bridge ubx_bridge_storage;
+struct ubx_bridge *ubx_bridge_data = &ubx_bridge_storage;
+struct frame frame_storage;
+struct frame *frame_data = &frame_storage;
+struct task_load task_load_storage;
+struct task_load *task_load_data = &task_load_storage;
+struct diagnostics diagnostics_storage;
+struct diagnostics *diagnostics_data = &diagnostics_storage;
+struct power power_storage;
+struct power *power_data = &power_storage;
 extern int button;
 
+/**
+ * @brief Get the core of a task from the config
+ * @param [in] core
+ * @return core id or no affinity
+ */
+BaseType_t task_core(uint8_t core)
+{
+    if (core == TASK_CORE_ANY) return tskNO_AFFINITY;
+    return (BaseType_t)core;
+}
+
+/**
+ * @brief Queue a blocking connection job for subtask 5
+ * @param [in] job
+ * @return error (the job is still running)
+ */
+bool task_job_start(uint8_t job)
+{
+    if (__atomic_load_n(&task_job_state[job], __ATOMIC_ACQUIRE) != TASK_JOB_IDLE) return true;
+    __atomic_store_n(&task_job_state[job], TASK_JOB_QUEUED, __ATOMIC_RELEASE);
+    xTaskNotifyGive(subtask5_handle);
+
+    return false;
+}
+
+/**
+ * @brief Collect the result of a connection job
+ * @param [in] job
+ * @param [out] error (result of the job)
+ * @return job done
+ */
+bool task_job_done(uint8_t job, bool *error)
+{
+    if (__atomic_load_n(&task_job_state[job], __ATOMIC_ACQUIRE) != TASK_JOB_DONE) return false;
+    *error = task_job_error[job];
+    __atomic_store_n(&task_job_state[job], TASK_JOB_IDLE, __ATOMIC_RELEASE);
+
+    return true;
+}
+
 /**
  * @brief setup program
  */
 void setup(void)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
-
     M5.begin(true, true, true, true, kMBusModeOutput);
     Serial.print(F("ZED-F9P V1.0 startup... ok\n"));
     Serial.print(F("Initialize watchdog... "));
@@ -83,6 +171,9 @@ void setup(void)
         else Serial.print(F("failed\n"));
     }
     else Serial.print(F("failed\n"));
+    Serial.print(F("Initialize page sprite... "));
+    if (page_init() == true) Serial.print(F("failed\n"));
+    else Serial.print(F("ok\n"));
     Serial.print(F("Check SD card for startup picture... "));
     if (sd_card_check_startup() == true)
     {
@@ -92,10 +183,7 @@ void setup(void)
     else
     {
         Serial.print(F("ok\n"));
-        tft.createSprite(320, 240);
-        tft.drawJpgFile(SD, "/icons/startup.jpg");
-        tft.pushSprite(0, 0);
-        tft.deleteSprite();
+        page_startup();
     }
     Serial.print(F("Check SD card... "));
     if (sd_card_check() == true)
@@ -105,8 +193,6 @@ void setup(void)
     }
     else Serial.print(F("ok\n"));
     Serial.print(F("Read config file... "));
-    sd_card_config1_data = (struct sd_card_config1 *)malloc(sizeof(struct sd_card_config1));
-    sd_card_config2_data = (struct sd_card_config2 *)malloc(sizeof(struct sd_card_config2));
     if (sd_card_config_read(sd_card_config1_data, sd_card_config2_data) == true)
     {
         Serial.print(F("failed\n"));
@@ -114,53 +200,130 @@ void setup(void)
     }
     else Serial.print(F("ok\n"));
     Serial.print(F("Initialize real time clock... ok\n"));
-    real_time_clock_data = (struct real_time_clock *)malloc(sizeof(struct real_time_clock));
     real_time_clock_init(real_time_clock_data, sd_card_config1_data);
     Serial.print(F("Initialize battery... ok\n"));
-    battery_data = (struct battery *)malloc(sizeof(struct battery));
     battery_init(battery_data);
     Serial.print(F("Initialize display... ok\n"));
     display_init(sd_card_config1_data);
     Serial.print(F("Initialize touch... ok\n"));
     touch_init();
+    Serial.print(F("Initialize power management... "));
+    if (power_init(power_data, sd_card_config2_data) == true) Serial.print(F("failed\n"));
+    else Serial.print(F("ok\n"));
+    Serial.print(F("Initialize data bus... ok\n"));
+    bus_init();
+    Serial.print(F("Initialize frame pacing... ok\n"));
+    frame_init(frame_data);
+    bus_subscribe(BUS_TOPIC_GNSS, xTaskGetCurrentTaskHandle());
+    bus_subscribe(BUS_TOPIC_SATELLITES, xTaskGetCurrentTaskHandle());
+    bus_subscribe(BUS_TOPIC_LINK, xTaskGetCurrentTaskHandle());
+    Serial.print(F("Initialize navigation database... "));
+    if (navigation_database_init() == true) Serial.print(F("failed\n"));
+    else Serial.print(F("ok\n"));
+    if (sd_card_config2_data->ntrip_caster_enable == 1)
+    {
+        Serial.print(F("Allocate NTRIP caster buffers... "));
+        if (ntrip_caster_reserve() == true) Serial.print(F("failed\n"));
+        else Serial.print(F("ok\n"));
+    }
+    if (sd_card_config2_data->ubx_bridge_enable == 1)
+    {
+        Serial.print(F("Allocate UBX bridge buffer... "));
+        if (ubx_bridge_reserve() == true) Serial.print(F("failed\n"));
+        else Serial.print(F("ok\n"));
+    }
+    Serial.print(F("Initialize UART reader... ok\n"));
+    uart_reader_init(uart_reader_data);
+    Serial.print(F("Initialize output hub... "));
+    if (output_init(output_data, sd_card_config2_data) == true) Serial.print(F("failed\n"));
+    else Serial.print(F("ok\n"));
+    Serial.print(F("Initialize task load... ok\n"));
+    task_load_init(task_load_data);
+    Serial.print(F("Initialize diagnostics... ok\n"));
+    diagnostics_init(diagnostics_data, sd_card_config2_data);
+    diagnostics_task(TASK_LOAD_UI, xTaskGetCurrentTaskHandle(), getArduinoLoopTaskStackSize());
+    vTaskPrioritySet(NULL, TASK_PRIORITY_UI);
+    Serial.print(F("Starting subtask 3... "));
+    if (xTaskCreatePinnedToCore(subtask3, "SUBTASK3", TASK_STACK_UART, NULL, TASK_PRIORITY_UART, &subtask3_handle, task_core(sd_card_config2_data->task_uart_core)) == 0)
+    {
+        Serial.print(F("failed\n"));
+        page_error(4);
+    }
+    else Serial.print(F("ok\n"));
+    Serial.print(F("Initialize benchmark... ok\n"));
+    benchmark_init(sd_card_config2_data);
     Serial.print(F("Initialize GNSS... "));
-    gnss_data = (struct gnss *)malloc(sizeof(struct gnss));
-    if (gnss_init(gnss_data) == true)
+    if (gnss_init(gnss_data, sd_card_config2_data) == true)
+    {
+        Serial.print(F("failed\n"));
+        page_error(2);
+    }
+    else Serial.print(F("ok\n"));
+    if (benchmark_reset() == true) Serial.print(F("Reset GNSS for benchmark... failed\n"));
+    benchmark_milestone(BENCHMARK_RECEIVER_UP);
+    Serial.print(F("Initialize base station... "));
+    if (base_station_init(base_station_data, sd_card_config2_data) == true)
     {
         Serial.print(F("failed\n"));
         page_error(2);
     }
     else Serial.print(F("ok\n"));
     Serial.print(F("Initialize Bluetooth serial... "));
-    bluetooth_serial_data = (struct bluetooth_serial *)malloc(sizeof(struct bluetooth_serial));
-    if (bluetooth_serial_init(bluetooth_serial_data) == true)
+    if (bluetooth_serial_init(bluetooth_serial_data, sd_card_config2_data) == true)
     {
         Serial.print(F("failed\n"));
         page_error(3);
     }
     else Serial.print(F("ok\n"));
+    bluetooth_le_data->active = false;
+    if (sd_card_config2_data->bluetooth_le_enable == 1)
+    {
+        Serial.print(F("Initialize Bluetooth LE... "));
+        if (bluetooth_le_init(bluetooth_le_data, sd_card_config2_data) == true) Serial.print(F("failed\n"));
+        else Serial.print(F("ok\n"));
+    }
     Serial.print(F("Initialize led bar... ok\n"));
     led_bar_init();
     Serial.print(F("Starting subtask 1... "));
-    if (xTaskCreatePinnedToCore(subtask1, "SUBTASK1", 5000, NULL, 1, &subtask1_handle, 1) == 0)
+    if (xTaskCreatePinnedToCore(subtask1, "SUBTASK1", TASK_STACK_GNSS, NULL, TASK_PRIORITY_GNSS, &subtask1_handle, task_core(sd_card_config2_data->task_gnss_core)) == 0)
+    {
+        Serial.print(F("failed\n"));
+        page_error(4);
+    }
+    else Serial.print(F("ok\n"));
+    Serial.print(F("Starting subtask 5... "));
+    if (xTaskCreatePinnedToCore(subtask5, "SUBTASK5", TASK_STACK_CONNECT, NULL, TASK_PRIORITY_CONNECT, &subtask5_handle, task_core(sd_card_config2_data->task_network_core)) == 0)
     {
         Serial.print(F("failed\n"));
         page_error(4);
     }
     else Serial.print(F("ok\n"));
     Serial.print(F("Starting subtask 2... "));
-    wlan_client_data = (struct wlan_client *)malloc(sizeof(struct wlan_client));
     wlan_client_data->active = false;
-    assist_now_client_data = (struct assist_now_client *)malloc(sizeof(struct assist_now_client));
-    assist_now_client_data->active = false;
-    ntrip_client_data = (struct ntrip_client *)malloc(sizeof(struct ntrip_client));
+    assist_now_client_init(assist_now_client_data);
     ntrip_client_data->active = false;
-    if (xTaskCreatePinnedToCore(subtask2, "SUBTASK2", 10000, NULL, 1, &subtask2_handle, 1) == 0)
+    correction_init(correction_data);
+    nmea_server_data->clients = 0;
+    ubx_bridge_data->active = false;
+    if (xTaskCreatePinnedToCore(subtask2, "SUBTASK2", TASK_STACK_NETWORK, NULL, TASK_PRIORITY_NETWORK, &subtask2_handle, task_core(sd_card_config2_data->task_network_core)) == 0)
+    {
+        Serial.print(F("failed\n"));
+        page_error(4);
+    }
+    else Serial.print(F("ok\n"));
+    Serial.print(F("Starting subtask 4... "));
+    if (xTaskCreatePinnedToCore(subtask4, "SUBTASK4", TASK_STACK_BLUETOOTH, NULL, TASK_PRIORITY_BLUETOOTH, &subtask4_handle, task_core(sd_card_config2_data->task_network_core)) == 0)
     {
         Serial.print(F("failed\n"));
         page_error(4);
     }
     else Serial.print(F("ok\n"));
+    diagnostics_task(TASK_LOAD_UART, subtask3_handle, TASK_STACK_UART);
+    diagnostics_task(TASK_LOAD_GNSS, subtask1_handle, TASK_STACK_GNSS);
+    diagnostics_task(TASK_LOAD_NETWORK, subtask2_handle, TASK_STACK_NETWORK);
+    diagnostics_task(TASK_LOAD_BLUETOOTH, subtask4_handle, TASK_STACK_BLUETOOTH);
+    diagnostics_task(TASK_LOAD_CONNECT, subtask5_handle, TASK_STACK_CONNECT);
+    output_usb_start(sd_card_config2_data);
     M5.Spk.DingDong();
 }
 
@@ -174,16 +337,35 @@ void loop(void)
     while(1)
     {
         esp_task_wdt_reset(); 
+        task_load_end(TASK_LOAD_UI);
+        frame_wait();
+        task_load_begin(TASK_LOAD_UI);
         M5.update();
+        if (M5.Axp.GetBtnPress() == 0x01) navigation_database_shutdown();                 //Long press, a short press must not stop an unattended logger
         display_on = display_timer(sd_card_config1_data, &button);
         real_time_clock_transfer(real_time_clock_data);
         battery_transfer(battery_data);
+        power_transfer(power_data, battery_data, display_on);
         bluetooth_serial_transfer(bluetooth_serial_data);
+        bluetooth_le_transfer(bluetooth_le_data);
         wlan_client_transfer(wlan_client_data);
         assist_now_client_transfer(assist_now_client_data);
         ntrip_client_transfer(ntrip_client_data);
+        correction_transfer(correction_data);
+        base_station_transfer(base_station_data);
+        uart_reader_transfer(uart_reader_data);
+        output_transfer(output_data);
+        nmea_server_transfer(nmea_server_data);
+        ubx_bridge_transfer(ubx_bridge_data);
         gnss_transfer(gnss_data);
-        if (display_on == true) page(sd_card_config1_data, &button, real_time_clock_data, battery_data, gnss_data, bluetooth_serial_data, wlan_client_data, assist_now_client_data, ntrip_client_data);
+        frame_transfer(frame_data);
+        task_load_transfer(task_load_data);
+        diagnostics_transfer(diagnostics_data, task_load_data, frame_data);
+        if ((display_on == true) && (frame_due() == true))
+        {
+            frame_begin();
+            frame_end(page(sd_card_config1_data, &button, real_time_clock_data, battery_data, gnss_data, bluetooth_serial_data, wlan_client_data, assist_now_client_data, ntrip_client_data, correction_data, base_station_data, diagnostics_data));
+        }
     }
 }
 
@@ -199,8 +381,16 @@ void subtask1(void *parameter)
     while(1)
     {     
         esp_task_wdt_reset();
+        task_load_end(TASK_LOAD_GNSS);
+        vTaskDelay(pdMS_TO_TICKS(TASK_GNSS_PERIOD));
+        task_load_begin(TASK_LOAD_GNSS);
+        navigation_database(ubx_bridge_active());
+        if (ubx_bridge_active() == true) continue;
         curr_millis = millis();
         gnss(gnss_data);
+        base_station_survey();
+        gnss_aiding();
+        benchmark();
         if ((unsigned long)(curr_millis - last_millis) > 3600000)
         {
             if (real_time_clock_set() == false) last_millis = curr_millis;
@@ -216,73 +406,258 @@ void subtask2(void *parameter)
 { 
     bool bluetooth_serial_error = true;
     bool wlan_client_error = true;
+    bool wlan_client_error_last = true;
     bool assist_now_client_error = true;
+    bool assist_now_client_connecting = false;
     bool ntrip_client_error = true;
-    unsigned long curr_millis = 0;
-    static unsigned long last_millis = (unsigned long)(millis() - 50000);
+    bool ntrip_caster_started = false;
+    bool nmea_server_started = false;
+    bool ubx_bridge_started = false;
+    bool assist_now_offline_started = false;
+    bool base_station_error = true;
+    bool base_station_connecting = false;
+    bool ntrip_client_connecting = false;
+    bool rtcm_replay_error = true;
+    bool job_error = true;
+    struct bus_link bus_link_data = {false, false, false, false, false};
+    static unsigned long ntrip_client_millis = (unsigned long)(millis() - NTRIP_CLIENT_RETRY);
+    static unsigned long base_station_millis = (unsigned long)(millis() - 5000);
+    static unsigned long assist_now_client_millis = (unsigned long)(millis() - ASSIST_NOW_CLIENT_RETRY);
+
+    if ((sd_card_config2_data->replay_enable == 1) && (sd_card_config2_data->base_mode == BASE_STATION_MODE_OFF))
+    {
+        Serial.print(F("Initialize RTCM replay... "));
+        rtcm_replay_error = rtcm_replay_init(sd_card_config2_data);
+        if (rtcm_replay_error == true) Serial.print(F("failed\n"));
+        else Serial.print(F("ok\n"));
+    }
+
+    if ((sd_card_config2_data->ubx_bridge_enable == 1) && (sd_card_config2_data->ubx_bridge_transport == UBX_BRIDGE_TRANSPORT_BLUETOOTH))
+    {
+        Serial.print(F("Initialize UBX bridge... "));
+        ubx_bridge_started = true;
+        if (ubx_bridge_init(ubx_bridge_data, sd_card_config2_data) == true) Serial.print(F("failed\n"));
+        else Serial.print(F("ok\n"));
+    }
+
+    Serial.print(F("Initialize WLAN client... ok\n"));
+    wlan_client_init(sd_card_config2_data);
 
     while(1)
     {
         esp_task_wdt_reset();   
-        bluetooth_serial();
-        curr_millis = millis();
-        if ((unsigned long)(curr_millis - last_millis) > 60000)
+        task_load_end(TASK_LOAD_NETWORK);
+        vTaskDelay(pdMS_TO_TICKS(TASK_NETWORK_PERIOD));
+        task_load_begin(TASK_LOAD_NETWORK);
+        bluetooth_serial_error = bluetooth_serial();
+        bluetooth_le();
+        output_usb();
+        ubx_bridge();
+        assist_now_client_inject();
+        base_station();
+        if (rtcm_replay_error == false)
         {
-            if (wlan_client_error == true)
-            {
-                Serial.print(F("Initialize WLAN client... "));
-                wlan_client_error = wlan_client(sd_card_config2_data);
-                if (wlan_client_error == true) Serial.print(F("failed\n"));
-                else Serial.print(F("ok\n"));
-            }
-            last_millis = curr_millis;
+            rtcm_replay_error = rtcm_replay();
+            if (rtcm_replay_error == true) Serial.print(F("Stop RTCM replay... ok\n"));
         }
-        if (wlan_client_error == false)
+        wlan_client_error = wlan_client();
+        if ((wlan_client_error == true) && (wlan_client_error_last == false))
         {
-            wlan_client_error = wlan_client(sd_card_config2_data);
-            if (wlan_client_error == true)
-            {
-                Serial.print(F("Disconnect WLAN client... ok\n"));
-                assist_now_client_error = true;
-                ntrip_client_error = true;
-            }
+            assist_now_client_error = true;
+            ntrip_client_error = true;
+            base_station_error = true;
+            assist_now_offline_started = false;
+            assist_now_client_millis = (unsigned long)(millis() - ASSIST_NOW_CLIENT_RETRY);
+            ntrip_client_millis = (unsigned long)(millis() - NTRIP_CLIENT_RETRY);
+            base_station_millis = (unsigned long)(millis() - 5000);
         }
+        wlan_client_error_last = wlan_client_error;
 
-        portENTER_CRITICAL(&subtask2_taskmux);
-        wlan_client_active = !wlan_client_error;
-        portEXIT_CRITICAL(&subtask2_taskmux);
+        if ((bus_link_data.wlan_client_active == wlan_client_error) || (bus_link_data.bluetooth_serial_active == bluetooth_serial_error))
+        {
+            bus_link_data.wlan_client_active = !wlan_client_error;
+            bus_link_data.bluetooth_serial_active = !bluetooth_serial_error;
+            bus_publish(BUS_TOPIC_LINK, &bus_link_data);
+        }
 
         if (wlan_client_error == false)
         {
-            if (assist_now_client_error == true)
+            if (assist_now_client_connecting == true)
             {
-                Serial.print(F("Initialize AssistNow client... "));
-                assist_now_client_error = assist_now_client(sd_card_config2_data);
-                if (assist_now_client_error == true) Serial.print(F("failed\n"));
+                if (task_job_done(TASK_JOB_ASSIST_NOW, &assist_now_client_error) == true)
+                {
+                    assist_now_client_connecting = false;
+                    assist_now_client_millis = millis();
+                }
+            }
+            else if (((assist_now_client_error == true) && ((unsigned long)(millis() - assist_now_client_millis) > ASSIST_NOW_CLIENT_RETRY)) ||
+                     ((assist_now_client_error == false) && ((unsigned long)(millis() - assist_now_client_millis) > ASSIST_NOW_CLIENT_REFRESH)))
+            {
+                assist_now_client_connecting = !task_job_start(TASK_JOB_ASSIST_NOW);
+            }
+
+            if ((sd_card_config2_data->assist_now_offline_enable == 1) && (assist_now_offline_started == false))
+            {
+                if (task_job_start(TASK_JOB_ASSIST_NOW_OFFLINE) == false) assist_now_offline_started = true;
+            }
+            task_job_done(TASK_JOB_ASSIST_NOW_OFFLINE, &job_error);
+
+            if (sd_card_config2_data->base_mode != BASE_STATION_MODE_OFF)
+            {
+                if (base_station_connecting == true)
+                {
+                    if (task_job_done(TASK_JOB_NTRIP_SERVER, &base_station_error) == true)
+                    {
+                        base_station_connecting = false;
+                        base_station_millis = millis();
+                    }
+                }
+                else if ((base_station_error == true) && ((unsigned long)(millis() - base_station_millis) > 5000))
+                {
+                    base_station_connecting = !task_job_start(TASK_JOB_NTRIP_SERVER);
+                }
+                else if (base_station_error == false)
+                {
+                    base_station_error = base_station_server();
+                    if (base_station_error == true) Serial.print(F("Disconnect NTRIP server... ok\n"));
+                }
+            }
+            else if (sd_card_config2_data->replay_enable == 0)
+            {
+                if (ntrip_client_connecting == true)
+                {
+                    if (task_job_done(TASK_JOB_NTRIP_CLIENT, &ntrip_client_error) == true)
+                    {
+                        ntrip_client_connecting = false;
+                        ntrip_client_millis = millis();
+                    }
+                }
+                else if ((ntrip_client_error == true) && ((unsigned long)(millis() - ntrip_client_millis) > NTRIP_CLIENT_RETRY))
+                {
+                    ntrip_client_connecting = !task_job_start(TASK_JOB_NTRIP_CLIENT);
+                }
+                else if (ntrip_client_error == false)
+                {
+                    ntrip_client_error = ntrip_client();
+                    if (ntrip_client_error == true)
+                    {
+                        Serial.print(F("Disconnect NTRIP client... ok\n"));
+                        ntrip_client_millis = millis();
+                    }
+                }
+            }
+
+            if ((sd_card_config2_data->ntrip_caster_enable == 1) && (ntrip_caster_started == false))
+            {
+                Serial.print(F("Initialize NTRIP caster... "));
+                ntrip_caster_started = true;
+                if (ntrip_caster_init(sd_card_config2_data) == true) Serial.print(F("failed\n"));
                 else Serial.print(F("ok\n"));
+            }
+            ntrip_caster();
 
-                portENTER_CRITICAL(&subtask2_taskmux);
-                assist_now_client_active = !assist_now_client_error;
-                portEXIT_CRITICAL(&subtask2_taskmux);  
+            if ((sd_card_config2_data->output_tcp_enable == 1) && (nmea_server_started == false))
+            {
+                Serial.print(F("Initialize NMEA server... "));
+                nmea_server_started = true;
+                if (nmea_server_init(nmea_server_data, sd_card_config2_data) == true) Serial.print(F("failed\n"));
+                else Serial.print(F("ok\n"));
             }
+            nmea_server();
 
-            if (ntrip_client_error == true)
+            if ((sd_card_config2_data->ubx_bridge_enable == 1) && (ubx_bridge_started == false))
             {
-                Serial.print(F("Initialize NTRIP client... ")); 
-                ntrip_client_error = ntrip_client_init(sd_card_config2_data);
-                if (ntrip_client_error == true) Serial.print(F("failed\n"));
+                Serial.print(F("Initialize UBX bridge... "));
+                ubx_bridge_started = true;
+                if (ubx_bridge_init(ubx_bridge_data, sd_card_config2_data) == true) Serial.print(F("failed\n"));
                 else Serial.print(F("ok\n"));
             }
+        }
+        
+        if ((bus_link_data.assist_now_client_active == assist_now_client_error) || (bus_link_data.ntrip_client_active == ntrip_client_error) || (bus_link_data.base_station_server_active == base_station_error))
+        {
+            bus_link_data.assist_now_client_active = !assist_now_client_error;
+            bus_link_data.ntrip_client_active = !ntrip_client_error;
+            bus_link_data.base_station_server_active = !base_station_error;
+            bus_publish(BUS_TOPIC_LINK, &bus_link_data);
+        }
+    }
+}
+
+/**
+ * @brief Subtask 3 for draining the GNSS UART
+ * @param [in] parameter
+ */
+void subtask3(void *parameter) 
+{ 
+    while(1)
+    {
+        esp_task_wdt_reset();
+        task_load_end(TASK_LOAD_UART);
+        uart_reader_wait();
+        task_load_begin(TASK_LOAD_UART);
+        uart_reader();
+    }
+}
+
+/**
+ * @brief Subtask 4 for the Bluetooth serial output
+ * @param [in] parameter
+ */
+void subtask4(void *parameter) 
+{ 
+    while(1)
+    {
+        esp_task_wdt_reset();
+        task_load_end(TASK_LOAD_BLUETOOTH);
+        bluetooth_serial_wait();
+        task_load_begin(TASK_LOAD_BLUETOOTH);
+        bluetooth_serial_output();
+    }
+}
+
+/**
+ * @brief Subtask 5 for the blocking connection jobs of subtask 2
+ * @param [in] parameter
+ */
+void subtask5(void *parameter) 
+{ 
+    uint8_t job = 0;
+    bool error = true;
+
+    while(1)
+    {
+        esp_task_wdt_reset();
+        task_load_end(TASK_LOAD_CONNECT);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        task_load_begin(TASK_LOAD_CONNECT);
+        for (job = 0; job < TASK_JOBS; job = job + 1)
+        {
+            if (__atomic_load_n(&task_job_state[job], __ATOMIC_ACQUIRE) != TASK_JOB_QUEUED) continue;
+            if (job == TASK_JOB_NTRIP_CLIENT)
+            {
+                Serial.print(F("Initialize NTRIP client... "));
+                error = ntrip_client_init(sd_card_config2_data);
+            }
+            else if (job == TASK_JOB_NTRIP_SERVER)
+            {
+                Serial.print(F("Initialize NTRIP server... "));
+                error = base_station_server_init(sd_card_config2_data);
+            }
+            else if (job == TASK_JOB_ASSIST_NOW_OFFLINE)
+            {
+                Serial.print(F("Update AssistNow Offline cache... "));
+                error = assist_now_offline(sd_card_config2_data);
+            }
             else
             {
-                ntrip_client_error = ntrip_client();
-                if (ntrip_client_error == true) Serial.print(F("Disconnect NTRIP client... ok\n"));
+                Serial.print(F("Initialize AssistNow client... "));
+                error = assist_now_client(sd_card_config2_data);
             }
+            if (error == true) Serial.print(F("failed\n"));
+            else Serial.print(F("ok\n"));
+            task_job_error[job] = error;
+            __atomic_store_n(&task_job_state[job], TASK_JOB_DONE, __ATOMIC_RELEASE);
         }
-        
-        portENTER_CRITICAL(&subtask2_taskmux);
-        assist_now_client_active = !assist_now_client_error;
-        ntrip_client_active = !ntrip_client_error;
-        portEXIT_CRITICAL(&subtask2_taskmux);
     }
 }
@@ -0,0 +1,216 @@
+/**
+ * @file navigation_database.cpp
+ *
+ * @brief Navigation database related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <SparkFun_u-blox_GNSS_v3.h>
+#include <time.h>
+#include "navigation_database.h"
+#include "assist_now_client.h"
+#include "sd_card.h"
+#include "ubx.h"
+#include "gnss_aiding.h"
+#include "bus.h"
+
+portMUX_TYPE navigation_database_taskmux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t *navigation_database_buffer = nullptr;
+bool navigation_database_shutdown_request = false;
+struct ubx_parser navigation_database_parser;
+extern SFE_UBLOX_GNSS gnss_i2c;
+
+/**
+ * @brief Save the navigation database and the last position of the GNSS to the SD
+ * @return error
+ */
+bool navigation_database_save(void)
+{
+    bool error = false;
+    size_t length = 0;
+    double position_lon = 0.0;
+    double position_lat = 0.0;
+    double position_height = 0.0;
+    double position_acc = 0.0;
+    File datafile;
+    struct bus_gnss bus_gnss_data;
+    uint32_t version = 0;
+
+    esp_task_wdt_reset();
+    if (navigation_database_buffer == nullptr) return true;
+    length = gnss_i2c.readNavigationDatabase(navigation_database_buffer, NAVIGATION_DATABASE_BUFFER);
+    if (length > 0)
+    {
+        datafile = SD.open(NAVIGATION_DATABASE_TEMP, FILE_WRITE);
+        if (datafile)
+        {
+            if (datafile.write(navigation_database_buffer, length) != length) error = true;
+            datafile.close();
+            if (error == false)
+            {
+                SD.remove(NAVIGATION_DATABASE_FILE);
+                error = !SD.rename(NAVIGATION_DATABASE_TEMP, NAVIGATION_DATABASE_FILE);
+            }
+            else SD.remove(NAVIGATION_DATABASE_TEMP);
+        }
+        else error = true;
+    }
+    else error = true;
+
+    bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version);
+    position_lon = bus_gnss_data.lon;
+    position_lat = bus_gnss_data.lat;
+    position_height = bus_gnss_data.height;
+    position_acc = bus_gnss_data.p_acc;
+    datafile = SD.open(NAVIGATION_DATABASE_POSITION, FILE_WRITE);
+    if (datafile)
+    {
+        datafile.printf("%.8f %.8f %.3f %.3f\n", position_lat, position_lon, position_height, position_acc);
+        datafile.close();
+    }
+    else error = true;
+    Serial.printf("Save navigation database (%u bytes)... %s\n", (unsigned int)length, (error == true) ? "failed" : "ok");
+
+    return error;
+}
+
+/**
+ * @brief Request the controlled shutdown with saving of the navigation database
+ */
+void navigation_database_shutdown(void)
+{
+    portENTER_CRITICAL(&navigation_database_taskmux);
+    navigation_database_shutdown_request = true;
+    portEXIT_CRITICAL(&navigation_database_taskmux);
+}
+
+/**
+ * @brief Save the navigation database periodically and at shutdown
+ * @param [in] bridge (the UBX bridge owns the GNSS, power off without saving)
+ */
+void navigation_database(bool bridge)
+{
+    bool shutdown = false;
+    bool fix_ok = false;
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    struct bus_gnss bus_gnss_data;
+    uint32_t version = 0;
+
+    esp_task_wdt_reset();
+    portENTER_CRITICAL(&navigation_database_taskmux);
+    shutdown = navigation_database_shutdown_request;
+    portEXIT_CRITICAL(&navigation_database_taskmux);
+    bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version);
+    fix_ok = (bus_gnss_data.gnss_fix_ok == true) && (bus_gnss_data.fix_type >= 3);
+
+    if (shutdown == true)
+    {
+        if ((fix_ok == true) && (bridge == false))
+        {
+            navigation_database_save();
+            gnss_aiding_save();
+        }
+        Serial.print(F("Power off... ok\n"));
+        Serial.flush();
+        M5.Axp.PowerOff();
+    }
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > NAVIGATION_DATABASE_PERIOD)
+    {
+        if ((fix_ok == true) && (bridge == false)) navigation_database_save();
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Restore the navigation database into the GNSS
+ * @return error
+ */
+bool navigation_database_restore(void)
+{
+    bool error = false;
+    uint8_t data[256];
+    int length = 0;
+    int counter = 0;
+    uint16_t buffer_length = 0;
+    uint16_t messages = 0;
+    File datafile;
+
+    esp_task_wdt_reset();
+    if (navigation_database_buffer == nullptr) return true;
+    datafile = SD.open(NAVIGATION_DATABASE_FILE, FILE_READ);
+    if (datafile)
+    {
+        ubx_parser_init(&navigation_database_parser);
+        do
+        {
+            esp_task_wdt_reset();
+            length = datafile.read(data, sizeof(data));
+            for (counter = 0; counter < length; counter = counter + 1)
+            {
+                if ((ubx_parse(&navigation_database_parser, data[counter]) == true) &&
+                    (navigation_database_parser.frame[2] == UBX_CLASS_MGA) &&
+                    (navigation_database_parser.frame[3] == NAVIGATION_DATABASE_ID_DBD) &&
+                    (navigation_database_parser.frame_length <= ASSIST_NOW_CLIENT_BUFFER))
+                {
+                    if ((buffer_length + navigation_database_parser.frame_length) > ASSIST_NOW_CLIENT_BUFFER)
+                    {
+                        if (error == false) error = assist_now_client_push(navigation_database_buffer, buffer_length);
+                        buffer_length = 0;
+                    }
+                    memcpy(&navigation_database_buffer[buffer_length], navigation_database_parser.frame, navigation_database_parser.frame_length);
+                    buffer_length = buffer_length + navigation_database_parser.frame_length;
+                    messages = messages + 1;
+                }
+            }
+        }
+        while (length > 0);
+        datafile.close();
+        if (error == false) error = assist_now_client_push(navigation_database_buffer, buffer_length);
+        Serial.printf("%u MGA-DBD messages... ", messages);
+    }
+    else error = true;
+
+    return error;
+}
+
+/**
+ * @brief Initialize the navigation database
+ * @return error
+ */
+bool navigation_database_init(void)
+{
+    bool error = false;
+
+    esp_task_wdt_reset();
+    navigation_database_buffer = (uint8_t *)ps_malloc(NAVIGATION_DATABASE_BUFFER);
+    if (navigation_database_buffer == nullptr) navigation_database_buffer = (uint8_t *)malloc(NAVIGATION_DATABASE_BUFFER);
+    if (navigation_database_buffer == nullptr) error = true;
+
+    return error;
+}
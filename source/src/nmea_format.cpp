@@ -0,0 +1,523 @@
+/**
+ * @file nmea_format.cpp
+ *
+ * @brief NMEA format related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "nmea_format.h"
+#include "output_hub.h"
+
+/*
+ * NMEA 4.11 sentences formatted from a decoded UBX epoch into a caller
+ * buffer, without heap and without floating point. Latitude and longitude
+ * are given in 1E-9 deg, heights and accuracies in 0.1 mm, so the high
+ * precision output keeps every digit of NAV-HPPOSLLH.
+ */
+
+struct nmea_writer
+{
+    char *data;
+    uint16_t size;
+    uint16_t length;
+    uint16_t start;
+    bool overflow;
+};
+
+/**
+ * @brief Append characters
+ * @param [in,out] nmea_writer_data
+ * @param [in] text, length
+ */
+static void nmea_format_append(struct nmea_writer *nmea_writer_data, const char *text, uint16_t length)
+{
+    if ((nmea_writer_data->length + length) > nmea_writer_data->size)
+    {
+        nmea_writer_data->overflow = true;
+        return;
+    }
+    memcpy(&nmea_writer_data->data[nmea_writer_data->length], text, length);
+    nmea_writer_data->length = nmea_writer_data->length + length;
+}
+
+/**
+ * @brief Append a text
+ * @param [in,out] nmea_writer_data
+ * @param [in] text
+ */
+static void nmea_format_text(struct nmea_writer *nmea_writer_data, const char *text)
+{
+    nmea_format_append(nmea_writer_data, text, (uint16_t)strlen(text));
+}
+
+/**
+ * @brief Append an unsigned number with leading zeros up to digits
+ * @param [in,out] nmea_writer_data
+ * @param [in] value, digits
+ */
+static void nmea_format_uint(struct nmea_writer *nmea_writer_data, uint64_t value, uint8_t digits)
+{
+    char text[21];
+    uint8_t counter = sizeof(text);
+
+    do
+    {
+        counter = counter - 1;
+        text[counter] = (char)('0' + (value % 10));
+        value = value / 10;
+    }
+    while ((value > 0) || ((sizeof(text) - counter) < digits));
+    nmea_format_append(nmea_writer_data, &text[counter], (uint16_t)(sizeof(text) - counter));
+}
+
+/**
+ * @brief Append a fixed point number (value / 10^decimals) rounded to places decimals
+ * @param [in,out] nmea_writer_data
+ * @param [in] value, decimals, places
+ */
+static void nmea_format_fixed(struct nmea_writer *nmea_writer_data, int64_t value, uint8_t decimals, uint8_t places)
+{
+    uint64_t magnitude = 0;
+    uint64_t scale = 1;
+    uint8_t counter = 0;
+
+    if (value < 0) nmea_format_text(nmea_writer_data, "-");
+    magnitude = (value < 0) ? (uint64_t)(-value) : (uint64_t)value;
+    for (counter = places; counter < decimals; counter = counter + 1) scale = scale * 10;
+    magnitude = (magnitude + (scale / 2)) / scale;
+    scale = 1;
+    for (counter = 0; counter < places; counter = counter + 1) scale = scale * 10;
+    nmea_format_uint(nmea_writer_data, magnitude / scale, 1);
+    if (places > 0)
+    {
+        nmea_format_text(nmea_writer_data, ".");
+        nmea_format_uint(nmea_writer_data, magnitude % scale, places);
+    }
+}
+
+/**
+ * @brief Append an angle in 1E-9 deg as (d)ddmm.mmmmm
+ * @param [in,out] nmea_writer_data
+ * @param [in] value, degree_digits, places (decimals of the minutes)
+ */
+static void nmea_format_angle(struct nmea_writer *nmea_writer_data, int64_t value, uint8_t degree_digits, uint8_t places)
+{
+    uint64_t magnitude = (value < 0) ? (uint64_t)(-value) : (uint64_t)value;
+    uint64_t degrees = magnitude / 1000000000;
+    uint64_t minutes = (magnitude % 1000000000) * 60;
+    uint64_t scale = 1;
+    uint8_t counter = 0;
+
+    for (counter = places; counter < 9; counter = counter + 1) scale = scale * 10;
+    minutes = (minutes + (scale / 2)) / scale;
+    scale = 1;
+    for (counter = 0; counter < places; counter = counter + 1) scale = scale * 10;
+    if (minutes >= (60 * scale))
+    {
+        minutes = minutes - (60 * scale);
+        degrees = degrees + 1;
+    }
+    nmea_format_uint(nmea_writer_data, degrees, degree_digits);
+    nmea_format_uint(nmea_writer_data, minutes / scale, 2);
+    nmea_format_text(nmea_writer_data, ".");
+    nmea_format_uint(nmea_writer_data, minutes % scale, places);
+}
+
+/**
+ * @brief Append the UTC time hhmmss.ss (empty if not valid)
+ * @param [in,out] nmea_writer_data
+ * @param [in] nmea_epoch_data
+ */
+static void nmea_format_time(struct nmea_writer *nmea_writer_data, const struct nmea_epoch *nmea_epoch_data)
+{
+    int64_t centi = 0;
+
+    if (nmea_epoch_data->time_valid == false) return;
+    centi = ((int64_t)nmea_epoch_data->hour * 3600 + (int64_t)nmea_epoch_data->minute * 60 + nmea_epoch_data->second) * 100;
+    if (nmea_epoch_data->nano >= 0) centi = centi + (nmea_epoch_data->nano + 5000000) / 10000000;
+    else centi = centi - (5000000 - nmea_epoch_data->nano) / 10000000;
+    if (centi < 0) centi = centi + 8640000;
+    if (centi >= 8640000) centi = centi - 8640000;
+    nmea_format_uint(nmea_writer_data, (uint64_t)(centi / 360000), 2);
+    nmea_format_uint(nmea_writer_data, (uint64_t)((centi / 6000) % 60), 2);
+    nmea_format_uint(nmea_writer_data, (uint64_t)((centi / 100) % 60), 2);
+    nmea_format_text(nmea_writer_data, ".");
+    nmea_format_uint(nmea_writer_data, (uint64_t)(centi % 100), 2);
+}
+
+/**
+ * @brief Start a sentence with talker and type
+ * @param [in,out] nmea_writer_data
+ * @param [in] talker, type
+ */
+static void nmea_format_begin(struct nmea_writer *nmea_writer_data, const char *talker, const char *type)
+{
+    nmea_writer_data->start = nmea_writer_data->length;
+    nmea_format_text(nmea_writer_data, "$");
+    nmea_format_text(nmea_writer_data, talker);
+    nmea_format_text(nmea_writer_data, type);
+}
+
+/**
+ * @brief Finish a sentence with checksum and CR LF
+ * @param [in,out] nmea_writer_data
+ */
+static void nmea_format_end(struct nmea_writer *nmea_writer_data)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char text[5];
+    uint8_t checksum = 0;
+    uint16_t counter = 0;
+
+    if (nmea_writer_data->overflow == true) return;
+    for (counter = nmea_writer_data->start + 1; counter < nmea_writer_data->length; counter = counter + 1) checksum = checksum ^ (uint8_t)nmea_writer_data->data[counter];
+    text[0] = '*';
+    text[1] = hex[checksum >> 4];
+    text[2] = hex[checksum & 0x0F];
+    text[3] = '\r';
+    text[4] = '\n';
+    nmea_format_append(nmea_writer_data, text, sizeof(text));
+}
+
+/**
+ * @brief Get the position mode of the epoch (N, A, D, F, R or E)
+ * @param [in] nmea_epoch_data
+ * @return mode
+ */
+static char nmea_format_mode(const struct nmea_epoch *nmea_epoch_data)
+{
+    if (nmea_epoch_data->fix_type == 1) return 'E';
+    if ((nmea_epoch_data->fix_ok == false) || (nmea_epoch_data->fix_type < 2) || (nmea_epoch_data->fix_type == 5)) return 'N';
+    if (nmea_epoch_data->carr_soln == 2) return 'R';
+    if (nmea_epoch_data->carr_soln == 1) return 'F';
+    if (nmea_epoch_data->diff_soln == true) return 'D';
+
+    return 'A';
+}
+
+/**
+ * @brief Append latitude and longitude with hemispheres
+ * @param [in,out] nmea_writer_data
+ * @param [in] nmea_epoch_data, places, valid
+ */
+static void nmea_format_position(struct nmea_writer *nmea_writer_data, const struct nmea_epoch *nmea_epoch_data, uint8_t places, bool valid)
+{
+    if (valid == true)
+    {
+        nmea_format_text(nmea_writer_data, ",");
+        nmea_format_angle(nmea_writer_data, nmea_epoch_data->lat, 2, places);
+        nmea_format_text(nmea_writer_data, (nmea_epoch_data->lat < 0) ? ",S," : ",N,");
+        nmea_format_angle(nmea_writer_data, nmea_epoch_data->lon, 3, places);
+        nmea_format_text(nmea_writer_data, (nmea_epoch_data->lon < 0) ? ",W" : ",E");
+    }
+    else nmea_format_text(nmea_writer_data, ",,,,");
+}
+
+/**
+ * @brief Get the NMEA talker of a GNSS id
+ * @param [in] gnss_id
+ * @return talker
+ */
+static const char *nmea_format_talker(uint8_t gnss_id)
+{
+    switch (gnss_id)
+    {
+        case 2: return "GA";
+        case 3: return "GB";
+        case 5: return "GQ";
+        case 6: return "GL";
+        default: return "GP";
+    }
+}
+
+/**
+ * @brief Get the NMEA satellite number of a UBX satellite
+ * @param [in] nmea_satellite_data
+ * @return number
+ */
+static uint8_t nmea_format_sv(const struct nmea_satellite *nmea_satellite_data)
+{
+    if (nmea_satellite_data->gnss_id == 1) return nmea_satellite_data->sv_id - 87;
+    if (nmea_satellite_data->gnss_id == 6) return nmea_satellite_data->sv_id + 64;
+
+    return nmea_satellite_data->sv_id;
+}
+
+/**
+ * @brief Append the GSA sentences (one per system with used satellites)
+ * @param [in,out] nmea_writer_data
+ * @param [in] nmea_epoch_data
+ */
+static void nmea_format_gsa(struct nmea_writer *nmea_writer_data, const struct nmea_epoch *nmea_epoch_data)
+{
+    static const uint8_t systems[5][3] = {{0, 1, 1}, {6, 6, 2}, {2, 2, 3}, {3, 3, 4}, {5, 5, 5}};
+    uint8_t counter1 = 0;
+    uint8_t counter2 = 0;
+    uint8_t used = 0;
+    uint8_t gnss_id = 0;
+
+    for (counter1 = 0; counter1 < 5; counter1 = counter1 + 1)
+    {
+        used = 0;
+        for (counter2 = 0; counter2 < nmea_epoch_data->satellites; counter2 = counter2 + 1)
+        {
+            gnss_id = nmea_epoch_data->satellite[counter2].gnss_id;
+            if ((nmea_epoch_data->satellite[counter2].used == true) && ((gnss_id == systems[counter1][0]) || (gnss_id == systems[counter1][1]))) used = used + 1;
+        }
+        if ((used == 0) && (counter1 > 0)) continue;
+        nmea_format_begin(nmea_writer_data, "GN", "GSA,A,");
+        if (nmea_format_mode(nmea_epoch_data) == 'N') nmea_format_text(nmea_writer_data, "1");
+        else nmea_format_uint(nmea_writer_data, (nmea_epoch_data->fix_type >= 3) ? 3 : 2, 1);
+        used = 0;
+        for (counter2 = 0; counter2 < nmea_epoch_data->satellites; counter2 = counter2 + 1)
+        {
+            gnss_id = nmea_epoch_data->satellite[counter2].gnss_id;
+            if ((nmea_epoch_data->satellite[counter2].used == true) && ((gnss_id == systems[counter1][0]) || (gnss_id == systems[counter1][1])) && (used < 12))
+            {
+                nmea_format_text(nmea_writer_data, ",");
+                nmea_format_uint(nmea_writer_data, nmea_format_sv(&nmea_epoch_data->satellite[counter2]), 2);
+                used = used + 1;
+            }
+        }
+        while (used < 12)
+        {
+            nmea_format_text(nmea_writer_data, ",");
+            used = used + 1;
+        }
+        nmea_format_text(nmea_writer_data, ",");
+        nmea_format_fixed(nmea_writer_data, nmea_epoch_data->pdop, 2, 2);
+        nmea_format_text(nmea_writer_data, ",");
+        nmea_format_fixed(nmea_writer_data, nmea_epoch_data->hdop, 2, 2);
+        nmea_format_text(nmea_writer_data, ",");
+        nmea_format_fixed(nmea_writer_data, nmea_epoch_data->vdop, 2, 2);
+        nmea_format_text(nmea_writer_data, ",");
+        nmea_format_uint(nmea_writer_data, systems[counter1][2], 1);
+        nmea_format_end(nmea_writer_data);
+    }
+}
+
+/**
+ * @brief Append the GSV sentences (four satellites per sentence and system)
+ * @param [in,out] nmea_writer_data
+ * @param [in] nmea_epoch_data
+ */
+static void nmea_format_gsv(struct nmea_writer *nmea_writer_data, const struct nmea_epoch *nmea_epoch_data)
+{
+    static const uint8_t systems[5][3] = {{0, 1, 1}, {6, 6, 1}, {2, 2, 7}, {3, 3, 1}, {5, 5, 1}};
+    uint8_t counter1 = 0;
+    uint8_t counter2 = 0;
+    uint8_t count = 0;
+    uint8_t sentence = 0;
+    uint8_t written = 0;
+    const struct nmea_satellite *satellite = nullptr;
+
+    for (counter1 = 0; counter1 < 5; counter1 = counter1 + 1)
+    {
+        count = 0;
+        for (counter2 = 0; counter2 < nmea_epoch_data->satellites; counter2 = counter2 + 1)
+        {
+            if ((nmea_epoch_data->satellite[counter2].gnss_id == systems[counter1][0]) || (nmea_epoch_data->satellite[counter2].gnss_id == systems[counter1][1])) count = count + 1;
+        }
+        if (count == 0) continue;
+        sentence = 0;
+        written = 0;
+        for (counter2 = 0; counter2 < nmea_epoch_data->satellites; counter2 = counter2 + 1)
+        {
+            satellite = &nmea_epoch_data->satellite[counter2];
+            if ((satellite->gnss_id != systems[counter1][0]) && (satellite->gnss_id != systems[counter1][1])) continue;
+            if ((written % 4) == 0)
+            {
+                sentence = sentence + 1;
+                nmea_format_begin(nmea_writer_data, nmea_format_talker(systems[counter1][0]), "GSV,");
+                nmea_format_uint(nmea_writer_data, (count + 3) / 4, 1);
+                nmea_format_text(nmea_writer_data, ",");
+                nmea_format_uint(nmea_writer_data, sentence, 1);
+                nmea_format_text(nmea_writer_data, ",");
+                nmea_format_uint(nmea_writer_data, count, 2);
+            }
+            nmea_format_text(nmea_writer_data, ",");
+            nmea_format_uint(nmea_writer_data, nmea_format_sv(satellite), 2);
+            nmea_format_text(nmea_writer_data, ",");
+            if ((satellite->elevation >= 0) && (satellite->elevation <= 90)) nmea_format_uint(nmea_writer_data, (uint64_t)satellite->elevation, 2);
+            nmea_format_text(nmea_writer_data, ",");
+            if ((satellite->azimuth >= 0) && (satellite->azimuth <= 359)) nmea_format_uint(nmea_writer_data, (uint64_t)satellite->azimuth, 3);
+            nmea_format_text(nmea_writer_data, ",");
+            if (satellite->cno > 0) nmea_format_uint(nmea_writer_data, satellite->cno, 2);
+            written = written + 1;
+            if (((written % 4) == 0) || (written == count))
+            {
+                nmea_format_text(nmea_writer_data, ",");
+                nmea_format_uint(nmea_writer_data, systems[counter1][2], 1);
+                nmea_format_end(nmea_writer_data);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Format the NMEA sentences of an epoch
+ * @param [in] nmea_epoch_data
+ * @param [in] sentences (OUTPUT_HUB_SENTENCE_x), precision (NMEA_FORMAT_PRECISION_x)
+ * @param [out] data
+ * @param [in] size
+ * @return length, 0 if the buffer is too small
+ */
+uint16_t nmea_format(const struct nmea_epoch *nmea_epoch_data, uint32_t sentences, uint8_t precision, char *data, uint16_t size)
+{
+    struct nmea_writer nmea_writer_data;
+    uint8_t places = (precision == NMEA_FORMAT_PRECISION_HIGH) ? 7 : 5;
+    uint8_t height_places = (precision == NMEA_FORMAT_PRECISION_HIGH) ? 4 : 1;
+    char mode = nmea_format_mode(nmea_epoch_data);
+    char text[2];
+    uint8_t quality = 0;
+    int64_t knots = 0;
+    uint32_t sigma = 0;
+
+    nmea_writer_data.data = data;
+    nmea_writer_data.size = size;
+    nmea_writer_data.length = 0;
+    nmea_writer_data.start = 0;
+    nmea_writer_data.overflow = false;
+    text[0] = mode;
+    text[1] = '\0';
+    switch (mode)
+    {
+        case 'A': quality = 1; break;
+        case 'D': quality = 2; break;
+        case 'R': quality = 4; break;
+        case 'F': quality = 5; break;
+        case 'E': quality = 6; break;
+        default: quality = 0; break;
+    }
+
+    if ((sentences & OUTPUT_HUB_SENTENCE_RMC) != 0)
+    {
+        nmea_format_begin(&nmea_writer_data, "GN", "RMC,");
+        nmea_format_time(&nmea_writer_data, nmea_epoch_data);
+        nmea_format_text(&nmea_writer_data, (mode == 'N') ? ",V" : ",A");
+        nmea_format_position(&nmea_writer_data, nmea_epoch_data, places, (mode != 'N'));
+        nmea_format_text(&nmea_writer_data, ",");
+        knots = ((int64_t)nmea_epoch_data->speed * 1000000) / 514444;
+        nmea_format_fixed(&nmea_writer_data, knots, 3, 3);
+        nmea_format_text(&nmea_writer_data, ",");
+        if (mode != 'N') nmea_format_fixed(&nmea_writer_data, nmea_epoch_data->course, 5, 2);
+        nmea_format_text(&nmea_writer_data, ",");
+        if (nmea_epoch_data->date_valid == true)
+        {
+            nmea_format_uint(&nmea_writer_data, nmea_epoch_data->day, 2);
+            nmea_format_uint(&nmea_writer_data, nmea_epoch_data->month, 2);
+            nmea_format_uint(&nmea_writer_data, nmea_epoch_data->year % 100, 2);
+        }
+        nmea_format_text(&nmea_writer_data, ",,,");
+        nmea_format_text(&nmea_writer_data, text);
+        nmea_format_text(&nmea_writer_data, (mode == 'N') ? ",V" : ",A");
+        nmea_format_end(&nmea_writer_data);
+    }
+    if ((sentences & OUTPUT_HUB_SENTENCE_VTG) != 0)
+    {
+        nmea_format_begin(&nmea_writer_data, "GN", "VTG,");
+        if (mode != 'N') nmea_format_fixed(&nmea_writer_data, nmea_epoch_data->course, 5, 2);
+        nmea_format_text(&nmea_writer_data, ",T,,M,");
+        nmea_format_fixed(&nmea_writer_data, ((int64_t)nmea_epoch_data->speed * 1000000) / 514444, 3, 3);
+        nmea_format_text(&nmea_writer_data, ",N,");
+        nmea_format_fixed(&nmea_writer_data, (int64_t)nmea_epoch_data->speed * 36, 4, 3);
+        nmea_format_text(&nmea_writer_data, ",K,");
+        nmea_format_text(&nmea_writer_data, text);
+        nmea_format_end(&nmea_writer_data);
+    }
+    if ((sentences & OUTPUT_HUB_SENTENCE_GGA) != 0)
+    {
+        nmea_format_begin(&nmea_writer_data, "GN", "GGA,");
+        nmea_format_time(&nmea_writer_data, nmea_epoch_data);
+        nmea_format_position(&nmea_writer_data, nmea_epoch_data, places, (mode != 'N'));
+        nmea_format_text(&nmea_writer_data, ",");
+        nmea_format_uint(&nmea_writer_data, quality, 1);
+        nmea_format_text(&nmea_writer_data, ",");
+        nmea_format_uint(&nmea_writer_data, nmea_epoch_data->num_sv, 2);
+        nmea_format_text(&nmea_writer_data, ",");
+        nmea_format_fixed(&nmea_writer_data, nmea_epoch_data->hdop, 2, 2);
+        nmea_format_text(&nmea_writer_data, ",");
+        if (mode != 'N')
+        {
+            nmea_format_fixed(&nmea_writer_data, nmea_epoch_data->height_msl, 4, height_places);
+            nmea_format_text(&nmea_writer_data, ",M,");
+            nmea_format_fixed(&nmea_writer_data, (int64_t)nmea_epoch_data->height - nmea_epoch_data->height_msl, 4, height_places);
+            nmea_format_text(&nmea_writer_data, ",M,,");
+        }
+        else nmea_format_text(&nmea_writer_data, ",M,,M,,");
+        nmea_format_end(&nmea_writer_data);
+    }
+    if ((sentences & OUTPUT_HUB_SENTENCE_GSA) != 0) nmea_format_gsa(&nmea_writer_data, nmea_epoch_data);
+    if ((sentences & OUTPUT_HUB_SENTENCE_GSV) != 0) nmea_format_gsv(&nmea_writer_data, nmea_epoch_data);
+    if ((sentences & OUTPUT_HUB_SENTENCE_GLL) != 0)
+    {
+        nmea_format_begin(&nmea_writer_data, "GN", "GLL");
+        nmea_format_position(&nmea_writer_data, nmea_epoch_data, places, (mode != 'N'));
+        nmea_format_text(&nmea_writer_data, ",");
+        nmea_format_time(&nmea_writer_data, nmea_epoch_data);
+        nmea_format_text(&nmea_writer_data, (mode == 'N') ? ",V," : ",A,");
+        nmea_format_text(&nmea_writer_data, text);
+        nmea_format_end(&nmea_writer_data);
+    }
+    if ((sentences & OUTPUT_HUB_SENTENCE_GST) != 0)
+    {
+        sigma = (uint32_t)(((uint64_t)nmea_epoch_data->h_acc * 7071 + 5000) / 10000);
+        nmea_format_begin(&nmea_writer_data, "GN", "GST,");
+        nmea_format_time(&nmea_writer_data, nmea_epoch_data);
+        nmea_format_text(&nmea_writer_data, ",,");
+        nmea_format_fixed(&nmea_writer_data, sigma, 4, 3);
+        nmea_format_text(&nmea_writer_data, ",");
+        nmea_format_fixed(&nmea_writer_data, sigma, 4, 3);
+        nmea_format_text(&nmea_writer_data, ",0.0,");
+        nmea_format_fixed(&nmea_writer_data, sigma, 4, 3);
+        nmea_format_text(&nmea_writer_data, ",");
+        nmea_format_fixed(&nmea_writer_data, sigma, 4, 3);
+        nmea_format_text(&nmea_writer_data, ",");
+        nmea_format_fixed(&nmea_writer_data, nmea_epoch_data->v_acc, 4, 3);
+        nmea_format_end(&nmea_writer_data);
+    }
+    if ((sentences & OUTPUT_HUB_SENTENCE_ZDA) != 0)
+    {
+        nmea_format_begin(&nmea_writer_data, "GN", "ZDA,");
+        nmea_format_time(&nmea_writer_data, nmea_epoch_data);
+        nmea_format_text(&nmea_writer_data, ",");
+        if (nmea_epoch_data->date_valid == true)
+        {
+            nmea_format_uint(&nmea_writer_data, nmea_epoch_data->day, 2);
+            nmea_format_text(&nmea_writer_data, ",");
+            nmea_format_uint(&nmea_writer_data, nmea_epoch_data->month, 2);
+            nmea_format_text(&nmea_writer_data, ",");
+            nmea_format_uint(&nmea_writer_data, nmea_epoch_data->year, 4);
+        }
+        else nmea_format_text(&nmea_writer_data, ",,");
+        nmea_format_text(&nmea_writer_data, ",00,00");
+        nmea_format_end(&nmea_writer_data);
+    }
+    if (nmea_writer_data.overflow == true) return 0;
+
+    return nmea_writer_data.length;
+}
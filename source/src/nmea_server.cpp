@@ -0,0 +1,208 @@
+/**
+ * @file nmea_server.cpp
+ *
+ * @brief NMEA server related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include "nmea_server.h"
+#include "output.h"
+#include "sd_card.h"
+
+/*
+ * Every client of the TCP server is a sink of the output hub. The epochs
+ * are sent in place with non-blocking sends, a client that cannot keep up
+ * drops epochs of its own and is disconnected after NMEA_SERVER_TIMEOUT.
+ */
+
+portMUX_TYPE nmea_server_taskmux = portMUX_INITIALIZER_UNLOCKED;
+WiFiServer nmea_server_server;
+struct nmea_server_client nmea_server_clients[NMEA_SERVER_CLIENTS];
+char nmea_server_sentences[64];
+uint8_t nmea_server_decimation = 1;
+uint8_t nmea_server_precision = NMEA_FORMAT_PRECISION_HIGH;
+bool nmea_server_active = false;
+uint32_t nmea_server_bytes = 0;
+uint32_t nmea_server_drops = 0;
+uint8_t nmea_server_count = 0;
+
+/**
+ * @brief Stop a client of the NMEA server
+ * @param [in] nmea_server_client_data
+ */
+void nmea_server_stop(struct nmea_server_client *nmea_server_client_data)
+{
+    Serial.printf("Disconnect NMEA server client (%lu drops)... ok\n", (unsigned long)nmea_server_client_data->output_hub_sink_data.drops);
+    nmea_server_client_data->wifi_client.stop();
+    nmea_server_client_data->active = false;
+
+    portENTER_CRITICAL(&nmea_server_taskmux);
+    nmea_server_drops = nmea_server_drops + nmea_server_client_data->output_hub_sink_data.drops;
+    nmea_server_count = nmea_server_count - 1;
+    portEXIT_CRITICAL(&nmea_server_taskmux);
+}
+
+/**
+ * @brief Transfer data from the NMEA server
+ * @param [in] nmea_server_data
+ */
+void nmea_server_transfer(struct nmea_server *nmea_server_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static uint32_t last_bytes = 0;
+    uint32_t bytes = 0;
+    uint32_t drops = 0;
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&nmea_server_taskmux);
+        bytes = nmea_server_bytes;
+        if (nmea_server_data->clients != nmea_server_count)
+        {
+            nmea_server_data->clients = nmea_server_count;
+            nmea_server_data->update = true;
+        }
+        drops = nmea_server_drops;
+        portEXIT_CRITICAL(&nmea_server_taskmux);
+        for (counter = 0; counter < NMEA_SERVER_CLIENTS; counter = counter + 1)
+        {
+            if (nmea_server_clients[counter].active == true) drops = drops + nmea_server_clients[counter].output_hub_sink_data.drops;
+        }
+        nmea_server_data->drops = drops;
+        nmea_server_data->bytes_per_second = (uint32_t)((uint64_t)(bytes - last_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        last_bytes = bytes;
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Send the epochs of the output hub to the clients of the NMEA server
+ */
+void nmea_server(void)
+{
+    uint8_t counter = 0;
+    uint32_t length = 0;
+    ssize_t sent = 0;
+    const uint8_t *data = nullptr;
+    bool end = false;
+    uint32_t timestamp = 0;
+    WiFiClient wifi_client;
+    struct nmea_server_client *client = nullptr;
+
+    esp_task_wdt_reset();
+    if (nmea_server_active == false) return;
+    if (nmea_server_server.hasClient() == true)
+    {
+        wifi_client = nmea_server_server.available();
+        for (counter = 0; counter < NMEA_SERVER_CLIENTS; counter = counter + 1)
+        {
+            if (nmea_server_clients[counter].active == false) break;
+        }
+        if (counter < NMEA_SERVER_CLIENTS)
+        {
+            nmea_server_clients[counter].wifi_client = wifi_client;
+            nmea_server_clients[counter].wifi_client.setNoDelay(true);
+            nmea_server_clients[counter].timestamp = millis();
+            output_sink_init(&nmea_server_clients[counter].output_hub_sink_data, nmea_server_sentences, nmea_server_decimation, nmea_server_precision);
+            nmea_server_clients[counter].active = true;
+
+            portENTER_CRITICAL(&nmea_server_taskmux);
+            nmea_server_count = nmea_server_count + 1;
+            portEXIT_CRITICAL(&nmea_server_taskmux);
+            Serial.print(F("Connect NMEA server client... ok\n"));
+        }
+        else wifi_client.stop();
+    }
+
+    for (counter = 0; counter < NMEA_SERVER_CLIENTS; counter = counter + 1)
+    {
+        client = &nmea_server_clients[counter];
+        if (client->active == false) continue;
+        if (client->wifi_client.connected() == false)
+        {
+            nmea_server_stop(client);
+            continue;
+        }
+        while (1)
+        {
+            length = output_peek(&client->output_hub_sink_data, &data, &end, &timestamp);
+            if (length == 0)
+            {
+                client->timestamp = millis();
+                break;
+            }
+            sent = send(client->wifi_client.fd(), data, length, MSG_DONTWAIT);
+            if (sent > 0)
+            {
+                output_consume(&client->output_hub_sink_data, (uint32_t)sent);
+                client->timestamp = millis();
+
+                portENTER_CRITICAL(&nmea_server_taskmux);
+                nmea_server_bytes = nmea_server_bytes + (uint32_t)sent;
+                portEXIT_CRITICAL(&nmea_server_taskmux);
+                if ((uint32_t)sent < length) break;
+            }
+            else
+            {
+                if ((sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) nmea_server_stop(client);
+                else if ((unsigned long)(millis() - client->timestamp) > NMEA_SERVER_TIMEOUT) nmea_server_stop(client);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Initialize the NMEA server
+ * @param [in] nmea_server_data, sd_card_config2_data
+ * @return error
+ */
+bool nmea_server_init(struct nmea_server *nmea_server_data, struct sd_card_config2 *sd_card_config2_data)
+{
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    for (counter = 0; counter < NMEA_SERVER_CLIENTS; counter = counter + 1) nmea_server_clients[counter].active = false;
+    strcpy(nmea_server_sentences, sd_card_config2_data->output_tcp_sentences);
+    nmea_server_decimation = sd_card_config2_data->output_tcp_decimation;
+    nmea_server_precision = sd_card_config2_data->output_tcp_precision;
+    nmea_server_server.begin(sd_card_config2_data->output_tcp_port);
+    nmea_server_server.setNoDelay(true);
+    nmea_server_active = true;
+    nmea_server_data->clients = 0;
+    nmea_server_data->bytes_per_second = 0;
+    nmea_server_data->drops = 0;
+    nmea_server_data->update = true;
+
+    return false;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file ntrip_caster.cpp
+ *
+ * @brief NTRIP caster related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include "ntrip_caster.h"
+#include "sd_card.h"
+
+WiFiServer ntrip_caster_server;
+struct ntrip_caster_client ntrip_caster_clients[NTRIP_CASTER_CLIENTS];
+char ntrip_caster_mount_point[256];
+bool ntrip_caster_active = false;
+uint8_t *ntrip_caster_buffer = nullptr;
+
+/**
+ * @brief Stop a client of the NTRIP caster
+ * @param [in] ntrip_caster_client_data
+ */
+void ntrip_caster_stop(struct ntrip_caster_client *ntrip_caster_client_data)
+{
+    if (ntrip_caster_client_data->state == NTRIP_CASTER_STATE_STREAM)
+    {
+        Serial.printf("Disconnect NTRIP caster client (%lu drops)... ok\n", (unsigned long)ntrip_caster_client_data->ring_buffer_data.drops);
+    }
+    ntrip_caster_client_data->wifi_client.stop();
+    ntrip_caster_client_data->state = NTRIP_CASTER_STATE_FREE;
+}
+
+/**
+ * @brief Answer the request of a client of the NTRIP caster
+ * @param [in] ntrip_caster_client_data
+ */
+void ntrip_caster_request(struct ntrip_caster_client *ntrip_caster_client_data)
+{
+    char data[512];
+    char mount_point[256];
+    char *begin = nullptr;
+    char *end = nullptr;
+    int length = 0;
+
+    mount_point[0] = '\0';
+    begin = strstr(ntrip_caster_client_data->request, "GET /");
+    if (begin != nullptr)
+    {
+        begin = begin + 5;
+        end = strchr(begin, ' ');
+        if ((end != nullptr) && ((size_t)(end - begin) < sizeof(mount_point)))
+        {
+            memcpy(mount_point, begin, end - begin);
+            mount_point[end - begin] = '\0';
+        }
+    }
+    if ((begin != nullptr) && (mount_point[0] == '\0'))
+    {
+        length = snprintf(&data[256], 256, "STR;%s;%s;RTCM 3.3;;2;GNSS;LAN;;0.00;0.00;0;0;ZED-F9P;none;N;N;0;\r\nENDSOURCETABLE\r\n", ntrip_caster_mount_point, ntrip_caster_mount_point);
+        snprintf(data, 256, "SOURCETABLE 200 OK\r\nServer: M5Stack Core2\r\nContent-Type: text/plain\r\nContent-Length: %d\r\n\r\n", length);
+        ntrip_caster_client_data->wifi_client.write(data, strlen(data));
+        ntrip_caster_client_data->wifi_client.write(&data[256], length);
+        ntrip_caster_stop(ntrip_caster_client_data);
+    }
+    else if ((begin != nullptr) && (strcmp(mount_point, ntrip_caster_mount_point) == 0))
+    {
+        ntrip_caster_client_data->wifi_client.print("ICY 200 OK\r\n\r\n");
+        ring_buffer_clear(&ntrip_caster_client_data->ring_buffer_data);
+        ntrip_caster_client_data->ring_buffer_data.drops = 0;
+        ntrip_caster_client_data->timestamp = millis();
+        ntrip_caster_client_data->state = NTRIP_CASTER_STATE_STREAM;
+        Serial.print(F("Connect NTRIP caster client... ok\n"));
+    }
+    else
+    {
+        ntrip_caster_client_data->wifi_client.print("HTTP/1.0 404 Not Found\r\n\r\n");
+        ntrip_caster_stop(ntrip_caster_client_data);
+    }
+}
+
+/**
+ * @brief Push complete RTCM frames to all clients of the NTRIP caster
+ * @param [in] data, length
+ */
+void ntrip_caster_push(const uint8_t *data, uint16_t length)
+{
+    uint8_t counter = 0;
+
+    if (ntrip_caster_active == false) return;
+    for (counter = 0; counter < NTRIP_CASTER_CLIENTS; counter = counter + 1)
+    {
+        if (ntrip_caster_clients[counter].state == NTRIP_CASTER_STATE_STREAM) ring_buffer_write(&ntrip_caster_clients[counter].ring_buffer_data, data, length);
+    }
+}
+
+/**
+ * @brief Communication from the NTRIP caster
+ */
+void ntrip_caster(void)
+{
+    uint8_t counter = 0;
+    uint32_t length = 0;
+    ssize_t sent = 0;
+    const uint8_t *data = nullptr;
+    WiFiClient wifi_client;
+    struct ntrip_caster_client *client = nullptr;
+
+    esp_task_wdt_reset();
+    if (ntrip_caster_active == false) return;
+    if (ntrip_caster_server.hasClient() == true)
+    {
+        wifi_client = ntrip_caster_server.available();
+        for (counter = 0; counter < NTRIP_CASTER_CLIENTS; counter = counter + 1)
+        {
+            if (ntrip_caster_clients[counter].state == NTRIP_CASTER_STATE_FREE) break;
+        }
+        if (counter < NTRIP_CASTER_CLIENTS)
+        {
+            ntrip_caster_clients[counter].wifi_client = wifi_client;
+            ntrip_caster_clients[counter].wifi_client.setNoDelay(true);
+            ntrip_caster_clients[counter].request_length = 0;
+            ntrip_caster_clients[counter].timestamp = millis();
+            ntrip_caster_clients[counter].state = NTRIP_CASTER_STATE_REQUEST;
+        }
+        else wifi_client.stop();
+    }
+
+    for (counter = 0; counter < NTRIP_CASTER_CLIENTS; counter = counter + 1)
+    {
+        client = &ntrip_caster_clients[counter];
+        switch (client->state)
+        {
+            case NTRIP_CASTER_STATE_REQUEST:
+            while ((client->wifi_client.available() > 0) && (client->request_length < (sizeof(client->request) - 1)))
+            {
+                client->request[client->request_length] = (char)client->wifi_client.read();
+                client->request_length = client->request_length + 1;
+            }
+            client->request[client->request_length] = '\0';
+            if (strstr(client->request, "\r\n\r\n") != nullptr) ntrip_caster_request(client);
+            else if ((client->request_length == (sizeof(client->request) - 1)) || ((unsigned long)(millis() - client->timestamp) > 5000)) ntrip_caster_stop(client);
+            break;
+
+            case NTRIP_CASTER_STATE_STREAM:
+            if (client->wifi_client.connected() == false)
+            {
+                ntrip_caster_stop(client);
+                break;
+            }
+            length = ring_buffer_peek(&client->ring_buffer_data, &data);
+            if (length > 0)
+            {
+                sent = send(client->wifi_client.fd(), data, length, MSG_DONTWAIT);
+                if (sent > 0)
+                {
+                    ring_buffer_consume(&client->ring_buffer_data, (uint32_t)sent);
+                    client->timestamp = millis();
+                }
+                else if ((sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) ntrip_caster_stop(client);
+                else if ((unsigned long)(millis() - client->timestamp) > NTRIP_CASTER_TIMEOUT) ntrip_caster_stop(client);
+            }
+            else client->timestamp = millis();
+            break;
+
+            default:
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Allocate the client buffers of the NTRIP caster (called at startup, before the heap fragments)
+ * @return error
+ */
+bool ntrip_caster_reserve(void)
+{
+    esp_task_wdt_reset();
+    ntrip_caster_buffer = (uint8_t *)ps_malloc(NTRIP_CASTER_CLIENTS * NTRIP_CASTER_BUFFER);
+    if (ntrip_caster_buffer == nullptr) ntrip_caster_buffer = (uint8_t *)malloc(NTRIP_CASTER_CLIENTS * NTRIP_CASTER_BUFFER);
+
+    return (ntrip_caster_buffer == nullptr);
+}
+
+/**
+ * @brief Initialize the NTRIP caster
+ * @param [in] sd_card_config2_data
+ * @return error
+ */
+bool ntrip_caster_init(struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    if (ntrip_caster_buffer != nullptr)
+    {
+        for (counter = 0; counter < NTRIP_CASTER_CLIENTS; counter = counter + 1)
+        {
+            ntrip_caster_clients[counter].state = NTRIP_CASTER_STATE_FREE;
+            ring_buffer_init(&ntrip_caster_clients[counter].ring_buffer_data, &ntrip_caster_buffer[counter * NTRIP_CASTER_BUFFER], NTRIP_CASTER_BUFFER);
+        }
+        strcpy(ntrip_caster_mount_point, sd_card_config2_data->ntrip_caster_mount_point);
+        ntrip_caster_server.begin(sd_card_config2_data->ntrip_caster_port);
+        ntrip_caster_server.setNoDelay(true);
+        ntrip_caster_active = true;
+    }
+    else error = true;
+
+    return error;
+}
@@ -30,17 +30,17 @@
 #include <esp_task_wdt.h>
 #include <SparkFun_u-blox_GNSS_v3.h>
 #include <WiFiClient.h>
-#include <Base64.h>
+#include <mbedtls/base64.h>
 #include "ntrip_client.h"
 #include "sd_card.h"
 #include "gnss.h"
 #include "assist_now_client.h"
+#include "correction.h"
+#include "bus.h"
 
-unsigned long timeout = 0;
-extern WiFiClient wifi_client;
-extern portMUX_TYPE subtask2_taskmux; 
+unsigned long ntrip_client_timestamp = 0;
+WiFiClient ntrip_client_wifi_client;
 extern SFE_UBLOX_GNSS_SERIAL gnss_serial;
-extern bool ntrip_client_active;
 
 /**
  * @brief Transfer data from the NTRIP client
@@ -48,21 +48,17 @@ extern bool ntrip_client_active;
  */
 void ntrip_client_transfer(struct ntrip_client *ntrip_client_data)
 {
-    unsigned long curr_millis = 0;
-    static unsigned long last_millis = millis();
+    static struct bus_link bus_link_data;
+    static uint32_t version = 0;
  
     esp_task_wdt_reset();
-    curr_millis = millis();
-    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    if (bus_read(BUS_TOPIC_LINK, &bus_link_data, &version) == true)
     {
-        portENTER_CRITICAL(&subtask2_taskmux);
-        if (ntrip_client_data->active != ntrip_client_active)
+        if (ntrip_client_data->active != bus_link_data.ntrip_client_active)
         {
-            ntrip_client_data->active = ntrip_client_active;
+            ntrip_client_data->active = bus_link_data.ntrip_client_active;
             ntrip_client_data->update = true;
         }
-        portEXIT_CRITICAL(&subtask2_taskmux);
-        last_millis = curr_millis;
     }
 }
 
@@ -74,33 +70,23 @@ void ntrip_client_transfer(struct ntrip_client *ntrip_client_data)
 bool ntrip_client(void)
 {
     bool error = false;
-    uint16_t counter = 0;
-    char data[2048];
+    int counter = 0;
+    uint8_t data[2048];
 
     esp_task_wdt_reset();
-    if (wifi_client.connected() == true)
+    if (ntrip_client_wifi_client.connected() == true)
     {
         counter = 0;
-        while (wifi_client.available() > 0)
+        if (ntrip_client_wifi_client.available() > 0) counter = ntrip_client_wifi_client.read(data, sizeof(data));
+        if (counter > 0)
         {
-            data[counter] = (char)wifi_client.read();
-            counter = counter + 1;
-            if (counter == sizeof(data))
-            {
-                error = true;
-                break;
-            }
+            error = correction_push(CORRECTION_SOURCE_NTRIP, data, (uint16_t)counter);
+            ntrip_client_timestamp = millis();
         }
-        if ((counter > 0) && (error == false)) error = !gnss_serial.pushRawData((uint8_t *)data, counter, true);
-        if ((unsigned long)(millis() - timeout) > 10000) error = true;
+        else if ((unsigned long)(millis() - ntrip_client_timestamp) > NTRIP_CLIENT_TIMEOUT) error = true;
     }
     else error = true;
-    if (error == true)
-    {
-        if (wifi_client.connected() == true) wifi_client.stop();
-        delay(5000);
-    }
-    else timeout = millis();
+    if ((error == true) && (ntrip_client_wifi_client.connected() == true)) ntrip_client_wifi_client.stop();
 
     return error;
 }
@@ -117,11 +103,11 @@ bool ntrip_client_init(struct sd_card_config2 *sd_card_config2_data)
     char data[512];
     char temp[128];
     char user_credentials[sizeof(sd_card_config2_data->ntrip_user) + sizeof(sd_card_config2_data->ntrip_password) + 1];
-    base64 base;
-    String encoded_credentials_str;
+    unsigned char encoded_credentials[((sizeof(user_credentials) + 2) / 3) * 4 + 1];
+    size_t encoded_length = 0;
 
     esp_task_wdt_reset();
-    if (wifi_client.connect(sd_card_config2_data->ntrip_server, sd_card_config2_data->ntrip_port) == true) 
+    if (ntrip_client_wifi_client.connect(sd_card_config2_data->ntrip_server, sd_card_config2_data->ntrip_port) == true) 
     {
         snprintf(data, sizeof(data), "GET /%s HTTP/1.0\r\n", sd_card_config2_data->ntrip_mount_point);
         snprintf(temp, sizeof(temp), "User-Agent: M5Stack Core2\r\n");
@@ -136,29 +122,32 @@ bool ntrip_client_init(struct sd_card_config2 *sd_card_config2_data)
         else
         {
             snprintf(user_credentials, sizeof(user_credentials), "%s:%s", sd_card_config2_data->ntrip_user, sd_card_config2_data->ntrip_password);
-            encoded_credentials_str = base.encode(user_credentials);
-            char encoded_credentials[encoded_credentials_str.length() + 1];
-            encoded_credentials_str.toCharArray(encoded_credentials, sizeof(encoded_credentials));
+            mbedtls_base64_encode(encoded_credentials, sizeof(encoded_credentials), &encoded_length, (const unsigned char *)user_credentials, strlen(user_credentials));
+            encoded_credentials[encoded_length] = '\0';
             snprintf(temp, sizeof(temp), "Authorization: Basic %s\r\n", encoded_credentials);
             strncat(data, temp, sizeof(data) - 1);
         }
-        wifi_client.write(data, strlen(data));
-        wifi_client.print("\r\n");
-        if (wifi_client.connected() == true)
+        ntrip_client_wifi_client.write(data, strlen(data));
+        ntrip_client_wifi_client.print("\r\n");
+        if (ntrip_client_wifi_client.connected() == true)
         {
-            timeout = millis();
+            ntrip_client_timestamp = millis();
             do
             {
-                if ((unsigned long)(millis() - timeout) > 5000) error = true;
-                else error = false;
+                if ((unsigned long)(millis() - ntrip_client_timestamp) > 5000) error = true;
+                else
+                {
+                    error = false;
+                    if (ntrip_client_wifi_client.available() == 0) delay(1);
+                }
             }
-            while ((wifi_client.available() == 0) && (error == false));
+            while ((ntrip_client_wifi_client.available() == 0) && (error == false));
             if (error == false)
             {
                 counter = 0;
-                while (wifi_client.available() > 0)
+                while (ntrip_client_wifi_client.available() > 0)
                 {
-                    data[counter] = (char)wifi_client.read();
+                    data[counter] = (char)ntrip_client_wifi_client.read();
                     counter = counter + 1;
                     if (strstr(data, "200 OK\r\n") != nullptr)
                     {
@@ -179,10 +168,13 @@ bool ntrip_client_init(struct sd_card_config2 *sd_card_config2_data)
     else error = true;
     if (error == true)
     {
-        if (wifi_client.connected() == true) wifi_client.stop();
-        delay(5000);
+        if (ntrip_client_wifi_client.connected() == true) ntrip_client_wifi_client.stop();
+    }
+    else
+    {
+        correction_connect();
+        ntrip_client_timestamp = millis();
     }
-    else timeout = millis();
 
     return error;
 }
@@ -0,0 +1,293 @@
+/**
+ * @file output.cpp
+ *
+ * @brief Output related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include "output.h"
+#include "output_hub.h"
+#include "uart_reader.h"
+
+/*
+ * The NMEA sentences of the UART reader are collected per navigation epoch
+ * and published once into the output hub. With the UBX source the receiver
+ * sends no NMEA, the sentences are formatted from the decoded UBX epoch
+ * instead, once per precision used by a sink. Bluetooth serial, Bluetooth LE,
+ * the TCP server and the USB serial read the epochs in place with their own
+ * sentence filter and decimation, a slow sink only drops its own epochs.
+ * A sink with blocking writes runs in its own task and is woken by a task
+ * notification after every publish.
+ *
+ * The USB serial also carries the log. With the USB sink enabled, the log
+ * ends after the startup: Serial is closed, so every later print is dropped,
+ * and the sink writes through its own instance of the same UART.
+ */
+
+portMUX_TYPE output_taskmux = portMUX_INITIALIZER_UNLOCKED;
+struct output_hub output_hub_data;
+uint8_t output_hub_buffer[OUTPUT_HUB_SIZE];
+uint8_t output_epoch[OUTPUT_EPOCH];
+uint16_t output_epoch_length = 0;
+uint32_t output_epoch_timestamp = 0;
+char output_epoch_time[12];
+uint32_t output_sentence_timestamp = 0;
+uint32_t output_bytes = 0;
+bool output_usb_enable = false;
+uint8_t output_source = OUTPUT_SOURCE_RECEIVER;
+uint32_t output_sentences = OUTPUT_HUB_SENTENCE_ALL;
+uint32_t output_variants = 0;
+char output_format_buffer[OUTPUT_EPOCH];
+struct output_hub_sink output_usb_sink;
+HardwareSerial output_usb_serial(0);
+TaskHandle_t output_subscribers[OUTPUT_SUBSCRIBERS];
+uint8_t output_subscriber_count = 0;
+
+/**
+ * @brief Wake the tasks of the subscribed sinks
+ */
+void output_notify(void)
+{
+    uint8_t counter = 0;
+    uint8_t count = __atomic_load_n(&output_subscriber_count, __ATOMIC_ACQUIRE);
+
+    for (counter = 0; counter < count; counter = counter + 1) xTaskNotifyGive(output_subscribers[counter]);
+}
+
+/**
+ * @brief Subscribe a task to a notification after every published epoch
+ * @param [in] handle
+ * @return error
+ */
+bool output_subscribe(TaskHandle_t handle)
+{
+    if (output_subscriber_count >= OUTPUT_SUBSCRIBERS) return true;
+    output_subscribers[output_subscriber_count] = handle;
+    __atomic_store_n(&output_subscriber_count, output_subscriber_count + 1, __ATOMIC_RELEASE);
+
+    return false;
+}
+
+/**
+ * @brief Publish the collected epoch to the output hub (called in the UART reader task)
+ */
+void output_publish(void)
+{
+    if (output_epoch_length == 0) return;
+    output_hub_publish(&output_hub_data, output_epoch, output_epoch_length, output_epoch_timestamp, OUTPUT_HUB_VARIANT_ALL);
+
+    portENTER_CRITICAL(&output_taskmux);
+    output_bytes = output_bytes + output_epoch_length;
+    portEXIT_CRITICAL(&output_taskmux);
+    output_epoch_length = 0;
+    output_notify();
+}
+
+/**
+ * @brief Collect a NMEA sentence of the UART reader into the actual epoch (called in the UART reader task)
+ * @param [in] sentence, length (0 after every drain of the UART), timestamp
+ */
+void output_sink(const char *sentence, uint8_t length, uint32_t timestamp)
+{
+    char time[sizeof(output_epoch_time)];
+    uint8_t counter = 0;
+
+    if (output_source != OUTPUT_SOURCE_RECEIVER) return;
+    if (length == 0)
+    {
+        if ((output_epoch_length > 0) && ((uint32_t)(timestamp - output_sentence_timestamp) > OUTPUT_EPOCH_IDLE)) output_publish();
+        return;
+    }
+    time[0] = '\0';
+    if ((strncmp(&sentence[3], "GGA,", 4) == 0) || (strncmp(&sentence[3], "RMC,", 4) == 0) || (strncmp(&sentence[3], "GST,", 4) == 0))
+    {
+        for (counter = 0; (counter < (sizeof(time) - 1)) && ((counter + 7) < length) && (sentence[counter + 7] != ','); counter = counter + 1) time[counter] = sentence[counter + 7];
+        time[counter] = '\0';
+    }
+    if ((time[0] != '\0') && (strcmp(time, output_epoch_time) != 0))
+    {
+        output_publish();
+        strcpy(output_epoch_time, time);
+    }
+    if ((output_epoch_length + length) > sizeof(output_epoch)) output_publish();
+    if (output_epoch_length == 0) output_epoch_timestamp = timestamp;
+    memcpy(&output_epoch[output_epoch_length], sentence, length);
+    output_epoch_length = output_epoch_length + length;
+    output_sentence_timestamp = timestamp;
+}
+
+/**
+ * @brief Format and publish an epoch decoded from UBX (called in the GNSS task)
+ * @param [in] nmea_epoch_data, satellites (new satellite data for GSV)
+ */
+void output_nmea(const struct nmea_epoch *nmea_epoch_data, bool satellites)
+{
+    uint32_t sentences = output_sentences;
+    uint32_t variants = 0;
+    uint32_t timestamp = millis();
+    uint8_t precision = 0;
+    uint16_t length = 0;
+
+    if (output_source != OUTPUT_SOURCE_UBX) return;
+    if (satellites == false) sentences = sentences & ~OUTPUT_HUB_SENTENCE_GSV;
+    variants = __atomic_load_n(&output_variants, __ATOMIC_ACQUIRE);
+    for (precision = NMEA_FORMAT_PRECISION_STANDARD; precision <= NMEA_FORMAT_PRECISION_HIGH; precision = precision + 1)
+    {
+        if ((variants & ((uint32_t)1 << precision)) == 0) continue;
+        length = nmea_format(nmea_epoch_data, sentences, precision, output_format_buffer, sizeof(output_format_buffer));
+        if (length == 0) continue;
+        output_hub_publish(&output_hub_data, (const uint8_t *)output_format_buffer, length, timestamp, (uint32_t)1 << precision);
+
+        portENTER_CRITICAL(&output_taskmux);
+        output_bytes = output_bytes + length;
+        portEXIT_CRITICAL(&output_taskmux);
+    }
+    output_notify();
+}
+
+/**
+ * @brief Get the next run of sentences of a sink in place
+ * @param [in,out] output_hub_sink_data
+ * @param [out] data, end (last run of the epoch), timestamp
+ * @return length of the run, 0 if nothing is pending
+ */
+uint32_t output_peek(struct output_hub_sink *output_hub_sink_data, const uint8_t **data, bool *end, uint32_t *timestamp)
+{
+    return output_hub_peek(&output_hub_data, output_hub_sink_data, data, end, timestamp);
+}
+
+/**
+ * @brief Release a used part of the run returned by output_peek
+ * @param [in,out] output_hub_sink_data
+ * @param [in] length
+ * @return error (the data was overwritten while it was used)
+ */
+bool output_consume(struct output_hub_sink *output_hub_sink_data, uint32_t length)
+{
+    return output_hub_consume(&output_hub_data, output_hub_sink_data, length);
+}
+
+/**
+ * @brief Initialize a sink of the output hub
+ * @param [out] output_hub_sink_data
+ * @param [in] sentences (like "GGA,RMC" or "all"), decimation (every n-th epoch), precision (NMEA_FORMAT_PRECISION_x)
+ */
+void output_sink_init(struct output_hub_sink *output_hub_sink_data, const char *sentences, uint8_t decimation, uint8_t precision)
+{
+    __atomic_fetch_or(&output_variants, (uint32_t)1 << precision, __ATOMIC_RELEASE);
+    output_hub_sink_init(&output_hub_data, output_hub_sink_data, output_hub_filter(sentences), (uint32_t)1 << precision, decimation);
+}
+
+/**
+ * @brief Transfer data from the output
+ * @param [in] output_data
+ */
+void output_transfer(struct output *output_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static uint32_t last_bytes = 0;
+    uint32_t bytes = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&output_taskmux);
+        bytes = output_bytes;
+        portEXIT_CRITICAL(&output_taskmux);
+        output_data->epochs = output_hub_data.epochs;
+        output_data->overflows = output_hub_data.overflows;
+        output_data->bytes_per_second = (uint32_t)((uint64_t)(bytes - last_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        output_data->usb_drops = output_usb_sink.drops;
+        output_data->update = true;
+        last_bytes = bytes;
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Write the epochs to the USB serial as far as its transmit buffer allows
+ */
+void output_usb(void)
+{
+    const uint8_t *data = nullptr;
+    bool end = false;
+    uint32_t timestamp = 0;
+    uint32_t length = 0;
+    int space = 0;
+
+    esp_task_wdt_reset();
+    if (__atomic_load_n(&output_usb_enable, __ATOMIC_ACQUIRE) == false) return;
+    while (1)
+    {
+        length = output_peek(&output_usb_sink, &data, &end, &timestamp);
+        if (length == 0) break;
+        space = output_usb_serial.availableForWrite();
+        if (space <= 0) break;
+        if (length > (uint32_t)space) length = (uint32_t)space;
+        output_usb_serial.write(data, length);
+        output_consume(&output_usb_sink, length);
+    }
+}
+
+/**
+ * @brief Hand the USB serial over from the log to the USB sink (called at the end of the startup)
+ * @param [in] sd_card_config2_data
+ */
+void output_usb_start(struct sd_card_config2 *sd_card_config2_data)
+{
+    esp_task_wdt_reset();
+    if (sd_card_config2_data->output_usb_enable != 1) return;
+    Serial.print(F("Switch USB serial to the NMEA output, log off... ok\n"));
+    Serial.flush();
+    Serial.end();
+    output_usb_serial.begin(OUTPUT_USB_BAUD);
+    __atomic_store_n(&output_usb_enable, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Initialize the output hub and the USB serial sink
+ * @param [in] output_data, sd_card_config2_data
+ * @return error
+ */
+bool output_init(struct output *output_data, struct sd_card_config2 *sd_card_config2_data)
+{
+    esp_task_wdt_reset();
+    output_hub_init(&output_hub_data, output_hub_buffer, sizeof(output_hub_buffer));
+    output_epoch_time[0] = '\0';
+    output_source = sd_card_config2_data->nmea_source;
+    output_sentences = output_hub_filter(sd_card_config2_data->nmea_sentences);
+    if (sd_card_config2_data->output_usb_enable == 1) output_sink_init(&output_usb_sink, sd_card_config2_data->output_usb_sentences, sd_card_config2_data->output_usb_decimation, sd_card_config2_data->output_usb_precision);
+    output_data->epochs = 0;
+    output_data->bytes_per_second = 0;
+    output_data->overflows = 0;
+    output_data->usb_drops = 0;
+    output_data->update = true;
+
+    return uart_reader_subscribe(output_sink);
+}
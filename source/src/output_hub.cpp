@@ -0,0 +1,321 @@
+/**
+ * @file output_hub.cpp
+ *
+ * @brief Output hub related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "output_hub.h"
+
+/*
+ * Single producer, multiple consumer broadcast buffer. The producer copies
+ * every epoch once into the buffer as a record (length, time stamp, variant,
+ * NMEA sentences) and never waits for a sink. A sink reads only the records
+ * of its variant (e.g. the NMEA precision), so an epoch can be published in
+ * several formats. Every sink has its own read
+ * position and reads the records in place, a sink that falls more than the
+ * buffer size behind is moved to the newest epoch and counts a drop.
+ *
+ * reserve is raised before the producer overwrites old records, so a sink
+ * can check after reading a record header or using a record that it was not
+ * overwritten meanwhile. The producer can lap a sink on the other core at
+ * any time, so a header is only trusted after this check.
+ * The size must be a power of two, all positions are free running and
+ * records are aligned to 16 bytes, so a pad header always fits at the end.
+ */
+
+static const char *output_hub_sentence_text[10] = {"GGA", "GLL", "GSA", "GST", "GSV", "RMC", "VTG", "ZDA", "GNS", "TXT"};
+
+/**
+ * @brief Load a 32 bit value of a record header
+ * @param [in] data
+ * @return value
+ */
+static uint32_t output_hub_get32(const uint8_t *data)
+{
+    uint32_t value = 0;
+
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+/**
+ * @brief Check if the producer has overwritten the record at the read position of a sink
+ * @param [in] output_hub_data, output_hub_sink_data
+ * @return true if overwritten
+ */
+static bool output_hub_overwritten(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return ((uint32_t)(__atomic_load_n(&output_hub_data->reserve, __ATOMIC_ACQUIRE) - output_hub_sink_data->tail) > output_hub_data->size);
+}
+
+/**
+ * @brief Move a lapped sink to the newest epoch and count a drop
+ * @param [in] output_hub_data
+ * @param [in,out] output_hub_sink_data
+ */
+static void output_hub_resync(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data)
+{
+    output_hub_sink_data->tail = __atomic_load_n(&output_hub_data->last, __ATOMIC_ACQUIRE);
+    output_hub_sink_data->offset = 0;
+    output_hub_sink_data->started = false;
+    output_hub_sink_data->drops = output_hub_sink_data->drops + 1;
+}
+
+/**
+ * @brief Get the sentence bit of a NMEA sentence
+ * @param [in] sentence, length
+ * @return OUTPUT_HUB_SENTENCE_x
+ */
+uint32_t output_hub_sentence(const uint8_t *sentence, uint32_t length)
+{
+    uint8_t counter = 0;
+
+    if ((length < 7) || (sentence[0] != '$') || (sentence[1] == 'P')) return OUTPUT_HUB_SENTENCE_OTHER;
+    for (counter = 0; counter < 10; counter = counter + 1)
+    {
+        if (memcmp(&sentence[3], output_hub_sentence_text[counter], 3) == 0) return (uint32_t)1 << counter;
+    }
+
+    return OUTPUT_HUB_SENTENCE_OTHER;
+}
+
+/**
+ * @brief Get the sentence filter of a list like "GGA,RMC" or "all"
+ * @param [in] list
+ * @return filter
+ */
+uint32_t output_hub_filter(const char *list)
+{
+    uint32_t filter = 0;
+    uint8_t counter = 0;
+
+    if (strncmp(list, "all", 3) == 0) return OUTPUT_HUB_SENTENCE_ALL;
+    while (*list != '\0')
+    {
+        for (counter = 0; counter < 10; counter = counter + 1)
+        {
+            if (strncmp(list, output_hub_sentence_text[counter], 3) == 0) filter = filter | ((uint32_t)1 << counter);
+        }
+        while ((*list != '\0') && (*list != ',')) list = list + 1;
+        if (*list == ',') list = list + 1;
+    }
+
+    return filter;
+}
+
+/**
+ * @brief Publish one epoch to all sinks of the variant
+ * @param [in,out] output_hub_data
+ * @param [in] data, length, timestamp, variant (bit mask)
+ * @return error
+ */
+bool output_hub_publish(struct output_hub *output_hub_data, const uint8_t *data, uint32_t length, uint32_t timestamp, uint32_t variant)
+{
+    uint32_t position = output_hub_data->head;
+    uint32_t offset = 0;
+    uint32_t remain = 0;
+    uint32_t aligned = (OUTPUT_HUB_HEADER + length + 15) & ~(uint32_t)15;
+    uint32_t pad = OUTPUT_HUB_PAD;
+
+    if (aligned > (output_hub_data->size / 2))
+    {
+        output_hub_data->overflows = output_hub_data->overflows + 1;
+        return true;
+    }
+    offset = position & (output_hub_data->size - 1);
+    remain = output_hub_data->size - offset;
+    if (remain < aligned)
+    {
+        __atomic_store_n(&output_hub_data->reserve, position + remain, __ATOMIC_RELEASE);
+        memcpy(&output_hub_data->data[offset], &pad, sizeof(pad));
+        position = position + remain;
+        offset = 0;
+    }
+    __atomic_store_n(&output_hub_data->reserve, position + aligned, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    memcpy(&output_hub_data->data[offset], &length, sizeof(length));
+    memcpy(&output_hub_data->data[offset + 4], &timestamp, sizeof(timestamp));
+    memcpy(&output_hub_data->data[offset + 8], &variant, sizeof(variant));
+    memcpy(&output_hub_data->data[offset + OUTPUT_HUB_HEADER], data, length);
+    __atomic_store_n(&output_hub_data->last, position, __ATOMIC_RELEASE);
+    __atomic_store_n(&output_hub_data->head, position + aligned, __ATOMIC_RELEASE);
+    output_hub_data->epochs = output_hub_data->epochs + 1;
+
+    return false;
+}
+
+/**
+ * @brief Move over the sentences of a record that match or not match the filter
+ * @param [in] record, position, length, filter, match
+ * @return position after the sentences
+ */
+static uint32_t output_hub_skip(const uint8_t *record, uint32_t position, uint32_t length, uint32_t filter, bool match)
+{
+    while ((position < length) && (((output_hub_sentence(&record[position], length - position) & filter) != 0) == match))
+    {
+        while ((position < length) && (record[position] != '\n')) position = position + 1;
+        if (position < length) position = position + 1;
+    }
+
+    return position;
+}
+
+/**
+ * @brief Get the next run of filtered sentences of a sink in place
+ * @param [in] output_hub_data
+ * @param [in,out] output_hub_sink_data
+ * @param [out] data, end (last run of the epoch), timestamp
+ * @return length of the run, 0 if nothing is pending
+ */
+uint32_t output_hub_peek(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data, const uint8_t **data, bool *end, uint32_t *timestamp)
+{
+    uint32_t head = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    uint32_t stamp = 0;
+    uint32_t variant = 0;
+    uint32_t start = 0;
+    uint32_t position = 0;
+    const uint8_t *record = nullptr;
+
+    while (1)
+    {
+        head = __atomic_load_n(&output_hub_data->head, __ATOMIC_ACQUIRE);
+        if (output_hub_sink_data->tail == head) return 0;
+        if (((uint32_t)(head - output_hub_sink_data->tail) > output_hub_data->size) || (output_hub_overwritten(output_hub_data, output_hub_sink_data) == true))
+        {
+            output_hub_resync(output_hub_data, output_hub_sink_data);
+            continue;
+        }
+        offset = output_hub_sink_data->tail & (output_hub_data->size - 1);
+        length = output_hub_get32(&output_hub_data->data[offset]);
+        stamp = output_hub_get32(&output_hub_data->data[offset + 4]);
+        variant = output_hub_get32(&output_hub_data->data[offset + 8]);
+        if ((output_hub_overwritten(output_hub_data, output_hub_sink_data) == true) ||
+            ((length != OUTPUT_HUB_PAD) && ((length > (output_hub_data->size / 2)) || ((offset + OUTPUT_HUB_HEADER + length) > output_hub_data->size))))
+        {
+            output_hub_resync(output_hub_data, output_hub_sink_data);
+            continue;
+        }
+        if (length == OUTPUT_HUB_PAD)
+        {
+            output_hub_sink_data->tail = output_hub_sink_data->tail + (output_hub_data->size - offset);
+            continue;
+        }
+        record = &output_hub_data->data[offset + OUTPUT_HUB_HEADER];
+        if ((variant & output_hub_sink_data->variant) == 0)
+        {
+            output_hub_sink_data->tail = output_hub_sink_data->tail + ((OUTPUT_HUB_HEADER + length + 15) & ~(uint32_t)15);
+            continue;
+        }
+        if (output_hub_sink_data->started == false)
+        {
+            output_hub_sink_data->started = true;
+            output_hub_sink_data->decimation_counter = output_hub_sink_data->decimation_counter + 1;
+            if (output_hub_sink_data->decimation_counter < output_hub_sink_data->decimation) output_hub_sink_data->offset = length;
+            else output_hub_sink_data->decimation_counter = 0;
+        }
+        start = output_hub_skip(record, output_hub_sink_data->offset, length, output_hub_sink_data->filter, false);
+        if (start >= length)
+        {
+            if (output_hub_sink_data->decimation_counter == 0) output_hub_sink_data->epochs = output_hub_sink_data->epochs + 1;
+            output_hub_sink_data->tail = output_hub_sink_data->tail + ((OUTPUT_HUB_HEADER + length + 15) & ~(uint32_t)15);
+            output_hub_sink_data->offset = 0;
+            output_hub_sink_data->started = false;
+            continue;
+        }
+        position = output_hub_skip(record, start, length, output_hub_sink_data->filter, true);
+        output_hub_sink_data->offset = start;
+        *data = &record[start];
+        *end = (output_hub_skip(record, position, length, output_hub_sink_data->filter, false) >= length);
+        *timestamp = stamp;
+
+        return position - start;
+    }
+}
+
+/**
+ * @brief Release a used part of the run returned by output_hub_peek
+ * @param [in] output_hub_data
+ * @param [in,out] output_hub_sink_data
+ * @param [in] length
+ * @return error (the data was overwritten while it was used)
+ */
+bool output_hub_consume(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data, uint32_t length)
+{
+    bool error = false;
+
+    if (output_hub_overwritten(output_hub_data, output_hub_sink_data) == true)
+    {
+        output_hub_sink_data->drops = output_hub_sink_data->drops + 1;
+        error = true;
+    }
+    output_hub_sink_data->offset = output_hub_sink_data->offset + length;
+    output_hub_sink_data->bytes = output_hub_sink_data->bytes + length;
+
+    return error;
+}
+
+/**
+ * @brief Initialize a sink at the actual end of the output hub
+ * @param [in] output_hub_data
+ * @param [out] output_hub_sink_data
+ * @param [in] filter, variant (bit mask), decimation
+ */
+void output_hub_sink_init(struct output_hub *output_hub_data, struct output_hub_sink *output_hub_sink_data, uint32_t filter, uint32_t variant, uint8_t decimation)
+{
+    output_hub_sink_data->tail = __atomic_load_n(&output_hub_data->head, __ATOMIC_ACQUIRE);
+    output_hub_sink_data->offset = 0;
+    output_hub_sink_data->started = false;
+    output_hub_sink_data->filter = filter;
+    output_hub_sink_data->variant = variant;
+    if (decimation == 0) decimation = 1;
+    output_hub_sink_data->decimation = decimation;
+    output_hub_sink_data->decimation_counter = decimation - 1;
+    output_hub_sink_data->epochs = 0;
+    output_hub_sink_data->bytes = 0;
+    output_hub_sink_data->drops = 0;
+}
+
+/**
+ * @brief Initialize the output hub
+ * @param [in] output_hub_data, data, size
+ */
+void output_hub_init(struct output_hub *output_hub_data, uint8_t *data, uint32_t size)
+{
+    output_hub_data->data = data;
+    output_hub_data->size = size;
+    output_hub_data->head = 0;
+    output_hub_data->reserve = 0;
+    output_hub_data->last = 0;
+    output_hub_data->epochs = 0;
+    output_hub_data->overflows = 0;
+}
@@ -37,6 +37,9 @@
 #include "wlan_client.h"
 #include "assist_now_client.h"
 #include "ntrip_client.h"
+#include "correction.h"
+#include "base_station.h"
+#include "diagnostics.h"
 
 const char static PROGMEM weekday_text_0[] =  "Sunday";
 const char static PROGMEM weekday_text_1[] =  "Monday";
@@ -61,13 +64,25 @@ const char static PROGMEM month_text_10[] =  "Nov.";
 const char static PROGMEM month_text_11[] =  "Dec.";
 const char* const PROGMEM month_text[]  = {month_text_0, month_text_1, month_text_2, month_text_3, month_text_4, month_text_5, month_text_6, month_text_7, month_text_8, month_text_9, month_text_10, month_text_11};
 
+const char static PROGMEM task_text_0[] =  "UART";
+const char static PROGMEM task_text_1[] =  "GNSS";
+const char static PROGMEM task_text_2[] =  "Network";
+const char static PROGMEM task_text_3[] =  "UI";
+const char static PROGMEM task_text_4[] =  "Bluetooth";
+const char static PROGMEM task_text_5[] =  "Connect";
+const char* const PROGMEM task_text[]  = {task_text_0, task_text_1, task_text_2, task_text_3, task_text_4, task_text_5};
+
+TFT_eSprite page_sprite = TFT_eSprite(&M5.Lcd);
+
 /**
  * @brief Show the Meteotime pages
- * @param [in] sd_card_config1_data, button, real_time_clock_data, battery_data, gnss_data, bluetooth_serial_data, wlan_client_data, assist_now_client_data, ntrip_client_data
+ * @param [in] sd_card_config1_data, button, real_time_clock_data, battery_data, gnss_data, bluetooth_serial_data, wlan_client_data, assist_now_client_data, ntrip_client_data, correction_data, base_station_data, diagnostics_data
+ * @return true if a page was drawn
  */
-void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real_time_clock *real_time_clock_data, struct battery *battery_data, struct gnss *gnss_data, struct bluetooth_serial *bluetooth_serial_data, struct wlan_client *wlan_client_data, struct assist_now_client *assist_now_client_data, struct ntrip_client *ntrip_client_data)
+bool page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real_time_clock *real_time_clock_data, struct battery *battery_data, struct gnss *gnss_data, struct bluetooth_serial *bluetooth_serial_data, struct wlan_client *wlan_client_data, struct assist_now_client *assist_now_client_data, struct ntrip_client *ntrip_client_data, struct correction *correction_data, struct base_station *base_station_data, struct diagnostics *diagnostics_data)
 {
     uint8_t counter = 0;
+    bool drawn = false;
     unsigned long curr_millis = 0;
     static unsigned long last_millis = millis();
     static bool play = (bool)sd_card_config1_data->display_play;
@@ -81,6 +96,9 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
     struct page_navigation2 page_navigation2_data;
     struct page_relative_navigation page_relative_navigation_data;
     struct page_satellite_info page_satellite_info_data;
+    struct page_correction page_correction_data;
+    struct page_base_station page_base_station_data;
+    struct page_diagnostics page_diagnostics_data;
     time_t timestamp = (time_t)0;
     struct tm timestamp_data;
     static double rel_pos_length_offset = 0.0;
@@ -133,6 +151,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
             page_clock_data.timestamp = timestamp;
             page_clock_data.gnss_fix_ok = real_time_clock_data->gnss_fix_ok;
             page_clock(&page_clock_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             real_time_clock_data->timestamp = timestamp;
@@ -152,6 +171,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
             page_status1_data.gnss_carr_soln = gnss_data->carr_soln;
             page_status1_data.gnss_num_sv = gnss_data->num_sv;
             page_status1(&page_status1_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             wlan_client_data->update = false;
@@ -171,6 +191,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
             page_status2_data.battery_level = roundf(battery_data->level);
             page_status2_data.battery_charging = battery_data->charging;
             page_status2(&page_status2_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -189,6 +210,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
             page_navigation1_data.gnss_lat = gnss_data->lat;
             page_navigation1_data.gnss_height = gnss_data->height;
             page_navigation1(&page_navigation1_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -205,6 +227,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
             page_navigation2_data.gnss_head_mot = gnss_data->head_mot;
             page_navigation2_data.gnss_p_acc = gnss_data->p_acc;
             page_navigation2(&page_navigation2_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -221,6 +244,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
             page_relative_navigation_data.gnss_rel_pos_length = gnss_data->rel_pos_length - rel_pos_length_offset;
             page_relative_navigation_data.gnss_acc_length = gnss_data->acc_length;
             page_relative_navigation(&page_relative_navigation_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -240,6 +264,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
                 page_satellite_info_data.gnss_satellite_info_data[counter].sv_used = gnss_data->gnss_satellite_info_gps_data[counter].sv_used;
             }
             page_satellite_info(&page_satellite_info_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -259,6 +284,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
                 page_satellite_info_data.gnss_satellite_info_data[counter].sv_used = gnss_data->gnss_satellite_info_galileo_data[counter].sv_used;
             }
             page_satellite_info(&page_satellite_info_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -278,6 +304,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
                 page_satellite_info_data.gnss_satellite_info_data[counter].sv_used = gnss_data->gnss_satellite_info_glonass_data[counter].sv_used;
             }
             page_satellite_info(&page_satellite_info_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -297,6 +324,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
                 page_satellite_info_data.gnss_satellite_info_data[counter].sv_used = gnss_data->gnss_satellite_info_beidou_data[counter].sv_used;
             }
             page_satellite_info(&page_satellite_info_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
@@ -316,15 +344,98 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
                 page_satellite_info_data.gnss_satellite_info_data[counter].sv_used = gnss_data->gnss_satellite_info_sbas_data[counter].sv_used;
             }
             page_satellite_info(&page_satellite_info_data);
+            drawn = true;
             page_counter_last = page_counter;
             play_last = play;
             gnss_data->update = false;
         }
         break;
 
+        case 11:
+        if ((page_counter != page_counter_last) || (play != play_last) || (ntrip_client_data->update == true) || (correction_data->update == true))
+        {
+            page_correction_data.actual_page = page_counter;
+            page_correction_data.play = play;
+            page_correction_data.ntrip_client_active = ntrip_client_data->active;
+            page_correction_data.bytes_per_second = correction_data->bytes_per_second;
+            page_correction_data.age = correction_data->age;
+            page_correction_data.reconnects = correction_data->reconnects;
+            page_correction_data.frames = correction_data->frames;
+            page_correction_data.frame_errors = correction_data->frame_errors;
+            for (counter = 0; counter < CORRECTION_GAP_BUCKETS; counter = counter + 1) page_correction_data.gap_histogram[counter] = correction_data->gap_histogram[counter];
+            for (counter = 0; counter < CORRECTION_MESSAGE_TYPES; counter = counter + 1)
+            {
+                page_correction_data.message_types[counter].type = correction_data->message_types[counter].type;
+                page_correction_data.message_types[counter].count = correction_data->message_types[counter].count;
+            }
+            page_correction_data.source = correction_data->source;
+            page_correction(&page_correction_data);
+            drawn = true;
+            page_counter_last = page_counter;
+            play_last = play;
+            ntrip_client_data->update = false;
+            correction_data->update = false;
+        }
+        break;
+
+        case 12:
+        if ((page_counter != page_counter_last) || (play != play_last) || (base_station_data->update == true))
+        {
+            page_base_station_data.actual_page = page_counter;
+            page_base_station_data.play = play;
+            page_base_station_data.mode = base_station_data->mode;
+            page_base_station_data.survey_in_active = base_station_data->survey_in_active;
+            page_base_station_data.survey_in_valid = base_station_data->survey_in_valid;
+            page_base_station_data.survey_in_duration = base_station_data->survey_in_duration;
+            page_base_station_data.survey_in_accuracy = base_station_data->survey_in_accuracy;
+            page_base_station_data.server_active = base_station_data->server_active;
+            page_base_station_data.bytes_per_second = base_station_data->bytes_per_second;
+            page_base_station_data.frames = base_station_data->frames;
+            page_base_station_data.drops = base_station_data->drops;
+            page_base_station(&page_base_station_data);
+            drawn = true;
+            page_counter_last = page_counter;
+            play_last = play;
+            base_station_data->update = false;
+        }
+        break;
+
+        case 13:
+        if ((page_counter != page_counter_last) || (play != play_last) || (diagnostics_data->update == true))
+        {
+            page_diagnostics_data.actual_page = page_counter;
+            page_diagnostics_data.play = play;
+            page_diagnostics_data.reset_reason = diagnostics_data->reset_reason;
+            page_diagnostics_data.heap_free = diagnostics_data->heap_free;
+            page_diagnostics_data.heap_min = diagnostics_data->heap_min;
+            page_diagnostics_data.heap_largest = diagnostics_data->heap_largest;
+            page_diagnostics_data.heap_largest_min = diagnostics_data->heap_largest_min;
+            page_diagnostics_data.fragmentation = diagnostics_data->fragmentation;
+            page_diagnostics_data.alloc_failures = diagnostics_data->alloc_failures;
+            page_diagnostics_data.psram_free = diagnostics_data->psram_free;
+            page_diagnostics_data.psram_largest = diagnostics_data->psram_largest;
+            for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1)
+            {
+                page_diagnostics_data.load[counter] = diagnostics_data->load[counter];
+                page_diagnostics_data.load_max[counter] = diagnostics_data->load_max[counter];
+                page_diagnostics_data.stack_size[counter] = diagnostics_data->stack_size[counter];
+                page_diagnostics_data.stack_free[counter] = diagnostics_data->stack_free[counter];
+            }
+            page_diagnostics_data.frames_per_second = diagnostics_data->frames_per_second;
+            page_diagnostics_data.frame_time_max = diagnostics_data->frame_time_max;
+            page_diagnostics(&page_diagnostics_data);
+            drawn = true;
+            page_counter_last = page_counter;
+            play_last = play;
+            diagnostics_data->update = false;
+        }
+        break;
+
         default:
         break;
     }
+
+    return drawn;
 }
 
 /**
@@ -333,7 +444,7 @@ void page(struct sd_card_config1 *sd_card_config1_data, int *button, struct real
  */
 void page_clock(struct page_clock *page_clock_data)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
+    TFT_eSprite &tft = page_sprite;
     char string[40];
     char string1[20];
     char string2[20];
@@ -349,7 +460,6 @@ void page_clock(struct page_clock *page_clock_data)
  
     esp_task_wdt_reset(); 
     localtime_r(&(page_clock_data->timestamp), &timestamp_data);
-    tft.createSprite(320, 240);
     tft.fillSprite(NAVY);
     tft.setTextColor(WHITE);
     tft.setTextDatum(TL_DATUM);
@@ -447,7 +557,6 @@ void page_clock(struct page_clock *page_clock_data)
     }
 
     tft.pushSprite(0, 0);
-    tft.deleteSprite();
 }
 
 /**
@@ -456,11 +565,10 @@ void page_clock(struct page_clock *page_clock_data)
  */
 void page_status1(struct page_status1 *page_status1_data)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
+    TFT_eSprite &tft = page_sprite;
     char string[40];
 
     esp_task_wdt_reset();
-    tft.createSprite(320, 240);
     tft.fillSprite(NAVY);
     tft.setTextColor(WHITE);
     tft.setTextDatum(TL_DATUM);
@@ -655,7 +763,6 @@ void page_status1(struct page_status1 *page_status1_data)
     }
 
     tft.pushSprite(0, 0);
-    tft.deleteSprite();
 }
 
 /**
@@ -664,11 +771,10 @@ void page_status1(struct page_status1 *page_status1_data)
  */
 void page_status2(struct page_status2 *page_status2_data)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
+    TFT_eSprite &tft = page_sprite;
     char string[40];
 
     esp_task_wdt_reset();
-    tft.createSprite(320, 240);
     tft.fillSprite(NAVY);
     tft.setTextColor(WHITE);
     tft.setTextDatum(TL_DATUM);
@@ -809,7 +915,6 @@ void page_status2(struct page_status2 *page_status2_data)
     }
 
     tft.pushSprite(0, 0);
-    tft.deleteSprite();
 }
 
 /**
@@ -818,11 +923,10 @@ void page_status2(struct page_status2 *page_status2_data)
  */
 void page_navigation1(struct page_navigation1 *page_navigation1_data)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
+    TFT_eSprite &tft = page_sprite;
     char string[40];
 
     esp_task_wdt_reset();
-    tft.createSprite(320, 240);
     tft.fillSprite(NAVY);
     tft.setTextColor(WHITE);
     tft.setTextDatum(TL_DATUM);
@@ -907,7 +1011,6 @@ void page_navigation1(struct page_navigation1 *page_navigation1_data)
     }
 
     tft.pushSprite(0, 0);
-    tft.deleteSprite();
 }
 
 /**
@@ -916,11 +1019,10 @@ void page_navigation1(struct page_navigation1 *page_navigation1_data)
  */
 void page_navigation2(struct page_navigation2 *page_navigation2_data)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
+    TFT_eSprite &tft = page_sprite;
     char string[40];
 
     esp_task_wdt_reset();
-    tft.createSprite(320, 240);
     tft.fillSprite(NAVY);
     tft.setTextColor(WHITE);
     tft.setTextDatum(TL_DATUM);
@@ -1004,7 +1106,6 @@ void page_navigation2(struct page_navigation2 *page_navigation2_data)
     }
 
     tft.pushSprite(0, 0);
-    tft.deleteSprite();
 }
 
 
@@ -1014,11 +1115,10 @@ void page_navigation2(struct page_navigation2 *page_navigation2_data)
  */
 void page_relative_navigation(struct page_relative_navigation *page_relative_navigation_data)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
+    TFT_eSprite &tft = page_sprite;
     char string[40];
 
     esp_task_wdt_reset();
-    tft.createSprite(320, 240);
     tft.fillSprite(NAVY);
     tft.setTextColor(WHITE);
     tft.setTextDatum(TL_DATUM);
@@ -1085,7 +1185,6 @@ void page_relative_navigation(struct page_relative_navigation *page_relative_nav
     }
 
     tft.pushSprite(0, 0);
-    tft.deleteSprite();
 }
 
 /**
@@ -1094,14 +1193,13 @@ void page_relative_navigation(struct page_relative_navigation *page_relative_nav
  */
 void page_satellite_info(struct page_satellite_info *page_satellite_info_data)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
+    TFT_eSprite &tft = page_sprite;
     uint8_t counter = 0;
     char string[40];
     int32_t offset_x = 0;
     int32_t offset_y = 0;
 
     esp_task_wdt_reset();
-    tft.createSprite(320, 240);
     tft.fillSprite(NAVY);
     tft.setTextColor(WHITE);
     tft.setTextDatum(TL_DATUM);
@@ -1160,7 +1258,371 @@ void page_satellite_info(struct page_satellite_info *page_satellite_info_data)
     }
 
     tft.pushSprite(0, 0);
-    tft.deleteSprite();
+}
+
+/**
+ * @brief Show the correction page
+ * @param [in] page_correction_data
+ */
+void page_correction(struct page_correction *page_correction_data)
+{
+    TFT_eSprite &tft = page_sprite;
+    uint8_t counter = 0;
+    char string[40];
+    uint32_t gap_max = 1;
+    int32_t bar_height = 0;
+    const char *gap_text[CORRECTION_GAP_BUCKETS] = {"1.5", "3", "5", "10", "30", ">30"};
+    const char *source_text[CORRECTION_SOURCES] = {"NTRIP", "BT", "SD"};
+
+    esp_task_wdt_reset();
+    tft.fillSprite(NAVY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TL_DATUM);
+    tft.drawString(F("Correction"), 5, 5, 4);
+    if (page_correction_data->source < CORRECTION_SOURCES) tft.drawString(source_text[page_correction_data->source], 140, 10, 2);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TR_DATUM);
+    sprintf(string, "%u/%u", page_correction_data->actual_page + 1, PAGE_TOTAL);
+    tft.drawString(string, 315, 5, 4);
+
+    if (((page_correction_data->ntrip_client_active == true) || (page_correction_data->source != CORRECTION_SOURCE_NONE)) && (page_correction_data->bytes_per_second > 0))
+    {
+        tft.fillRoundRect(5, 40, 152, 38, 10, DARKGREEN);
+        tft.drawRoundRect(5, 40, 152, 38, 10, DARKGREY);
+    }
+    else
+    {
+        tft.fillRoundRect(5, 40, 152, 38, 10, DARKRED);
+        tft.drawRoundRect(5, 40, 152, 38, 10, DARKGREY);
+    }
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "%lu B/s", (unsigned long)page_correction_data->bytes_per_second);
+    tft.drawString(string, 81, 59, 4);
+
+    if (page_correction_data->age < 5000)
+    {
+        tft.fillRoundRect(5, 81, 152, 38, 10, DARKGREEN);
+        tft.drawRoundRect(5, 81, 152, 38, 10, DARKGREY);
+    }
+    else
+    {
+        tft.fillRoundRect(5, 81, 152, 38, 10, DARKRED);
+        tft.drawRoundRect(5, 81, 152, 38, 10, DARKGREY);
+    }
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    if (page_correction_data->age == UINT32_MAX) sprintf(string, "Age -");
+    else sprintf(string, "Age %.1f s", (float)page_correction_data->age * 1E-3f);
+    tft.drawString(string, 81, 100, 4);
+
+    if (page_correction_data->reconnects == 0)
+    {
+        tft.fillRoundRect(5, 122, 152, 38, 10, DARKGREEN);
+        tft.drawRoundRect(5, 122, 152, 38, 10, DARKGREY);
+    }
+    else
+    {
+        tft.fillRoundRect(5, 122, 152, 38, 10, ORANGE);
+        tft.drawRoundRect(5, 122, 152, 38, 10, DARKGREY);
+    }
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "Reconn. %lu", (unsigned long)page_correction_data->reconnects);
+    tft.drawString(string, 81, 141, 4);
+
+    if (page_correction_data->frame_errors == 0)
+    {
+        tft.fillRoundRect(5, 163, 152, 38, 10, DARKGREEN);
+        tft.drawRoundRect(5, 163, 152, 38, 10, DARKGREY);
+    }
+    else
+    {
+        tft.fillRoundRect(5, 163, 152, 38, 10, ORANGE);
+        tft.drawRoundRect(5, 163, 152, 38, 10, DARKGREY);
+    }
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "Err. %lu", (unsigned long)page_correction_data->frame_errors);
+    tft.drawString(string, 81, 182, 4);
+
+    tft.drawRoundRect(162, 40, 152, 79, 10, DARKGREY);
+    for (counter = 0; counter < CORRECTION_GAP_BUCKETS; counter = counter + 1)
+    {
+        if (page_correction_data->gap_histogram[counter] > gap_max) gap_max = page_correction_data->gap_histogram[counter];
+    }
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TC_DATUM);
+    for (counter = 0; counter < CORRECTION_GAP_BUCKETS; counter = counter + 1)
+    {
+        bar_height = (int32_t)((50.0f / (float)gap_max) * (float)page_correction_data->gap_histogram[counter]);
+        if (counter == 0) tft.fillRect(170 + counter * 24, 98 - bar_height, 16, bar_height, DARKGREEN);
+        else tft.fillRect(170 + counter * 24, 98 - bar_height, 16, bar_height, DARKRED);
+        tft.drawString(gap_text[counter], 178 + counter * 24, 102, 1);
+    }
+
+    tft.drawRoundRect(162, 122, 152, 79, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TL_DATUM);
+    for (counter = 0; counter < 8; counter = counter + 1)
+    {
+        if (page_correction_data->message_types[counter].type != 0)
+        {
+            sprintf(string, "%u:%lu", page_correction_data->message_types[counter].type, (unsigned long)(page_correction_data->message_types[counter].count % 100000));
+            tft.drawString(string, 168 + (counter / 4) * 74, 127 + (counter % 4) * 18, 2);
+        }
+    }
+
+    if (page_correction_data->actual_page > 0)
+    {
+        tft.drawLine(52, 213, 42, 223, WHITE);
+        tft.drawLine(42, 223, 52, 233, WHITE);
+        tft.drawLine(62, 213, 52, 223, WHITE);
+        tft.drawLine(52, 223, 62, 233, WHITE);
+    }
+    if (page_correction_data->play == true) tft.drawRect(150, 213, 20, 20, WHITE);
+    else
+    {
+        tft.drawLine(150, 213, 150, 233, WHITE);
+        tft.drawLine(150, 213, 170, 223, WHITE);
+        tft.drawLine(170, 223, 150, 233, WHITE);
+    }
+    if (page_correction_data->actual_page < PAGE_TOTAL - 1)
+    {
+        tft.drawLine(262, 213, 272, 223, WHITE);
+        tft.drawLine(272, 223, 262, 233, WHITE);
+        tft.drawLine(252, 213, 262, 223, WHITE);
+        tft.drawLine(262, 223, 252, 233, WHITE);
+    }
+
+    tft.pushSprite(0, 0);
+}
+
+/**
+ * @brief Show the base station
+ * @param [in] page_base_station_data
+ */
+void page_base_station(struct page_base_station *page_base_station_data)
+{
+    TFT_eSprite &tft = page_sprite;
+    char string[40];
+    uint16_t color = DARKRED;
+
+    esp_task_wdt_reset();
+    tft.fillSprite(NAVY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TL_DATUM);
+    tft.drawString(F("Base station"), 5, 5, 4);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TR_DATUM);
+    sprintf(string, "%u/%u", page_base_station_data->actual_page + 1, PAGE_TOTAL);
+    tft.drawString(string, 315, 5, 4);
+
+    if (page_base_station_data->mode == BASE_STATION_MODE_OFF) color = DARKRED;
+    else color = DARKGREEN;
+    tft.fillRoundRect(5, 40, 152, 38, 10, color);
+    tft.drawRoundRect(5, 40, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    if (page_base_station_data->mode == BASE_STATION_MODE_SURVEY_IN) tft.drawString(F("Survey-in"), 81, 59, 4);
+    else if (page_base_station_data->mode == BASE_STATION_MODE_FIXED) tft.drawString(F("Fixed"), 81, 59, 4);
+    else tft.drawString(F("Off"), 81, 59, 4);
+
+    if ((page_base_station_data->mode == BASE_STATION_MODE_FIXED) || (page_base_station_data->survey_in_valid == true)) color = DARKGREEN;
+    else if (page_base_station_data->survey_in_active == true) color = ORANGE;
+    else color = DARKRED;
+    tft.fillRoundRect(5, 81, 152, 38, 10, color);
+    tft.drawRoundRect(5, 81, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    if ((page_base_station_data->mode == BASE_STATION_MODE_FIXED) || (page_base_station_data->survey_in_valid == true)) tft.drawString(F("Valid"), 81, 100, 4);
+    else if (page_base_station_data->survey_in_active == true) tft.drawString(F("Active"), 81, 100, 4);
+    else tft.drawString(F("-"), 81, 100, 4);
+
+    tft.fillRoundRect(5, 122, 152, 38, 10, color);
+    tft.drawRoundRect(5, 122, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "%lu s", (unsigned long)page_base_station_data->survey_in_duration);
+    tft.drawString(string, 81, 141, 4);
+
+    tft.fillRoundRect(5, 163, 152, 38, 10, color);
+    tft.drawRoundRect(5, 163, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "%.3f m", page_base_station_data->survey_in_accuracy);
+    tft.drawString(string, 81, 182, 4);
+
+    if (page_base_station_data->server_active == true) color = DARKGREEN;
+    else color = DARKRED;
+    tft.fillRoundRect(162, 40, 152, 38, 10, color);
+    tft.drawRoundRect(162, 40, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    tft.drawString(F("Server"), 238, 59, 4);
+
+    tft.fillRoundRect(162, 81, 152, 38, 10, color);
+    tft.drawRoundRect(162, 81, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "%lu B/s", (unsigned long)page_base_station_data->bytes_per_second);
+    tft.drawString(string, 238, 100, 4);
+
+    if (page_base_station_data->frames > 0) color = DARKGREEN;
+    else color = DARKRED;
+    tft.fillRoundRect(162, 122, 152, 38, 10, color);
+    tft.drawRoundRect(162, 122, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "Fr. %lu", (unsigned long)page_base_station_data->frames);
+    tft.drawString(string, 238, 141, 4);
+
+    if (page_base_station_data->drops == 0) color = DARKGREEN;
+    else color = ORANGE;
+    tft.fillRoundRect(162, 163, 152, 38, 10, color);
+    tft.drawRoundRect(162, 163, 152, 38, 10, DARKGREY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(CC_DATUM);
+    sprintf(string, "Drops %lu", (unsigned long)page_base_station_data->drops);
+    tft.drawString(string, 238, 182, 4);
+
+    if (page_base_station_data->actual_page > 0)
+    {
+        tft.drawLine(52, 213, 42, 223, WHITE);
+        tft.drawLine(42, 223, 52, 233, WHITE);
+        tft.drawLine(62, 213, 52, 223, WHITE);
+        tft.drawLine(52, 223, 62, 233, WHITE);
+    }
+    if (page_base_station_data->play == true) tft.drawRect(150, 213, 20, 20, WHITE);
+    else
+    {
+        tft.drawLine(150, 213, 150, 233, WHITE);
+        tft.drawLine(150, 213, 170, 223, WHITE);
+        tft.drawLine(170, 223, 150, 233, WHITE);
+    }
+    if (page_base_station_data->actual_page < PAGE_TOTAL - 1)
+    {
+        tft.drawLine(262, 213, 272, 223, WHITE);
+        tft.drawLine(272, 223, 262, 233, WHITE);
+        tft.drawLine(252, 213, 262, 223, WHITE);
+        tft.drawLine(262, 223, 252, 233, WHITE);
+    }
+
+    tft.pushSprite(0, 0);
+}
+
+/**
+ * @brief Show the diagnostics page
+ * @param [in] page_diagnostics_data
+ */
+void page_diagnostics(struct page_diagnostics *page_diagnostics_data)
+{
+    TFT_eSprite &tft = page_sprite;
+    char string[40];
+    uint8_t counter = 0;
+    uint16_t color = WHITE;
+
+    esp_task_wdt_reset();
+    tft.fillSprite(NAVY);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TL_DATUM);
+    tft.drawString(F("Diagnostics"), 5, 5, 4);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TR_DATUM);
+    sprintf(string, "%u/%u", page_diagnostics_data->actual_page + 1, PAGE_TOTAL);
+    tft.drawString(string, 315, 5, 4);
+
+    tft.setTextColor(LIGHTGREY);
+    tft.setTextDatum(TL_DATUM);
+    tft.drawString(F("Task"), 10, 36, 2);
+    tft.setTextDatum(TR_DATUM);
+    tft.drawString(F("CPU"), 150, 36, 2);
+    tft.drawString(F("Max"), 210, 36, 2);
+    tft.drawString(F("Stack free"), 310, 36, 2);
+    for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1)
+    {
+        tft.setTextColor(WHITE);
+        tft.setTextDatum(TL_DATUM);
+        tft.drawString(task_text[counter], 10, 52 + counter * 14, 2);
+        if (page_diagnostics_data->load[counter] > 80) color = ORANGE;
+        else color = WHITE;
+        tft.setTextColor(color);
+        tft.setTextDatum(TR_DATUM);
+        sprintf(string, "%u %%", page_diagnostics_data->load[counter]);
+        tft.drawString(string, 150, 52 + counter * 14, 2);
+        sprintf(string, "%u %%", page_diagnostics_data->load_max[counter]);
+        tft.drawString(string, 210, 52 + counter * 14, 2);
+        if (page_diagnostics_data->stack_free[counter] < DIAGNOSTICS_STACK_LOW) color = ORANGE;
+        else color = WHITE;
+        tft.setTextColor(color);
+        sprintf(string, "%lu/%lu", (unsigned long)page_diagnostics_data->stack_free[counter], (unsigned long)page_diagnostics_data->stack_size[counter]);
+        tft.drawString(string, 310, 52 + counter * 14, 2);
+    }
+
+    tft.setTextColor(LIGHTGREY);
+    tft.setTextDatum(TL_DATUM);
+    tft.drawString(F("Heap"), 10, 140, 2);
+    tft.drawString(F("Block"), 10, 154, 2);
+    tft.drawString(F("PSRAM"), 10, 168, 2);
+    tft.drawString(F("Frames"), 10, 182, 2);
+    tft.drawString(F("Reset"), 10, 196, 2);
+    tft.setTextColor(WHITE);
+    tft.setTextDatum(TR_DATUM);
+    sprintf(string, "%lu free %lu min %lu fail", (unsigned long)page_diagnostics_data->heap_free, (unsigned long)page_diagnostics_data->heap_min, (unsigned long)page_diagnostics_data->alloc_failures);
+    if (page_diagnostics_data->alloc_failures > 0) color = ORANGE;
+    else color = WHITE;
+    tft.setTextColor(color);
+    tft.drawString(string, 310, 140, 2);
+    sprintf(string, "%lu now %lu min %u %% frag.", (unsigned long)page_diagnostics_data->heap_largest, (unsigned long)page_diagnostics_data->heap_largest_min, page_diagnostics_data->fragmentation);
+    if (page_diagnostics_data->fragmentation > DIAGNOSTICS_FRAGMENTATION_HIGH) color = ORANGE;
+    else color = WHITE;
+    tft.setTextColor(color);
+    tft.drawString(string, 310, 154, 2);
+    tft.setTextColor(WHITE);
+    sprintf(string, "%lu free %lu block", (unsigned long)page_diagnostics_data->psram_free, (unsigned long)page_diagnostics_data->psram_largest);
+    tft.drawString(string, 310, 168, 2);
+    sprintf(string, "%u fps %lu us max", page_diagnostics_data->frames_per_second, (unsigned long)page_diagnostics_data->frame_time_max);
+    tft.drawString(string, 310, 182, 2);
+    if ((page_diagnostics_data->reset_reason == ESP_RST_PANIC) || (page_diagnostics_data->reset_reason == ESP_RST_INT_WDT) || (page_diagnostics_data->reset_reason == ESP_RST_TASK_WDT) || (page_diagnostics_data->reset_reason == ESP_RST_WDT) || (page_diagnostics_data->reset_reason == ESP_RST_BROWNOUT)) color = ORANGE;
+    else color = WHITE;
+    tft.setTextColor(color);
+    tft.drawString(diagnostics_reset_text(page_diagnostics_data->reset_reason), 310, 196, 2);
+
+    if (page_diagnostics_data->actual_page > 0)
+    {
+        tft.drawLine(52, 213, 42, 223, WHITE);
+        tft.drawLine(42, 223, 52, 233, WHITE);
+        tft.drawLine(62, 213, 52, 223, WHITE);
+        tft.drawLine(52, 223, 62, 233, WHITE);
+    }
+    if (page_diagnostics_data->play == true) tft.drawRect(150, 213, 20, 20, WHITE);
+    else
+    {
+        tft.drawLine(150, 213, 150, 233, WHITE);
+        tft.drawLine(150, 213, 170, 223, WHITE);
+        tft.drawLine(170, 223, 150, 233, WHITE);
+    }
+    if (page_diagnostics_data->actual_page < PAGE_TOTAL - 1)
+    {
+        tft.drawLine(262, 213, 272, 223, WHITE);
+        tft.drawLine(272, 223, 262, 233, WHITE);
+        tft.drawLine(252, 213, 262, 223, WHITE);
+        tft.drawLine(262, 223, 252, 233, WHITE);
+    }
+
+    tft.pushSprite(0, 0);
+}
+
+/**
+ * @brief Show the startup picture of the SD card
+ */
+void page_startup(void)
+{
+    TFT_eSprite &tft = page_sprite;
+
+    esp_task_wdt_reset();
+    tft.drawJpgFile(SD, "/icons/startup.jpg");
+    tft.pushSprite(0, 0);
 }
 
 /**
@@ -1169,9 +1631,7 @@ void page_satellite_info(struct page_satellite_info *page_satellite_info_data)
  */
 void page_error(uint8_t error_code)
 {
-    TFT_eSprite tft = TFT_eSprite(&M5.Lcd); 
-
-    tft.createSprite(320, 240);
+    TFT_eSprite &tft = page_sprite;
     tft.fillSprite(NAVY); 
     tft.setTextColor(RED);
     tft.setTextDatum(MC_DATUM);
@@ -1181,7 +1641,6 @@ void page_error(uint8_t error_code)
         tft.drawString(F("Missing data on"), 160, 100, 4);
         tft.drawString(F("the SD card!"), 160, 140, 4); 
         tft.pushSprite(0, 0);
-        tft.deleteSprite();
         while(1)
         {
             esp_task_wdt_reset(); 
@@ -1192,7 +1651,6 @@ void page_error(uint8_t error_code)
         tft.drawString(F("Wrong config file on the"), 160, 100, 4);
         tft.drawString(F("SD card!"), 160, 140, 4); 
         tft.pushSprite(0, 0);
-        tft.deleteSprite();
         while(1)
         {
             esp_task_wdt_reset(); 
@@ -1203,7 +1661,6 @@ void page_error(uint8_t error_code)
         tft.drawString(F("GNSS have"), 160, 100, 4);
         tft.drawString(F("a problem!"), 160, 140, 4); 
         tft.pushSprite(0, 0);
-        tft.deleteSprite();
         while(1)
         {
             esp_task_wdt_reset(); 
@@ -1214,7 +1671,6 @@ void page_error(uint8_t error_code)
         tft.drawString(F("Bluetooth serial have"), 160, 100, 4);
         tft.drawString(F("a problem!"), 160, 140, 4); 
         tft.pushSprite(0, 0);
-        tft.deleteSprite();
         while(1)
         {
             esp_task_wdt_reset(); 
@@ -1225,7 +1681,6 @@ void page_error(uint8_t error_code)
         tft.drawString(F("Unknown"), 160, 100, 4);
         tft.drawString(F("error!"), 160, 140, 4); 
         tft.pushSprite(0, 0);
-        tft.deleteSprite();
         while(1)
         {
             esp_task_wdt_reset(); 
@@ -1233,3 +1688,17 @@ void page_error(uint8_t error_code)
         break;
     }
 }
+
+/**
+ * @brief Initialize the pages (one sprite for all pages, allocated once)
+ * @return error
+ */
+bool page_init(void)
+{
+    bool error = false;
+
+    esp_task_wdt_reset();
+    if (page_sprite.createSprite(320, 240) == nullptr) error = true;
+
+    return error;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file power.cpp
+ *
+ * @brief Power management related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <esp_pm.h>
+#include "power.h"
+
+/*
+ * The frequency scaling runs the CPU between 80 and 240 MHz. 80 MHz is the
+ * lowest clock with the full APB clock, so the baud rates of the UART and
+ * the I2C bus do not change. While the display is on, the user interface
+ * holds the maximum clock.
+ *
+ * There is no light sleep mode. The Arduino framework is built without the
+ * tickless idle, so esp_pm_configure() rejects the light sleep, and the
+ * Bluetooth controller holds its own lock against it anyway.
+ */
+
+portMUX_TYPE power_taskmux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t power_mode = POWER_MODE_OFF;
+esp_pm_lock_handle_t power_display_lock = NULL;
+bool power_display_held = false;
+float power_current_sum[2];
+uint32_t power_current_count[2];
+
+const char static PROGMEM power_mode_text_0[] = "off";
+const char static PROGMEM power_mode_text_1[] = "dfs";
+const char* const PROGMEM power_mode_text[] = {power_mode_text_0, power_mode_text_1};
+
+/**
+ * @brief Hold or release the maximum clock for the display
+ * @param [in] display_on
+ */
+void power_display(bool display_on)
+{
+    if (power_mode == POWER_MODE_OFF) return;
+    portENTER_CRITICAL(&power_taskmux);
+    if ((display_on == true) && (power_display_held == false)) esp_pm_lock_acquire(power_display_lock);
+    if ((display_on == false) && (power_display_held == true)) esp_pm_lock_release(power_display_lock);
+    power_display_held = display_on;
+    portEXIT_CRITICAL(&power_taskmux);
+}
+
+/**
+ * @brief Follow the display and collect the battery current
+ * @param [in] power_data, battery_data, display_on
+ */
+void power_transfer(struct power *power_data, struct battery *battery_data, bool display_on)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static unsigned long report_millis = millis();
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    if (power_data->display_on != display_on)
+    {
+        power_display(display_on);
+        power_data->display_on = display_on;
+    }
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        if (display_on == true) counter = 1;
+        else counter = 0;
+        power_current_sum[counter] = power_current_sum[counter] + battery_data->current;
+        power_current_count[counter] = power_current_count[counter] + 1;
+        last_millis = curr_millis;
+    }
+    if ((unsigned long)(curr_millis - report_millis) >= POWER_REPORT)
+    {
+        if (power_current_count[1] > 0) power_data->current_display_on = power_current_sum[1] / power_current_count[1];
+        if (power_current_count[0] > 0) power_data->current_display_off = power_current_sum[0] / power_current_count[0];
+        Serial.printf("Power statistics (%s, display on %.0f mA for %lu s, display off %.0f mA for %lu s)... ok\n", power_mode_text[power_data->mode], power_data->current_display_on, (unsigned long)power_current_count[1], power_data->current_display_off, (unsigned long)power_current_count[0]);
+        for (counter = 0; counter < 2; counter = counter + 1)
+        {
+            power_current_sum[counter] = 0;
+            power_current_count[counter] = 0;
+        }
+        report_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Initialize the power management
+ * @param [in] power_data, sd_card_config2_data
+ * @return error
+ */
+bool power_init(struct power *power_data, struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+    uint8_t counter = 0;
+    uint8_t mode = sd_card_config2_data->power_mode;
+    esp_pm_config_esp32_t pm_config;
+
+    esp_task_wdt_reset();
+    for (counter = 0; counter < 2; counter = counter + 1)
+    {
+        power_current_sum[counter] = 0;
+        power_current_count[counter] = 0;
+    }
+    power_display_held = false;
+    power_data->display_on = false;
+    power_data->current_display_on = 0;
+    power_data->current_display_off = 0;
+    if (mode != POWER_MODE_OFF)
+    {
+        pm_config.max_freq_mhz = POWER_FREQUENCY_MAX;
+        pm_config.min_freq_mhz = POWER_FREQUENCY_MIN;
+        pm_config.light_sleep_enable = false;
+        if (esp_pm_configure(&pm_config) != ESP_OK) error = true;
+        if ((error == false) && (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "display", &power_display_lock) != ESP_OK)) error = true;
+        if (error == true)
+        {
+            pm_config.min_freq_mhz = POWER_FREQUENCY_MAX;
+            esp_pm_configure(&pm_config);
+            mode = POWER_MODE_OFF;
+        }
+    }
+    power_data->mode = mode;
+    power_mode = mode;
+
+    return error;
+}
@@ -31,9 +31,8 @@
 #include <SparkFun_u-blox_GNSS_v3.h>
 #include "real_time_clock.h"
 #include "sd_card.h"
+#include "bus.h"
 
-extern bool gnss_fix_ok;
-extern portMUX_TYPE gnss_taskmux; 
 extern SFE_UBLOX_GNSS gnss_i2c;
 
 /**
@@ -42,19 +41,11 @@ extern SFE_UBLOX_GNSS gnss_i2c;
  */
 void real_time_clock_transfer(struct real_time_clock *real_time_clock_data)
 {
-    unsigned long curr_millis = 0;
-    static unsigned long last_millis = millis();
+    static struct bus_gnss bus_gnss_data;
+    static uint32_t version = 0;
  
     esp_task_wdt_reset();
-    curr_millis = millis();
-    if ((unsigned long)(curr_millis - last_millis) > 1000)
-    {
-        portENTER_CRITICAL(&gnss_taskmux);
-        real_time_clock_data->gnss_fix_ok = gnss_fix_ok;
-        portEXIT_CRITICAL(&gnss_taskmux);
-        
-        last_millis = curr_millis;
-    }
+    if (bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version) == true) real_time_clock_data->gnss_fix_ok = bus_gnss_data.gnss_fix_ok;
 }
 
 /**
@@ -70,9 +61,12 @@ bool real_time_clock_set(void)
     RTC_DateTypeDef date;
     RTC_TimeTypeDef time;
     int pin_timepulse;
+    struct bus_gnss bus_gnss_data;
+    uint32_t version = 0;
 
     esp_task_wdt_reset();
-    if (gnss_fix_ok == true)
+    bus_read(BUS_TOPIC_GNSS, &bus_gnss_data, &version);
+    if (bus_gnss_data.gnss_fix_ok == true)
     {
         Serial.print(F("Update real time clock... "));
         pin_timepulse = digitalRead(REALTIMECLOCK_TIMEPULSE);
@@ -0,0 +1,156 @@
+/**
+ * @file ring_buffer.cpp
+ *
+ * @brief Ring buffer related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "ring_buffer.h"
+
+/*
+ * Single producer, single consumer ring buffer. The producer only writes head,
+ * the consumer only writes tail, so no lock is needed between two tasks. The
+ * size must be a power of two, head and tail are free running.
+ */
+
+/**
+ * @brief Get the used bytes of the ring buffer
+ * @param [in] ring_buffer_data
+ * @return used bytes
+ */
+uint32_t ring_buffer_used(struct ring_buffer *ring_buffer_data)
+{
+    return __atomic_load_n(&ring_buffer_data->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring_buffer_data->tail, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Get the free bytes of the ring buffer
+ * @param [in] ring_buffer_data
+ * @return free bytes
+ */
+uint32_t ring_buffer_free(struct ring_buffer *ring_buffer_data)
+{
+    return ring_buffer_data->size - ring_buffer_used(ring_buffer_data);
+}
+
+/**
+ * @brief Write data completely or not at all into the ring buffer
+ * @param [in] ring_buffer_data, data, length
+ * @return true if the data was written, false if it was dropped
+ */
+bool ring_buffer_write(struct ring_buffer *ring_buffer_data, const uint8_t *data, uint32_t length)
+{
+    uint32_t head = ring_buffer_data->head;
+    uint32_t offset = 0;
+    uint32_t part = 0;
+
+    if (length > ring_buffer_free(ring_buffer_data))
+    {
+        ring_buffer_data->drops = ring_buffer_data->drops + 1;
+        return false;
+    }
+    offset = head & (ring_buffer_data->size - 1);
+    part = ring_buffer_data->size - offset;
+    if (part > length) part = length;
+    memcpy(&ring_buffer_data->data[offset], data, part);
+    memcpy(ring_buffer_data->data, &data[part], length - part);
+    __atomic_store_n(&ring_buffer_data->head, head + length, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/**
+ * @brief Get the contiguous readable block of the ring buffer
+ * @param [in] ring_buffer_data
+ * @param [out] data
+ * @return length of the block
+ */
+uint32_t ring_buffer_peek(struct ring_buffer *ring_buffer_data, const uint8_t **data)
+{
+    uint32_t tail = ring_buffer_data->tail;
+    uint32_t used = ring_buffer_used(ring_buffer_data);
+    uint32_t offset = tail & (ring_buffer_data->size - 1);
+
+    *data = &ring_buffer_data->data[offset];
+    if (used > (ring_buffer_data->size - offset)) used = ring_buffer_data->size - offset;
+
+    return used;
+}
+
+/**
+ * @brief Release read bytes of the ring buffer
+ * @param [in] ring_buffer_data, length
+ */
+void ring_buffer_consume(struct ring_buffer *ring_buffer_data, uint32_t length)
+{
+    __atomic_store_n(&ring_buffer_data->tail, ring_buffer_data->tail + length, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy and release data of the ring buffer across the wrap around
+ * @param [in] ring_buffer_data, length
+ * @param [out] data
+ * @return length of the copied data
+ */
+uint32_t ring_buffer_read(struct ring_buffer *ring_buffer_data, uint8_t *data, uint32_t length)
+{
+    uint32_t tail = ring_buffer_data->tail;
+    uint32_t used = ring_buffer_used(ring_buffer_data);
+    uint32_t offset = tail & (ring_buffer_data->size - 1);
+    uint32_t part = 0;
+
+    if (length > used) length = used;
+    part = ring_buffer_data->size - offset;
+    if (part > length) part = length;
+    memcpy(data, &ring_buffer_data->data[offset], part);
+    memcpy(&data[part], ring_buffer_data->data, length - part);
+    __atomic_store_n(&ring_buffer_data->tail, tail + length, __ATOMIC_RELEASE);
+
+    return length;
+}
+
+/**
+ * @brief Discard all data of the ring buffer (consumer side)
+ * @param [in] ring_buffer_data
+ */
+void ring_buffer_clear(struct ring_buffer *ring_buffer_data)
+{
+    __atomic_store_n(&ring_buffer_data->tail, __atomic_load_n(&ring_buffer_data->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Initialize the ring buffer
+ * @param [in] ring_buffer_data, data, size
+ */
+void ring_buffer_init(struct ring_buffer *ring_buffer_data, uint8_t *data, uint32_t size)
+{
+    ring_buffer_data->data = data;
+    ring_buffer_data->size = size;
+    ring_buffer_data->head = 0;
+    ring_buffer_data->tail = 0;
+    ring_buffer_data->drops = 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file rtcm.cpp
+ *
+ * @brief RTCM related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "rtcm.h"
+
+/**
+ * @brief Calculate the CRC-24Q of a RTCM frame
+ * @param [in] data, length
+ * @return crc
+ */
+uint32_t rtcm_crc24q(const uint8_t *data, uint16_t length)
+{
+    uint32_t crc = 0;
+    uint16_t counter1 = 0;
+    uint8_t counter2 = 0;
+
+    for (counter1 = 0; counter1 < length; counter1 = counter1 + 1)
+    {
+        crc = crc ^ ((uint32_t)data[counter1] << 16);
+        for (counter2 = 0; counter2 < 8; counter2 = counter2 + 1)
+        {
+            crc = crc << 1;
+            if ((crc & 0x1000000) != 0) crc = crc ^ 0x1864CFB;
+        }
+    }
+
+    return crc & 0xFFFFFF;
+}
+
+/**
+ * @brief Get the message type of a complete RTCM frame
+ * @param [in] frame
+ * @return message type
+ */
+uint16_t rtcm_message_type(const uint8_t *frame)
+{
+    return (uint16_t)(((uint16_t)frame[3] << 4) | (frame[4] >> 4));
+}
+
+/**
+ * @brief Drop the buffered bytes up to the next preamble after the first byte
+ *
+ * Only the first rejected frame until the next valid frame counts as error,
+ * the false frames found while scanning the same stretch again do not.
+ * @param [in,out] rtcm_parser_data
+ */
+static void rtcm_resync(struct rtcm_parser *rtcm_parser_data)
+{
+    uint16_t counter = 1;
+
+    if (rtcm_parser_data->resync == false) rtcm_parser_data->errors = rtcm_parser_data->errors + 1;
+    rtcm_parser_data->resync = true;
+    while ((counter < rtcm_parser_data->length) && (rtcm_parser_data->frame[counter] != RTCM_PREAMBLE)) counter = counter + 1;
+    rtcm_parser_data->length = rtcm_parser_data->length - counter;
+    memmove(rtcm_parser_data->frame, &rtcm_parser_data->frame[counter], rtcm_parser_data->length);
+}
+
+/**
+ * @brief Parse one byte of a RTCM stream
+ *
+ * A preamble inside the payload starts a false frame which fails its CRC
+ * only after up to RTCM_FRAME_LENGTH_MAX bytes. The buffered bytes are
+ * therefore scanned again from the next preamble after a failure, so the
+ * real frames inside the false frame are not lost. Bytes behind a complete
+ * frame stay buffered, a frame found in them is returned with the next byte.
+ * @param [in,out] rtcm_parser_data
+ * @param [in] data
+ * @return true if a complete frame with valid CRC is in rtcm_parser_data->frame
+ */
+bool rtcm_parse(struct rtcm_parser *rtcm_parser_data, uint8_t data)
+{
+    uint32_t crc = 0;
+
+    if (rtcm_parser_data->pending > 0)
+    {
+        rtcm_parser_data->length = rtcm_parser_data->pending;
+        memmove(rtcm_parser_data->frame, &rtcm_parser_data->frame[rtcm_parser_data->frame_length], rtcm_parser_data->length);
+        rtcm_parser_data->pending = 0;
+    }
+    if ((rtcm_parser_data->length == 0) && (data != RTCM_PREAMBLE)) return false;
+    rtcm_parser_data->frame[rtcm_parser_data->length] = data;
+    rtcm_parser_data->length = rtcm_parser_data->length + 1;
+
+    while (rtcm_parser_data->length > 1)
+    {
+        if ((rtcm_parser_data->frame[1] & 0xFC) != 0)
+        {
+            rtcm_resync(rtcm_parser_data);
+            continue;
+        }
+        if (rtcm_parser_data->length < 3) break;
+        rtcm_parser_data->frame_length = (uint16_t)((((uint16_t)rtcm_parser_data->frame[1] & 0x03) << 8) | rtcm_parser_data->frame[2]) + 6;
+        if (rtcm_parser_data->length < rtcm_parser_data->frame_length) break;
+        crc = ((uint32_t)rtcm_parser_data->frame[rtcm_parser_data->frame_length - 3] << 16) | ((uint32_t)rtcm_parser_data->frame[rtcm_parser_data->frame_length - 2] << 8) | rtcm_parser_data->frame[rtcm_parser_data->frame_length - 1];
+        if (rtcm_crc24q(rtcm_parser_data->frame, rtcm_parser_data->frame_length - 3) == crc)
+        {
+            rtcm_parser_data->pending = rtcm_parser_data->length - rtcm_parser_data->frame_length;
+            rtcm_parser_data->length = 0;
+            rtcm_parser_data->resync = false;
+            return true;
+        }
+        rtcm_resync(rtcm_parser_data);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Initialize the RTCM parser
+ * @param [in] rtcm_parser_data
+ */
+void rtcm_parser_init(struct rtcm_parser *rtcm_parser_data)
+{
+    rtcm_parser_data->length = 0;
+    rtcm_parser_data->frame_length = 0;
+    rtcm_parser_data->pending = 0;
+    rtcm_parser_data->resync = false;
+    rtcm_parser_data->errors = 0;
+}
+
+/**
+ * @brief Get the epoch time of a complete RTCM MSM frame
+ * @param [in] frame
+ * @param [out] system, epoch
+ * @return true if the frame is a MSM frame
+ */
+bool rtcm_msm_epoch(const uint8_t *frame, uint16_t *system, uint32_t *epoch)
+{
+    uint16_t type = rtcm_message_type(frame);
+
+    if ((type < 1071) || (type > 1127) || ((type % 10) < 1) || ((type % 10) > 7)) return false;
+    *system = type / 10;
+    *epoch = (((uint32_t)frame[6] << 22) | ((uint32_t)frame[7] << 14) | ((uint32_t)frame[8] << 6) | (frame[9] >> 2)) & 0x3FFFFFFF;
+    if (*system == 108) *epoch = *epoch & 0x07FFFFFF;                               //GLONASS time of day without day of week
+
+    return true;
+}
+
+/**
+ * @brief Get the time to wait until a RTCM frame is due at its original timing
+ * @param [in,out] rtcm_pacer_data
+ * @param [in] frame, timestamp
+ * @return delay in ms, 0 if the frame is due
+ */
+uint32_t rtcm_pacer_delay(struct rtcm_pacer *rtcm_pacer_data, const uint8_t *frame, uint32_t timestamp)
+{
+    uint16_t system = 0;
+    uint32_t epoch = 0;
+    uint32_t period = 604800000;
+    uint32_t delta = 0;
+    uint32_t elapsed = 0;
+
+    if (rtcm_msm_epoch(frame, &system, &epoch) == false) return 0;
+    if (rtcm_pacer_data->started == false)
+    {
+        rtcm_pacer_data->started = true;
+        rtcm_pacer_data->system = system;
+        rtcm_pacer_data->epoch = epoch;
+        rtcm_pacer_data->timestamp = timestamp;
+        return 0;
+    }
+    if (system != rtcm_pacer_data->system) return 0;
+    if (system == 108) period = 86400000;
+    delta = (epoch + period - rtcm_pacer_data->epoch) % period;
+    if (delta > RTCM_PACER_RESYNC)
+    {
+        rtcm_pacer_data->epoch = epoch;
+        rtcm_pacer_data->timestamp = timestamp;
+        return 0;
+    }
+    elapsed = timestamp - rtcm_pacer_data->timestamp;
+    if (elapsed < delta) return delta - elapsed;
+    rtcm_pacer_data->epoch = epoch;
+    rtcm_pacer_data->timestamp = rtcm_pacer_data->timestamp + delta;
+    if ((uint32_t)(timestamp - rtcm_pacer_data->timestamp) > 1000) rtcm_pacer_data->timestamp = timestamp;
+
+    return 0;
+}
+
+/**
+ * @brief Initialize the RTCM pacer
+ * @param [in] rtcm_pacer_data
+ */
+void rtcm_pacer_init(struct rtcm_pacer *rtcm_pacer_data)
+{
+    rtcm_pacer_data->started = false;
+    rtcm_pacer_data->system = 0;
+    rtcm_pacer_data->epoch = 0;
+    rtcm_pacer_data->timestamp = 0;
+}
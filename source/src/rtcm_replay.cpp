@@ -0,0 +1,128 @@
+/**
+ * @file rtcm_replay.cpp
+ *
+ * @brief RTCM replay related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include "rtcm_replay.h"
+#include "sd_card.h"
+#include "rtcm.h"
+#include "correction.h"
+
+File rtcm_replay_file;
+struct rtcm_parser rtcm_replay_parser;
+struct rtcm_pacer rtcm_replay_pacer;
+uint8_t rtcm_replay_buffer[RTCM_REPLAY_BUFFER];
+int rtcm_replay_buffer_length = 0;
+int rtcm_replay_buffer_position = 0;
+bool rtcm_replay_pending = false;
+bool rtcm_replay_loop = false;
+
+/**
+ * @brief Replay the RTCM file at its original timing to the correction
+ * @return error
+ */
+bool rtcm_replay(void)
+{
+    bool error = false;
+    uint16_t length = 0;
+    uint8_t data[2048];
+
+    esp_task_wdt_reset();
+    if (!rtcm_replay_file) return true;
+    while (1)
+    {
+        if (rtcm_replay_pending == true)
+        {
+            if (rtcm_pacer_delay(&rtcm_replay_pacer, rtcm_replay_parser.frame, millis()) > 0) break;
+            if ((length + rtcm_replay_parser.frame_length) > sizeof(data)) break;
+            memcpy(&data[length], rtcm_replay_parser.frame, rtcm_replay_parser.frame_length);
+            length = length + rtcm_replay_parser.frame_length;
+            rtcm_replay_pending = false;
+        }
+        if (rtcm_replay_buffer_position >= rtcm_replay_buffer_length)
+        {
+            rtcm_replay_buffer_length = rtcm_replay_file.read(rtcm_replay_buffer, sizeof(rtcm_replay_buffer));
+            rtcm_replay_buffer_position = 0;
+            if (rtcm_replay_buffer_length <= 0)
+            {
+                rtcm_replay_buffer_length = 0;
+                if (rtcm_replay_loop == true)
+                {
+                    rtcm_replay_file.seek(0);
+                    rtcm_parser_init(&rtcm_replay_parser);
+                    rtcm_pacer_init(&rtcm_replay_pacer);
+                    Serial.print(F("Restart RTCM replay... ok\n"));
+                }
+                else
+                {
+                    rtcm_replay_file.close();
+                    error = true;
+                }
+                break;
+            }
+        }
+        while ((rtcm_replay_buffer_position < rtcm_replay_buffer_length) && (rtcm_replay_pending == false))
+        {
+            rtcm_replay_pending = rtcm_parse(&rtcm_replay_parser, rtcm_replay_buffer[rtcm_replay_buffer_position]);
+            rtcm_replay_buffer_position = rtcm_replay_buffer_position + 1;
+        }
+    }
+    if (length > 0)
+    {
+        if (correction_push(CORRECTION_SOURCE_REPLAY, data, length) == true) error = true;
+    }
+
+    return error;
+}
+
+/**
+ * @brief Initialize the RTCM replay
+ * @param [in] sd_card_config2_data
+ * @return error
+ */
+bool rtcm_replay_init(struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+
+    esp_task_wdt_reset();
+    rtcm_replay_file = SD.open(sd_card_config2_data->replay_file, FILE_READ);
+    if (rtcm_replay_file)
+    {
+        rtcm_parser_init(&rtcm_replay_parser);
+        rtcm_pacer_init(&rtcm_replay_pacer);
+        rtcm_replay_buffer_length = 0;
+        rtcm_replay_buffer_position = 0;
+        rtcm_replay_pending = false;
+        rtcm_replay_loop = (sd_card_config2_data->replay_loop == 1);
+        correction_connect();
+    }
+    else error = true;
+
+    return error;
+}
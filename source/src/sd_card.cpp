@@ -59,6 +59,10 @@ bool sd_card_config_read(struct sd_card_config1 *sd_card_config1_data, struct sd
         sd_card_config1_data->display_timeout = UINT16_MAX;
         sd_card_config2_data->wlan_ssid[0] = '\0';
         sd_card_config2_data->wlan_password[0] = '\0';
+        sd_card_config2_data->wlan2_ssid[0] = '\0';
+        sd_card_config2_data->wlan2_password[0] = '\0';
+        sd_card_config2_data->wlan3_ssid[0] = '\0';
+        sd_card_config2_data->wlan3_password[0] = '\0';
         sd_card_config2_data->assist_now_server[0] = '\0';
         sd_card_config2_data->assist_now_token[0] = '\0';
         sd_card_config2_data->ntrip_server[0] = '\0';
@@ -66,6 +70,60 @@ bool sd_card_config_read(struct sd_card_config1 *sd_card_config1_data, struct sd
         sd_card_config2_data->ntrip_mount_point[0] = '\0';
         sd_card_config2_data->ntrip_user[0] = '\0';
         sd_card_config2_data->ntrip_password[0] = '\0';
+        sd_card_config2_data->ntrip_caster_enable = UINT8_MAX;
+        sd_card_config2_data->ntrip_caster_port = UINT16_MAX;
+        sd_card_config2_data->ntrip_caster_mount_point[0] = '\0';
+        sd_card_config2_data->base_mode = UINT8_MAX;
+        sd_card_config2_data->base_survey_in_duration = UINT32_MAX;
+        sd_card_config2_data->base_survey_in_accuracy = FLT_MAX;
+        sd_card_config2_data->base_ecef_x = DBL_MAX;
+        sd_card_config2_data->base_ecef_y = DBL_MAX;
+        sd_card_config2_data->base_ecef_z = DBL_MAX;
+        sd_card_config2_data->base_server[0] = '\0';
+        sd_card_config2_data->base_port = UINT16_MAX;
+        sd_card_config2_data->base_mount_point[0] = '\0';
+        sd_card_config2_data->base_user[0] = '\0';
+        sd_card_config2_data->base_password[0] = '\0';
+        sd_card_config2_data->base_version = UINT8_MAX;
+        sd_card_config2_data->replay_enable = UINT8_MAX;
+        sd_card_config2_data->replay_file[0] = '\0';
+        sd_card_config2_data->replay_loop = UINT8_MAX;
+        sd_card_config2_data->assist_now_offline_enable = UINT8_MAX;
+        sd_card_config2_data->assist_now_offline_server[0] = '\0';
+        sd_card_config2_data->assist_now_offline_period = UINT8_MAX;
+        sd_card_config2_data->benchmark_enable = UINT8_MAX;
+        sd_card_config2_data->benchmark_start = UINT8_MAX;
+        sd_card_config2_data->benchmark_timeout = UINT16_MAX;
+        sd_card_config2_data->benchmark_restart = UINT8_MAX;
+        sd_card_config2_data->bluetooth_le_enable = UINT8_MAX;
+        sd_card_config2_data->bluetooth_le_output = UINT8_MAX;
+        sd_card_config2_data->bluetooth_le_sentences[0] = '\0';
+        sd_card_config2_data->bluetooth_le_decimation = UINT8_MAX;
+        sd_card_config2_data->bluetooth_le_precision = UINT8_MAX;
+        sd_card_config2_data->output_bluetooth_sentences[0] = '\0';
+        sd_card_config2_data->output_bluetooth_decimation = UINT8_MAX;
+        sd_card_config2_data->output_bluetooth_precision = UINT8_MAX;
+        sd_card_config2_data->output_tcp_enable = UINT8_MAX;
+        sd_card_config2_data->output_tcp_port = UINT16_MAX;
+        sd_card_config2_data->output_tcp_sentences[0] = '\0';
+        sd_card_config2_data->output_tcp_decimation = UINT8_MAX;
+        sd_card_config2_data->output_tcp_precision = UINT8_MAX;
+        sd_card_config2_data->output_usb_enable = UINT8_MAX;
+        sd_card_config2_data->output_usb_sentences[0] = '\0';
+        sd_card_config2_data->output_usb_decimation = UINT8_MAX;
+        sd_card_config2_data->output_usb_precision = UINT8_MAX;
+        sd_card_config2_data->ubx_bridge_enable = UINT8_MAX;
+        sd_card_config2_data->ubx_bridge_transport = UINT8_MAX;
+        sd_card_config2_data->ubx_bridge_port = UINT16_MAX;
+        sd_card_config2_data->nmea_source = UINT8_MAX;
+        sd_card_config2_data->nmea_sentences[0] = '\0';
+        sd_card_config2_data->nmea_rate = UINT8_MAX;
+        sd_card_config2_data->task_uart_core = UINT8_MAX;
+        sd_card_config2_data->task_gnss_core = UINT8_MAX;
+        sd_card_config2_data->task_network_core = UINT8_MAX;
+        sd_card_config2_data->diagnostics_csv = UINT8_MAX;
+        sd_card_config2_data->diagnostics_period = UINT16_MAX;
+        sd_card_config2_data->power_mode = UINT8_MAX;
         do
         {
             length = datafile.readBytesUntil('\n', string, sizeof(string));
@@ -182,6 +240,86 @@ bool sd_card_config_read(struct sd_card_config1 *sd_card_config1_data, struct sd
                 }
                 while ((datafile.available() > 0) && (counter < 2));
             }
+            if (strncmp(string, "[wlan2]", 7) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "ssid", 4) == 0) && (sd_card_config2_data->wlan2_ssid[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->wlan2_ssid, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "password", 8) == 0) && (sd_card_config2_data->wlan2_password[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->wlan2_password, string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 2));
+            }
+            if (strncmp(string, "[wlan3]", 7) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "ssid", 4) == 0) && (sd_card_config2_data->wlan3_ssid[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->wlan3_ssid, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "password", 8) == 0) && (sd_card_config2_data->wlan3_password[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->wlan3_password, string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 2));
+            }
+            if (strncmp(string, "[assist_now_offline]", 20) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->assist_now_offline_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->assist_now_offline_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->assist_now_offline_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "server", 6) == 0) && (sd_card_config2_data->assist_now_offline_server[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->assist_now_offline_server, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "period", 6) == 0) && (sd_card_config2_data->assist_now_offline_period == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->assist_now_offline_period = atoi(string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 3));
+            }
             if (strncmp(string, "[assist_now]", 12) == 0)
             {
                 counter = 0;
@@ -251,9 +389,577 @@ bool sd_card_config_read(struct sd_card_config1 *sd_card_config1_data, struct sd
                 }
                 while ((datafile.available() > 0) && (counter < 5));
             }
+            if (strncmp(string, "[ntrip_caster]", 14) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->ntrip_caster_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->ntrip_caster_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->ntrip_caster_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "port", 4) == 0) && (sd_card_config2_data->ntrip_caster_port == UINT16_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->ntrip_caster_port = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "mount_point", 11) == 0) && (sd_card_config2_data->ntrip_caster_mount_point[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->ntrip_caster_mount_point, string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 3));
+            }
+            if (strncmp(string, "[base]", 6) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "mode", 4) == 0) && (sd_card_config2_data->base_mode == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->base_mode = 0;
+                        if (strncmp(string, "survey_in", 9) == 0) sd_card_config2_data->base_mode = 1;
+                        if (strncmp(string, "fixed", 5) == 0) sd_card_config2_data->base_mode = 2;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "survey_in_duration", 18) == 0) && (sd_card_config2_data->base_survey_in_duration == UINT32_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->base_survey_in_duration = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "survey_in_accuracy", 18) == 0) && (sd_card_config2_data->base_survey_in_accuracy == FLT_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->base_survey_in_accuracy = atof(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "ecef_x", 6) == 0) && (sd_card_config2_data->base_ecef_x == DBL_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->base_ecef_x = atof(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "ecef_y", 6) == 0) && (sd_card_config2_data->base_ecef_y == DBL_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->base_ecef_y = atof(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "ecef_z", 6) == 0) && (sd_card_config2_data->base_ecef_z == DBL_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->base_ecef_z = atof(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "server", 6) == 0) && (sd_card_config2_data->base_server[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->base_server, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "port", 4) == 0) && (sd_card_config2_data->base_port == UINT16_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->base_port = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "mount_point", 11) == 0) && (sd_card_config2_data->base_mount_point[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->base_mount_point, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "user", 4) == 0) && (sd_card_config2_data->base_user[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->base_user, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "password", 8) == 0) && (sd_card_config2_data->base_password[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->base_password, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "version", 7) == 0) && (sd_card_config2_data->base_version == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->base_version = atoi(string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 12));
+            }
+            if (strncmp(string, "[replay]", 8) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->replay_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->replay_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->replay_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "file", 4) == 0) && (sd_card_config2_data->replay_file[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strcpy(sd_card_config2_data->replay_file, string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "loop", 4) == 0) && (sd_card_config2_data->replay_loop == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->replay_loop = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->replay_loop = 0;
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 3));
+            }
+            if (strncmp(string, "[benchmark]", 11) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->benchmark_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->benchmark_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->benchmark_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "start", 5) == 0) && (sd_card_config2_data->benchmark_start == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "normal", 6) == 0) sd_card_config2_data->benchmark_start = 0;
+                        if (strncmp(string, "hot", 3) == 0) sd_card_config2_data->benchmark_start = 1;
+                        if (strncmp(string, "warm", 4) == 0) sd_card_config2_data->benchmark_start = 2;
+                        if (strncmp(string, "cold", 4) == 0) sd_card_config2_data->benchmark_start = 3;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "timeout", 7) == 0) && (sd_card_config2_data->benchmark_timeout == UINT16_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->benchmark_timeout = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "restart", 7) == 0) && (sd_card_config2_data->benchmark_restart == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->benchmark_restart = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->benchmark_restart = 0;
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 4));
+            }
+            if (strncmp(string, "[bluetooth_le]", 14) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->bluetooth_le_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->bluetooth_le_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->bluetooth_le_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "output", 6) == 0) && (sd_card_config2_data->bluetooth_le_output == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "nmea", 4) == 0) sd_card_config2_data->bluetooth_le_output = 0;
+                        if (strncmp(string, "binary", 6) == 0) sd_card_config2_data->bluetooth_le_output = 1;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "sentences", 9) == 0) && (sd_card_config2_data->bluetooth_le_sentences[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strncpy(sd_card_config2_data->bluetooth_le_sentences, string, sizeof(sd_card_config2_data->bluetooth_le_sentences) - 1);
+                        sd_card_config2_data->bluetooth_le_sentences[sizeof(sd_card_config2_data->bluetooth_le_sentences) - 1] = '\0';
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "decimation", 10) == 0) && (sd_card_config2_data->bluetooth_le_decimation == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->bluetooth_le_decimation = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "precision", 9) == 0) && (sd_card_config2_data->bluetooth_le_precision == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "standard", 8) == 0) sd_card_config2_data->bluetooth_le_precision = 0;
+                        if (strncmp(string, "high", 4) == 0) sd_card_config2_data->bluetooth_le_precision = 1;
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 5));
+            }
+            if (strncmp(string, "[output_bluetooth]", 18) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "sentences", 9) == 0) && (sd_card_config2_data->output_bluetooth_sentences[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strncpy(sd_card_config2_data->output_bluetooth_sentences, string, sizeof(sd_card_config2_data->output_bluetooth_sentences) - 1);
+                        sd_card_config2_data->output_bluetooth_sentences[sizeof(sd_card_config2_data->output_bluetooth_sentences) - 1] = '\0';
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "decimation", 10) == 0) && (sd_card_config2_data->output_bluetooth_decimation == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->output_bluetooth_decimation = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "precision", 9) == 0) && (sd_card_config2_data->output_bluetooth_precision == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "standard", 8) == 0) sd_card_config2_data->output_bluetooth_precision = 0;
+                        if (strncmp(string, "high", 4) == 0) sd_card_config2_data->output_bluetooth_precision = 1;
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 3));
+            }
+            if (strncmp(string, "[output_tcp]", 12) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->output_tcp_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->output_tcp_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->output_tcp_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "port", 4) == 0) && (sd_card_config2_data->output_tcp_port == UINT16_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->output_tcp_port = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "sentences", 9) == 0) && (sd_card_config2_data->output_tcp_sentences[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strncpy(sd_card_config2_data->output_tcp_sentences, string, sizeof(sd_card_config2_data->output_tcp_sentences) - 1);
+                        sd_card_config2_data->output_tcp_sentences[sizeof(sd_card_config2_data->output_tcp_sentences) - 1] = '\0';
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "decimation", 10) == 0) && (sd_card_config2_data->output_tcp_decimation == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->output_tcp_decimation = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "precision", 9) == 0) && (sd_card_config2_data->output_tcp_precision == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "standard", 8) == 0) sd_card_config2_data->output_tcp_precision = 0;
+                        if (strncmp(string, "high", 4) == 0) sd_card_config2_data->output_tcp_precision = 1;
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 5));
+            }
+            if (strncmp(string, "[output_usb]", 12) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->output_usb_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->output_usb_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->output_usb_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "sentences", 9) == 0) && (sd_card_config2_data->output_usb_sentences[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strncpy(sd_card_config2_data->output_usb_sentences, string, sizeof(sd_card_config2_data->output_usb_sentences) - 1);
+                        sd_card_config2_data->output_usb_sentences[sizeof(sd_card_config2_data->output_usb_sentences) - 1] = '\0';
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "decimation", 10) == 0) && (sd_card_config2_data->output_usb_decimation == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->output_usb_decimation = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "precision", 9) == 0) && (sd_card_config2_data->output_usb_precision == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "standard", 8) == 0) sd_card_config2_data->output_usb_precision = 0;
+                        if (strncmp(string, "high", 4) == 0) sd_card_config2_data->output_usb_precision = 1;
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 4));
+            }
+            if (strncmp(string, "[ubx_bridge]", 12) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "enable", 6) == 0) && (sd_card_config2_data->ubx_bridge_enable == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->ubx_bridge_enable = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->ubx_bridge_enable = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "transport", 9) == 0) && (sd_card_config2_data->ubx_bridge_transport == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "tcp", 3) == 0) sd_card_config2_data->ubx_bridge_transport = 0;
+                        if (strncmp(string, "bluetooth", 9) == 0) sd_card_config2_data->ubx_bridge_transport = 1;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "port", 4) == 0) && (sd_card_config2_data->ubx_bridge_port == UINT16_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->ubx_bridge_port = atol(string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 3));
+            }
+            if (strncmp(string, "[nmea]", 6) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "source", 6) == 0) && (sd_card_config2_data->nmea_source == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "receiver", 8) == 0) sd_card_config2_data->nmea_source = 0;
+                        if (strncmp(string, "ubx", 3) == 0) sd_card_config2_data->nmea_source = 1;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "sentences", 9) == 0) && (sd_card_config2_data->nmea_sentences[0] == '\0'))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        strncpy(sd_card_config2_data->nmea_sentences, string, sizeof(sd_card_config2_data->nmea_sentences) - 1);
+                        sd_card_config2_data->nmea_sentences[sizeof(sd_card_config2_data->nmea_sentences) - 1] = '\0';
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "rate", 4) == 0) && (sd_card_config2_data->nmea_rate == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->nmea_rate = atol(string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 3));
+            }
+            if (strncmp(string, "[tasks]", 7) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "uart", 4) == 0) && (sd_card_config2_data->task_uart_core == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "any", 3) == 0) sd_card_config2_data->task_uart_core = 2;
+                        else sd_card_config2_data->task_uart_core = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "gnss", 4) == 0) && (sd_card_config2_data->task_gnss_core == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "any", 3) == 0) sd_card_config2_data->task_gnss_core = 2;
+                        else sd_card_config2_data->task_gnss_core = atol(string);
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "network", 7) == 0) && (sd_card_config2_data->task_network_core == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "any", 3) == 0) sd_card_config2_data->task_network_core = 2;
+                        else sd_card_config2_data->task_network_core = atol(string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 3));
+            }
+            if (strncmp(string, "[diagnostics]", 13) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "csv", 3) == 0) && (sd_card_config2_data->diagnostics_csv == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "on", 2) == 0) sd_card_config2_data->diagnostics_csv = 1;
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->diagnostics_csv = 0;
+                        counter = counter + 1;
+                    }
+                    if ((strncmp(string, "period", 6) == 0) && (sd_card_config2_data->diagnostics_period == UINT16_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        sd_card_config2_data->diagnostics_period = atol(string);
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 2));
+            }
+            if (strncmp(string, "[power]", 7) == 0)
+            {
+                counter = 0;
+                do
+                {
+                    length = datafile.readBytesUntil('=', string, sizeof(string));
+                    string[length] = '\0';
+                    if ((strncmp(string, "mode", 4) == 0) && (sd_card_config2_data->power_mode == UINT8_MAX))
+                    {
+                        length = datafile.readBytesUntil('\n', string, sizeof(string));
+                        string[length - 1] = '\0';
+                        if (strncmp(string, "off", 3) == 0) sd_card_config2_data->power_mode = 0;
+                        if (strncmp(string, "dfs", 3) == 0) sd_card_config2_data->power_mode = 1;
+                        if (strncmp(string, "sleep", 5) == 0) sd_card_config2_data->power_mode = 1;     //Former light sleep mode, runs as dfs
+                        counter = counter + 1;
+                    }
+                }
+                while ((datafile.available() > 0) && (counter < 1));
+            }
         }
         while (datafile.available() > 0);
         datafile.close();
+        if (sd_card_config2_data->ntrip_caster_enable == UINT8_MAX) sd_card_config2_data->ntrip_caster_enable = 0;
+        if (sd_card_config2_data->ntrip_caster_port == UINT16_MAX) sd_card_config2_data->ntrip_caster_port = 2101;
+        if (sd_card_config2_data->ntrip_caster_mount_point[0] == '\0') strcpy(sd_card_config2_data->ntrip_caster_mount_point, "ZED-F9P");
+        if (sd_card_config2_data->base_mode == UINT8_MAX) sd_card_config2_data->base_mode = 0;
+        if (sd_card_config2_data->base_survey_in_duration == UINT32_MAX) sd_card_config2_data->base_survey_in_duration = 120;
+        if (sd_card_config2_data->base_survey_in_accuracy == FLT_MAX) sd_card_config2_data->base_survey_in_accuracy = 2.0f;
+        if (sd_card_config2_data->base_port == UINT16_MAX) sd_card_config2_data->base_port = 2101;
+        if (sd_card_config2_data->base_version == UINT8_MAX) sd_card_config2_data->base_version = 1;
+        if (sd_card_config2_data->replay_enable == UINT8_MAX) sd_card_config2_data->replay_enable = 0;
+        if (sd_card_config2_data->replay_file[0] == '\0') strcpy(sd_card_config2_data->replay_file, "/data/corrections.rtcm3");
+        if (sd_card_config2_data->replay_loop == UINT8_MAX) sd_card_config2_data->replay_loop = 1;
+        if (sd_card_config2_data->assist_now_offline_enable == UINT8_MAX) sd_card_config2_data->assist_now_offline_enable = 0;
+        if (sd_card_config2_data->assist_now_offline_server[0] == '\0') strcpy(sd_card_config2_data->assist_now_offline_server, "offline-live1.services.u-blox.com");
+        if (sd_card_config2_data->benchmark_enable == UINT8_MAX) sd_card_config2_data->benchmark_enable = 0;
+        if (sd_card_config2_data->benchmark_start == UINT8_MAX) sd_card_config2_data->benchmark_start = 0;
+        if (sd_card_config2_data->benchmark_timeout == UINT16_MAX) sd_card_config2_data->benchmark_timeout = 1200;
+        if (sd_card_config2_data->benchmark_restart == UINT8_MAX) sd_card_config2_data->benchmark_restart = 0;
+        if (sd_card_config2_data->bluetooth_le_enable == UINT8_MAX) sd_card_config2_data->bluetooth_le_enable = 0;
+        if (sd_card_config2_data->bluetooth_le_output == UINT8_MAX) sd_card_config2_data->bluetooth_le_output = 0;
+        if (sd_card_config2_data->bluetooth_le_sentences[0] == '\0') strcpy(sd_card_config2_data->bluetooth_le_sentences, "all");
+        if ((sd_card_config2_data->bluetooth_le_decimation == UINT8_MAX) || (sd_card_config2_data->bluetooth_le_decimation == 0)) sd_card_config2_data->bluetooth_le_decimation = 1;
+        if (sd_card_config2_data->bluetooth_le_precision == UINT8_MAX) sd_card_config2_data->bluetooth_le_precision = 1;
+        if (sd_card_config2_data->output_bluetooth_sentences[0] == '\0') strcpy(sd_card_config2_data->output_bluetooth_sentences, "all");
+        if ((sd_card_config2_data->output_bluetooth_decimation == UINT8_MAX) || (sd_card_config2_data->output_bluetooth_decimation == 0)) sd_card_config2_data->output_bluetooth_decimation = 1;
+        if (sd_card_config2_data->output_bluetooth_precision == UINT8_MAX) sd_card_config2_data->output_bluetooth_precision = 1;
+        if (sd_card_config2_data->output_tcp_enable == UINT8_MAX) sd_card_config2_data->output_tcp_enable = 0;
+        if (sd_card_config2_data->output_tcp_port == UINT16_MAX) sd_card_config2_data->output_tcp_port = 10110;
+        if (sd_card_config2_data->output_tcp_sentences[0] == '\0') strcpy(sd_card_config2_data->output_tcp_sentences, "all");
+        if ((sd_card_config2_data->output_tcp_decimation == UINT8_MAX) || (sd_card_config2_data->output_tcp_decimation == 0)) sd_card_config2_data->output_tcp_decimation = 1;
+        if (sd_card_config2_data->output_tcp_precision == UINT8_MAX) sd_card_config2_data->output_tcp_precision = 1;
+        if (sd_card_config2_data->output_usb_enable == UINT8_MAX) sd_card_config2_data->output_usb_enable = 0;
+        if (sd_card_config2_data->output_usb_sentences[0] == '\0') strcpy(sd_card_config2_data->output_usb_sentences, "all");
+        if ((sd_card_config2_data->output_usb_decimation == UINT8_MAX) || (sd_card_config2_data->output_usb_decimation == 0)) sd_card_config2_data->output_usb_decimation = 1;
+        if (sd_card_config2_data->output_usb_precision == UINT8_MAX) sd_card_config2_data->output_usb_precision = 1;
+        if (sd_card_config2_data->ubx_bridge_enable == UINT8_MAX) sd_card_config2_data->ubx_bridge_enable = 0;
+        if (sd_card_config2_data->ubx_bridge_transport == UINT8_MAX) sd_card_config2_data->ubx_bridge_transport = 0;
+        if (sd_card_config2_data->ubx_bridge_port == UINT16_MAX) sd_card_config2_data->ubx_bridge_port = 2000;
+        if (sd_card_config2_data->nmea_source == UINT8_MAX) sd_card_config2_data->nmea_source = 0;
+        if (sd_card_config2_data->nmea_sentences[0] == '\0') strcpy(sd_card_config2_data->nmea_sentences, "GGA,GSA,GST,GSV,RMC");
+        if ((sd_card_config2_data->nmea_rate == UINT8_MAX) || (sd_card_config2_data->nmea_rate == 0) || (sd_card_config2_data->nmea_rate > 10)) sd_card_config2_data->nmea_rate = 1;
+        if (sd_card_config2_data->task_uart_core > 2) sd_card_config2_data->task_uart_core = 0;
+        if (sd_card_config2_data->task_gnss_core > 2) sd_card_config2_data->task_gnss_core = 0;
+        if (sd_card_config2_data->task_network_core > 2) sd_card_config2_data->task_network_core = 1;
+        if (sd_card_config2_data->diagnostics_csv == UINT8_MAX) sd_card_config2_data->diagnostics_csv = 0;
+        if (sd_card_config2_data->output_usb_enable == 1) sd_card_config2_data->diagnostics_csv = 0;     //The USB serial carries only NMEA then
+        if ((sd_card_config2_data->diagnostics_period == UINT16_MAX) || (sd_card_config2_data->diagnostics_period == 0)) sd_card_config2_data->diagnostics_period = 10;
+        if (sd_card_config2_data->power_mode > 1) sd_card_config2_data->power_mode = 0;
+        if ((sd_card_config2_data->assist_now_offline_period == UINT8_MAX) || (sd_card_config2_data->assist_now_offline_period == 0) || (sd_card_config2_data->assist_now_offline_period > 5)) sd_card_config2_data->assist_now_offline_period = 5;
+        if ((sd_card_config2_data->base_mode == 2) && ((sd_card_config2_data->base_ecef_x == DBL_MAX) || (sd_card_config2_data->base_ecef_y == DBL_MAX) || (sd_card_config2_data->base_ecef_z == DBL_MAX))) sd_card_config2_data->base_mode = UINT8_MAX;
         if ((sd_card_config1_data->timezone[0] != '\0') &&
             (sd_card_config1_data->display_backlight != UINT8_MAX) &&
             (sd_card_config1_data->display_play != UINT8_MAX) &&
@@ -269,7 +975,8 @@ bool sd_card_config_read(struct sd_card_config1 *sd_card_config1_data, struct sd
             (sd_card_config2_data->ntrip_port != UINT16_MAX) &&
             (sd_card_config2_data->ntrip_mount_point[0] != '\0') &&
             (sd_card_config2_data->ntrip_user[0] != '\0') &&
-            (sd_card_config2_data->ntrip_password[0] != '\0')) error = false;
+            (sd_card_config2_data->ntrip_password[0] != '\0') &&
+            (sd_card_config2_data->base_mode != UINT8_MAX)) error = false;
     }
     else error = true;
 
@@ -0,0 +1,144 @@
+/**
+ * @file task_load.cpp
+ *
+ * @brief Task load related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include "task_load.h"
+
+/*
+ * The Arduino FreeRTOS build has no run time statistics, so every task marks
+ * the end of its work before it blocks and the begin after it wakes up. The
+ * busy time includes the time a task was preempted by a higher priority task
+ * on the same core and the time it blocked inside of its work (for example on
+ * a socket).
+ */
+
+portMUX_TYPE task_load_taskmux = portMUX_INITIALIZER_UNLOCKED;
+unsigned long task_load_start[TASK_LOAD_TASKS];
+uint64_t task_load_busy[TASK_LOAD_TASKS];
+
+const char static PROGMEM task_load_text_0[] = "uart";
+const char static PROGMEM task_load_text_1[] = "gnss";
+const char static PROGMEM task_load_text_2[] = "network";
+const char static PROGMEM task_load_text_3[] = "ui";
+const char static PROGMEM task_load_text_4[] = "bluetooth";
+const char static PROGMEM task_load_text_5[] = "connect";
+const char* const PROGMEM task_load_text[] = {task_load_text_0, task_load_text_1, task_load_text_2, task_load_text_3, task_load_text_4, task_load_text_5};
+
+/**
+ * @brief Mark the begin of the work of a task after it woke up
+ * @param [in] task
+ */
+void task_load_begin(uint8_t task)
+{
+    task_load_start[task] = micros();
+}
+
+/**
+ * @brief Mark the end of the work of a task before it blocks
+ * @param [in] task
+ */
+void task_load_end(uint8_t task)
+{
+    unsigned long busy = 0;
+
+    busy = (unsigned long)(micros() - task_load_start[task]);
+
+    portENTER_CRITICAL(&task_load_taskmux);
+    task_load_busy[task] = task_load_busy[task] + busy;
+    portEXIT_CRITICAL(&task_load_taskmux);
+}
+
+/**
+ * @brief Transfer the load of the tasks
+ * @param [in] task_load_data
+ */
+void task_load_transfer(struct task_load *task_load_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static unsigned long report_millis = millis();
+    static uint64_t last_busy[TASK_LOAD_TASKS];
+    static uint64_t report_busy[TASK_LOAD_TASKS];
+    uint64_t busy[TASK_LOAD_TASKS];
+    uint32_t elapsed = 0;
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&task_load_taskmux);
+        for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1) busy[counter] = task_load_busy[counter];
+        portEXIT_CRITICAL(&task_load_taskmux);
+
+        elapsed = (uint32_t)(curr_millis - last_millis);
+        for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1)
+        {
+            task_load_data->load[counter] = (uint8_t)((busy[counter] - last_busy[counter]) / 10 / elapsed);
+            if (task_load_data->load[counter] > 100) task_load_data->load[counter] = 100;
+            if (task_load_data->load[counter] > task_load_data->load_max[counter]) task_load_data->load_max[counter] = task_load_data->load[counter];
+            last_busy[counter] = busy[counter];
+        }
+        task_load_data->update = true;
+        last_millis = curr_millis;
+
+        if ((unsigned long)(curr_millis - report_millis) > TASK_LOAD_REPORT)
+        {
+            elapsed = (uint32_t)(curr_millis - report_millis);
+            Serial.print(F("Task load ("));
+            for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1)
+            {
+                Serial.printf("%s%s %lu%%", (counter > 0) ? ", " : "", task_load_text[counter], (unsigned long)((busy[counter] - report_busy[counter]) / 10 / elapsed));
+                report_busy[counter] = busy[counter];
+            }
+            Serial.print(F(")... ok\n"));
+            report_millis = curr_millis;
+        }
+    }
+}
+
+/**
+ * @brief Initialize the task load
+ * @param [in] task_load_data
+ */
+void task_load_init(struct task_load *task_load_data)
+{
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    for (counter = 0; counter < TASK_LOAD_TASKS; counter = counter + 1)
+    {
+        task_load_start[counter] = micros();
+        task_load_busy[counter] = 0;
+        task_load_data->load[counter] = 0;
+        task_load_data->load_max[counter] = 0;
+    }
+    task_load_data->update = false;
+}
@@ -0,0 +1,305 @@
+/**
+ * @file uart_reader.cpp
+ *
+ * @brief UART reader related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include "uart_reader.h"
+#include "ring_buffer.h"
+
+/*
+ * The UART reader task drains Serial2 on every receive event, independent of
+ * any client. The raw bytes go into a ring buffer that the u-blox library
+ * reads through uart_reader_stream, complete NMEA sentences are published
+ * with the time stamp of their '$' to the subscribed sinks. After every drain
+ * the sinks are called with length 0, so they can close an idle epoch.
+ */
+
+portMUX_TYPE uart_reader_taskmux = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t uart_reader_handle = NULL;
+uart_reader_stream uart_reader_gnss;
+struct ring_buffer uart_reader_ring_buffer;
+uint8_t uart_reader_buffer[UART_READER_BUFFER];
+uart_reader_sink uart_reader_sinks[UART_READER_SINKS];
+uint8_t uart_reader_sink_count = 0;
+char uart_reader_sentence[UART_READER_SENTENCE];
+uint8_t uart_reader_sentence_length = 0;
+uint32_t uart_reader_sentence_timestamp = 0;
+uint32_t uart_reader_bytes = 0;
+uint32_t uart_reader_sentences = 0;
+uint32_t uart_reader_checksum_errors = 0;
+struct ring_buffer *uart_reader_tap_ring_buffer = nullptr;
+
+/**
+ * @brief Get the bytes available for the u-blox library
+ * @return available bytes
+ */
+int uart_reader_stream::available(void)
+{
+    return (int)ring_buffer_used(&uart_reader_ring_buffer);
+}
+
+/**
+ * @brief Read one byte for the u-blox library
+ * @return data or -1
+ */
+int uart_reader_stream::read(void)
+{
+    const uint8_t *data = nullptr;
+    int value = -1;
+
+    if (ring_buffer_peek(&uart_reader_ring_buffer, &data) > 0)
+    {
+        value = data[0];
+        ring_buffer_consume(&uart_reader_ring_buffer, 1);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Peek one byte for the u-blox library
+ * @return data or -1
+ */
+int uart_reader_stream::peek(void)
+{
+    const uint8_t *data = nullptr;
+
+    if (ring_buffer_peek(&uart_reader_ring_buffer, &data) > 0) return data[0];
+
+    return -1;
+}
+
+/**
+ * @brief Write one byte from the u-blox library to the GNSS
+ * @param [in] data
+ * @return length
+ */
+size_t uart_reader_stream::write(uint8_t data)
+{
+    return Serial2.write(data);
+}
+
+/**
+ * @brief Write data from the u-blox library to the GNSS
+ * @param [in] data, length
+ * @return length
+ */
+size_t uart_reader_stream::write(const uint8_t *data, size_t length)
+{
+    return Serial2.write(data, length);
+}
+
+/**
+ * @brief Wake the UART reader (called from the UART event task)
+ */
+void uart_reader_receive(void)
+{
+    if (uart_reader_handle != NULL) xTaskNotifyGive(uart_reader_handle);
+}
+
+/**
+ * @brief Check the checksum of a NMEA sentence
+ * @param [in] sentence, length
+ * @return error
+ */
+bool uart_reader_checksum(const char *sentence, uint8_t length)
+{
+    uint8_t checksum = 0;
+    uint8_t counter = 1;
+    char hex[3];
+
+    while ((counter < length) && (sentence[counter] != '*'))
+    {
+        checksum = checksum ^ (uint8_t)sentence[counter];
+        counter = counter + 1;
+    }
+    if ((counter + 2) >= length) return true;
+    hex[0] = sentence[counter + 1];
+    hex[1] = sentence[counter + 2];
+    hex[2] = '\0';
+    if (strtoul(hex, nullptr, 16) != checksum) return true;
+
+    return false;
+}
+
+/**
+ * @brief Publish a NMEA sentence to the sinks
+ * @param [in] sentence, length (0 after a drain), timestamp
+ */
+void uart_reader_publish(const char *sentence, uint8_t length, uint32_t timestamp)
+{
+    uint8_t counter = 0;
+    uint8_t sink_count = 0;
+
+    sink_count = __atomic_load_n(&uart_reader_sink_count, __ATOMIC_ACQUIRE);
+    for (counter = 0; counter < sink_count; counter = counter + 1) uart_reader_sinks[counter](sentence, length, timestamp);
+}
+
+/**
+ * @brief Frame NMEA sentences and publish them to the sinks
+ * @param [in] data
+ */
+void uart_reader_frame(uint8_t data)
+{
+    if (data == '$')
+    {
+        uart_reader_sentence_length = 0;
+        uart_reader_sentence_timestamp = millis();
+    }
+    if (uart_reader_sentence_length < sizeof(uart_reader_sentence))
+    {
+        uart_reader_sentence[uart_reader_sentence_length] = (char)data;
+        uart_reader_sentence_length = uart_reader_sentence_length + 1;
+    }
+    else uart_reader_sentence_length = 0;
+    if ((data == '\n') && (uart_reader_sentence_length > 6) && (uart_reader_sentence[0] == '$'))
+    {
+        if (uart_reader_checksum(uart_reader_sentence, uart_reader_sentence_length) == false)
+        {
+            uart_reader_publish(uart_reader_sentence, uart_reader_sentence_length, uart_reader_sentence_timestamp);
+            uart_reader_sentences = uart_reader_sentences + 1;
+        }
+        else uart_reader_checksum_errors = uart_reader_checksum_errors + 1;
+        uart_reader_sentence_length = 0;
+    }
+}
+
+/**
+ * @brief Transfer data from the UART reader
+ * @param [in] uart_reader_data
+ */
+void uart_reader_transfer(struct uart_reader *uart_reader_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static uint32_t last_bytes = 0;
+    uint32_t bytes = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&uart_reader_taskmux);
+        bytes = uart_reader_bytes;
+        uart_reader_data->sentences = uart_reader_sentences;
+        uart_reader_data->checksum_errors = uart_reader_checksum_errors;
+        portEXIT_CRITICAL(&uart_reader_taskmux);
+        uart_reader_data->bytes_per_second = (uint32_t)((uint64_t)(bytes - last_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        uart_reader_data->drops = uart_reader_ring_buffer.drops;
+        uart_reader_data->update = true;
+        last_bytes = bytes;
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Subscribe a sink to the NMEA sentences (the sink is called in the UART reader task)
+ * @param [in] sink
+ * @return error
+ */
+bool uart_reader_subscribe(uart_reader_sink sink)
+{
+    bool error = false;
+
+    esp_task_wdt_reset();
+    portENTER_CRITICAL(&uart_reader_taskmux);
+    if (uart_reader_sink_count < UART_READER_SINKS)
+    {
+        uart_reader_sinks[uart_reader_sink_count] = sink;
+        __atomic_store_n(&uart_reader_sink_count, uart_reader_sink_count + 1, __ATOMIC_RELEASE);
+    }
+    else error = true;
+    portEXIT_CRITICAL(&uart_reader_taskmux);
+
+    return error;
+}
+
+/**
+ * @brief Copy all received bytes additionally into a ring buffer (nullptr to stop)
+ * @param [in] ring_buffer_data
+ */
+void uart_reader_tap(struct ring_buffer *ring_buffer_data)
+{
+    __atomic_store_n(&uart_reader_tap_ring_buffer, ring_buffer_data, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Wait for a receive event (or the wait time)
+ */
+void uart_reader_wait(void)
+{
+    esp_task_wdt_reset();
+    if (uart_reader_handle == NULL) uart_reader_handle = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(UART_READER_WAIT));
+}
+
+/**
+ * @brief Drain the UART after a receive event (or the wait time)
+ */
+void uart_reader(void)
+{
+    uint8_t data[UART_READER_CHUNK];
+    int length = 0;
+    int counter = 0;
+    struct ring_buffer *tap = nullptr;
+
+    esp_task_wdt_reset();
+    while (Serial2.available() > 0)
+    {
+        length = Serial2.read(data, sizeof(data));
+        if (length <= 0) break;
+        ring_buffer_write(&uart_reader_ring_buffer, data, (uint32_t)length);
+        tap = __atomic_load_n(&uart_reader_tap_ring_buffer, __ATOMIC_ACQUIRE);
+        if (tap != nullptr) ring_buffer_write(tap, data, (uint32_t)length);
+        for (counter = 0; counter < length; counter = counter + 1) uart_reader_frame(data[counter]);
+
+        portENTER_CRITICAL(&uart_reader_taskmux);
+        uart_reader_bytes = uart_reader_bytes + length;
+        portEXIT_CRITICAL(&uart_reader_taskmux);
+    }
+    uart_reader_publish(nullptr, 0, millis());
+}
+
+/**
+ * @brief Initialize the UART reader
+ * @param [in] uart_reader_data
+ */
+void uart_reader_init(struct uart_reader *uart_reader_data)
+{
+    esp_task_wdt_reset();
+    ring_buffer_init(&uart_reader_ring_buffer, uart_reader_buffer, sizeof(uart_reader_buffer));
+    Serial2.setRxBufferSize(UART_READER_RX_BUFFER);
+    Serial2.begin(115200);
+    Serial2.onReceive(uart_reader_receive);
+    uart_reader_data->bytes_per_second = 0;
+    uart_reader_data->sentences = 0;
+    uart_reader_data->checksum_errors = 0;
+    uart_reader_data->drops = 0;
+    uart_reader_data->update = true;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file ubx.cpp
+ *
+ * @brief UBX related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ubx.h"
+
+/**
+ * @brief Calculate the 8-bit Fletcher checksum of a UBX frame
+ * @param [in] data, length
+ * @param [out] checksum_a, checksum_b
+ */
+void ubx_checksum(const uint8_t *data, uint16_t length, uint8_t *checksum_a, uint8_t *checksum_b)
+{
+    uint16_t counter = 0;
+
+    *checksum_a = 0;
+    *checksum_b = 0;
+    for (counter = 0; counter < length; counter = counter + 1)
+    {
+        *checksum_a = *checksum_a + data[counter];
+        *checksum_b = *checksum_b + *checksum_a;
+    }
+}
+
+/**
+ * @brief Parse one byte of a UBX stream
+ * @param [in,out] ubx_parser_data
+ * @param [in] data
+ * @return true if a complete frame with valid checksum is in ubx_parser_data->frame
+ */
+bool ubx_parse(struct ubx_parser *ubx_parser_data, uint8_t data)
+{
+    bool complete = false;
+    uint8_t checksum_a = 0;
+    uint8_t checksum_b = 0;
+
+    if (ubx_parser_data->length == 0)
+    {
+        if (data == UBX_SYNC_CHAR_1)
+        {
+            ubx_parser_data->frame[0] = data;
+            ubx_parser_data->length = 1;
+        }
+    }
+    else if (ubx_parser_data->length == 1)
+    {
+        if (data == UBX_SYNC_CHAR_2)
+        {
+            ubx_parser_data->frame[1] = data;
+            ubx_parser_data->length = 2;
+        }
+        else if (data != UBX_SYNC_CHAR_1) ubx_parser_data->length = 0;
+    }
+    else
+    {
+        ubx_parser_data->frame[ubx_parser_data->length] = data;
+        ubx_parser_data->length = ubx_parser_data->length + 1;
+        if (ubx_parser_data->length == 6)
+        {
+            ubx_parser_data->frame_length = (uint16_t)(((uint16_t)ubx_parser_data->frame[5] << 8) | ubx_parser_data->frame[4]) + 8;
+            if (ubx_parser_data->frame_length > UBX_FRAME_LENGTH_MAX)
+            {
+                ubx_parser_data->errors = ubx_parser_data->errors + 1;
+                ubx_parser_data->length = 0;
+            }
+        }
+        else if ((ubx_parser_data->length > 6) && (ubx_parser_data->length == ubx_parser_data->frame_length))
+        {
+            ubx_checksum(&ubx_parser_data->frame[2], ubx_parser_data->length - 4, &checksum_a, &checksum_b);
+            if ((ubx_parser_data->frame[ubx_parser_data->length - 2] == checksum_a) && (ubx_parser_data->frame[ubx_parser_data->length - 1] == checksum_b)) complete = true;
+            else ubx_parser_data->errors = ubx_parser_data->errors + 1;
+            ubx_parser_data->length = 0;
+        }
+    }
+
+    return complete;
+}
+
+/**
+ * @brief Initialize the UBX parser
+ * @param [in] ubx_parser_data
+ */
+void ubx_parser_init(struct ubx_parser *ubx_parser_data)
+{
+    ubx_parser_data->length = 0;
+    ubx_parser_data->frame_length = 0;
+    ubx_parser_data->errors = 0;
+}
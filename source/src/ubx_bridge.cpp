@@ -0,0 +1,281 @@
+/**
+ * @file ubx_bridge.cpp
+ *
+ * @brief UBX bridge related functionality implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+#include <Arduino.h>
+#include <M5Core2.h>
+#include <esp_task_wdt.h>
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <BluetoothSerial.h>
+#include "ubx_bridge.h"
+#include "uart_reader.h"
+#include "ring_buffer.h"
+#include "sd_card.h"
+
+/*
+ * Transparent bridge between u-center (TCP or the Bluetooth SPP port) and
+ * UART1 of the GNSS. The UART reader copies every received chunk into the
+ * bridge ring buffer, the pump sends it in place and writes the data of
+ * the client in chunks to the GNSS. While a client is connected the
+ * firmware pauses its own polling and writes to the GNSS.
+ */
+
+portMUX_TYPE ubx_bridge_taskmux = portMUX_INITIALIZER_UNLOCKED;
+WiFiServer ubx_bridge_server;
+WiFiClient ubx_bridge_client;
+struct ring_buffer ubx_bridge_ring_buffer;
+uint8_t *ubx_bridge_buffer = nullptr;
+uint8_t ubx_bridge_transport = UBX_BRIDGE_TRANSPORT_TCP;
+bool ubx_bridge_started = false;
+bool ubx_bridge_connected = false;
+unsigned long ubx_bridge_connect_millis = 0;
+unsigned long ubx_bridge_millis = 0;
+uint32_t ubx_bridge_rx_bytes = 0;
+uint32_t ubx_bridge_tx_bytes = 0;
+uint32_t ubx_bridge_rx_bytes_connect = 0;
+uint32_t ubx_bridge_tx_bytes_connect = 0;
+extern BluetoothSerial bt_serial;
+extern uart_reader_stream uart_reader_gnss;
+
+/**
+ * @brief Check if a client uses the UBX bridge (the firmware pauses its own GNSS polling)
+ * @return active
+ */
+bool ubx_bridge_active(void)
+{
+    return __atomic_load_n(&ubx_bridge_connected, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Check if the Bluetooth SPP port belongs to the UBX bridge
+ * @return bluetooth
+ */
+bool ubx_bridge_bluetooth(void)
+{
+    return (ubx_bridge_started == true) && (ubx_bridge_transport == UBX_BRIDGE_TRANSPORT_BLUETOOTH);
+}
+
+/**
+ * @brief Start the bridge for a new client
+ */
+void ubx_bridge_connect(void)
+{
+    ring_buffer_clear(&ubx_bridge_ring_buffer);
+    ubx_bridge_connect_millis = millis();
+    ubx_bridge_millis = ubx_bridge_connect_millis;
+    ubx_bridge_rx_bytes_connect = ubx_bridge_rx_bytes;
+    ubx_bridge_tx_bytes_connect = ubx_bridge_tx_bytes;
+    uart_reader_tap(&ubx_bridge_ring_buffer);
+    __atomic_store_n(&ubx_bridge_connected, true, __ATOMIC_RELEASE);
+    Serial.print(F("Connect UBX bridge client... ok\n"));
+}
+
+/**
+ * @brief Stop the bridge and log the throughput of the session
+ */
+void ubx_bridge_disconnect(void)
+{
+    unsigned long duration = 0;
+    uint32_t rx_bytes = 0;
+    uint32_t tx_bytes = 0;
+
+    uart_reader_tap(nullptr);
+    if (ubx_bridge_transport == UBX_BRIDGE_TRANSPORT_TCP) ubx_bridge_client.stop();
+    __atomic_store_n(&ubx_bridge_connected, false, __ATOMIC_RELEASE);
+    duration = (unsigned long)(millis() - ubx_bridge_connect_millis);
+    if (duration == 0) duration = 1;
+
+    portENTER_CRITICAL(&ubx_bridge_taskmux);
+    rx_bytes = ubx_bridge_rx_bytes - ubx_bridge_rx_bytes_connect;
+    tx_bytes = ubx_bridge_tx_bytes - ubx_bridge_tx_bytes_connect;
+    portEXIT_CRITICAL(&ubx_bridge_taskmux);
+    Serial.printf("Disconnect UBX bridge client (%lu s, %lu B/s to client, %lu B/s to GNSS, %lu drops)... ok\n", duration / 1000, (unsigned long)((uint64_t)rx_bytes * 1000 / duration), (unsigned long)((uint64_t)tx_bytes * 1000 / duration), (unsigned long)ubx_bridge_ring_buffer.drops);
+}
+
+/**
+ * @brief Transfer data from the UBX bridge
+ * @param [in] ubx_bridge_data
+ */
+void ubx_bridge_transfer(struct ubx_bridge *ubx_bridge_data)
+{
+    unsigned long curr_millis = 0;
+    static unsigned long last_millis = millis();
+    static uint32_t last_rx_bytes = 0;
+    static uint32_t last_tx_bytes = 0;
+    uint32_t rx_bytes = 0;
+    uint32_t tx_bytes = 0;
+
+    esp_task_wdt_reset();
+    curr_millis = millis();
+    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    {
+        portENTER_CRITICAL(&ubx_bridge_taskmux);
+        rx_bytes = ubx_bridge_rx_bytes;
+        tx_bytes = ubx_bridge_tx_bytes;
+        portEXIT_CRITICAL(&ubx_bridge_taskmux);
+        if (ubx_bridge_data->active != ubx_bridge_active())
+        {
+            ubx_bridge_data->active = ubx_bridge_active();
+            ubx_bridge_data->update = true;
+        }
+        ubx_bridge_data->rx_bytes_per_second = (uint32_t)((uint64_t)(rx_bytes - last_rx_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        ubx_bridge_data->tx_bytes_per_second = (uint32_t)((uint64_t)(tx_bytes - last_tx_bytes) * 1000 / (unsigned long)(curr_millis - last_millis));
+        ubx_bridge_data->drops = ubx_bridge_ring_buffer.drops;
+        last_rx_bytes = rx_bytes;
+        last_tx_bytes = tx_bytes;
+        last_millis = curr_millis;
+    }
+}
+
+/**
+ * @brief Pump the data between the client and the GNSS
+ */
+void ubx_bridge(void)
+{
+    uint8_t data[UBX_BRIDGE_CHUNK];
+    const uint8_t *pending = nullptr;
+    uint32_t length = 0;
+    ssize_t sent = 0;
+    int counter = 0;
+    bool client = false;
+
+    esp_task_wdt_reset();
+    if (ubx_bridge_started == false) return;
+    if (ubx_bridge_transport == UBX_BRIDGE_TRANSPORT_TCP)
+    {
+        if (ubx_bridge_server.hasClient() == true)
+        {
+            if (ubx_bridge_active() == true) ubx_bridge_server.available().stop();
+            else
+            {
+                ubx_bridge_client = ubx_bridge_server.available();
+                ubx_bridge_client.setNoDelay(true);
+                ubx_bridge_connect();
+            }
+        }
+        client = (ubx_bridge_active() == true) && (ubx_bridge_client.connected() == true);
+    }
+    else client = bt_serial.hasClient();
+    if ((client == true) && (ubx_bridge_active() == false)) ubx_bridge_connect();
+    if ((client == false) && (ubx_bridge_active() == true)) ubx_bridge_disconnect();
+    if (client == false) return;
+
+    while (1)
+    {
+        length = ring_buffer_peek(&ubx_bridge_ring_buffer, &pending);
+        if (length == 0)
+        {
+            ubx_bridge_millis = millis();
+            break;
+        }
+        if (ubx_bridge_transport == UBX_BRIDGE_TRANSPORT_TCP)
+        {
+            sent = send(ubx_bridge_client.fd(), pending, length, MSG_DONTWAIT);
+            if ((sent < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+            {
+                ubx_bridge_disconnect();
+                return;
+            }
+        }
+        else sent = (ssize_t)bt_serial.write(pending, length);
+        if (sent <= 0)
+        {
+            if ((unsigned long)(millis() - ubx_bridge_millis) > UBX_BRIDGE_TIMEOUT) ubx_bridge_disconnect();
+            break;
+        }
+        ring_buffer_consume(&ubx_bridge_ring_buffer, (uint32_t)sent);
+        ubx_bridge_millis = millis();
+
+        portENTER_CRITICAL(&ubx_bridge_taskmux);
+        ubx_bridge_rx_bytes = ubx_bridge_rx_bytes + (uint32_t)sent;
+        portEXIT_CRITICAL(&ubx_bridge_taskmux);
+        if ((uint32_t)sent < length) break;
+    }
+    if (ubx_bridge_active() == false) return;
+
+    while (1)
+    {
+        if (ubx_bridge_transport == UBX_BRIDGE_TRANSPORT_TCP) counter = ubx_bridge_client.read(data, sizeof(data));
+        else
+        {
+            counter = bt_serial.available();
+            if (counter > (int)sizeof(data)) counter = sizeof(data);
+            if (counter > 0) counter = (int)bt_serial.readBytes(data, (size_t)counter);
+        }
+        if (counter <= 0) break;
+        uart_reader_gnss.write(data, (size_t)counter);
+
+        portENTER_CRITICAL(&ubx_bridge_taskmux);
+        ubx_bridge_tx_bytes = ubx_bridge_tx_bytes + (uint32_t)counter;
+        portEXIT_CRITICAL(&ubx_bridge_taskmux);
+    }
+}
+
+/**
+ * @brief Allocate the buffer of the UBX bridge (called at startup, before the heap fragments)
+ * @return error
+ */
+bool ubx_bridge_reserve(void)
+{
+    esp_task_wdt_reset();
+    ubx_bridge_buffer = (uint8_t *)ps_malloc(UBX_BRIDGE_BUFFER);
+    if (ubx_bridge_buffer == nullptr) ubx_bridge_buffer = (uint8_t *)malloc(UBX_BRIDGE_BUFFER);
+
+    return (ubx_bridge_buffer == nullptr);
+}
+
+/**
+ * @brief Initialize the UBX bridge
+ * @param [in] ubx_bridge_data, sd_card_config2_data
+ * @return error
+ */
+bool ubx_bridge_init(struct ubx_bridge *ubx_bridge_data, struct sd_card_config2 *sd_card_config2_data)
+{
+    bool error = false;
+
+    esp_task_wdt_reset();
+    if (ubx_bridge_buffer != nullptr)
+    {
+        ring_buffer_init(&ubx_bridge_ring_buffer, ubx_bridge_buffer, UBX_BRIDGE_BUFFER);
+        ubx_bridge_transport = sd_card_config2_data->ubx_bridge_transport;
+        if (ubx_bridge_transport == UBX_BRIDGE_TRANSPORT_TCP)
+        {
+            ubx_bridge_server.begin(sd_card_config2_data->ubx_bridge_port);
+            ubx_bridge_server.setNoDelay(true);
+        }
+        ubx_bridge_started = true;
+    }
+    else error = true;
+    ubx_bridge_data->active = false;
+    ubx_bridge_data->rx_bytes_per_second = 0;
+    ubx_bridge_data->tx_bytes_per_second = 0;
+    ubx_bridge_data->drops = 0;
+    ubx_bridge_data->update = true;
+
+    return error;
+}
@@ -30,11 +30,29 @@
 #include <esp_task_wdt.h>
 #include <SparkFun_u-blox_GNSS_v3.h>
 #include <WiFi.h>
+#include <Preferences.h>
 #include "wlan_client.h"
 #include "sd_card.h"
+#include "bus.h"
 
-extern portMUX_TYPE subtask2_taskmux; 
-extern bool wlan_client_active;
+portMUX_TYPE wlan_client_taskmux = portMUX_INITIALIZER_UNLOCKED;
+bool wlan_client_got_ip = false;
+bool wlan_client_lost = false;
+uint8_t wlan_client_reason = 0;
+uint8_t wlan_client_state = WLAN_CLIENT_STATE_IDLE;
+uint8_t wlan_client_state_next = WLAN_CLIENT_STATE_IDLE;
+unsigned long wlan_client_millis = 0;
+unsigned long wlan_client_retry = WLAN_CLIENT_RETRY_MIN;
+unsigned long wlan_client_lost_millis = 0;
+unsigned long wlan_client_timeout = WLAN_CLIENT_CONNECT_TIMEOUT;
+uint8_t wlan_client_profiles = 0;
+uint8_t wlan_client_profile = 0;
+uint8_t wlan_client_next = 0;
+bool wlan_client_fast = false;
+char *wlan_client_ssid[WLAN_CLIENT_PROFILES];
+char *wlan_client_password[WLAN_CLIENT_PROFILES];
+struct wlan_client_cache wlan_client_cache_data[WLAN_CLIENT_PROFILES];
+Preferences wlan_client_preferences;
 
 /**
  * @brief Transfer data from the WLAN client
@@ -42,48 +60,293 @@ extern bool wlan_client_active;
  */
 void wlan_client_transfer(struct wlan_client *wlan_client_data)
 {
-    unsigned long curr_millis = 0;
-    static unsigned long last_millis = millis();
+    static struct bus_link bus_link_data;
+    static uint32_t version = 0;
  
     esp_task_wdt_reset();
-    curr_millis = millis();
-    if ((unsigned long)(curr_millis - last_millis) > 1000)
+    if (bus_read(BUS_TOPIC_LINK, &bus_link_data, &version) == true)
     {
-        portENTER_CRITICAL(&subtask2_taskmux);
-        if (wlan_client_data->active != wlan_client_active)
+        if (wlan_client_data->active != bus_link_data.wlan_client_active)
         {
-            wlan_client_data->active = wlan_client_active;
+            wlan_client_data->active = bus_link_data.wlan_client_active;
             wlan_client_data->update = true;
         }
-        portEXIT_CRITICAL(&subtask2_taskmux);
-        last_millis = curr_millis;
     }
 }
 
 /**
- * @brief Communication from the WLAN client
- * @param [in] sd_card_config2_data
+ * @brief Event handler of the WLAN client (called from the WiFi event task)
+ * @param [in] event, info
+ */
+void wlan_client_event(WiFiEvent_t event, WiFiEventInfo_t info)
+{
+    portENTER_CRITICAL(&wlan_client_taskmux);
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) wlan_client_got_ip = true;
+    if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+    {
+        wlan_client_lost = true;
+        wlan_client_reason = info.wifi_sta_disconnected.reason;
+    }
+    if (event == ARDUINO_EVENT_WIFI_STA_LOST_IP) wlan_client_lost = true;
+    portEXIT_CRITICAL(&wlan_client_taskmux);
+}
+
+/**
+ * @brief Save the BSSID and channel of the connected access point for the fast connect
  * @return error
  */
-bool wlan_client(struct sd_card_config2 *sd_card_config2_data)
+bool wlan_client_cache_save(void)
 {
     bool error = false;
-    uint8_t counter = 0;
+    struct wlan_client_cache wlan_client_cache_temp;
+    char key[16];
 
     esp_task_wdt_reset();
-    if (WiFi.status() != WL_CONNECTED) 
+    memset(&wlan_client_cache_temp, 0, sizeof(wlan_client_cache_temp));
+    strncpy(wlan_client_cache_temp.ssid, wlan_client_ssid[wlan_client_profile], sizeof(wlan_client_cache_temp.ssid) - 1);
+    memcpy(wlan_client_cache_temp.bssid, WiFi.BSSID(), sizeof(wlan_client_cache_temp.bssid));
+    wlan_client_cache_temp.channel = (uint8_t)WiFi.channel();
+    if (memcmp(&wlan_client_cache_temp, &wlan_client_cache_data[wlan_client_profile], sizeof(wlan_client_cache_temp)) != 0)
     {
-        WiFi.begin(sd_card_config2_data->wlan_ssid, sd_card_config2_data->wlan_password);
-        do
+        memcpy(&wlan_client_cache_data[wlan_client_profile], &wlan_client_cache_temp, sizeof(wlan_client_cache_temp));
+        snprintf(key, sizeof(key), "%s%u", WLAN_CLIENT_KEY_PROFILE, wlan_client_profile + 1);
+        if (wlan_client_preferences.begin(WLAN_CLIENT_NAMESPACE, false) == true)
         {
-            counter = counter + 1;
-            delay(500);
+            if (wlan_client_preferences.putBytes(key, &wlan_client_cache_temp, sizeof(wlan_client_cache_temp)) != sizeof(wlan_client_cache_temp)) error = true;
+            wlan_client_preferences.end();
         }
-        while ((WiFi.status() != WL_CONNECTED) && (counter < 5));
-        if (WiFi.status() == WL_CONNECTED) error = false;
         else error = true;
     }
-    else error = false;
 
     return error;
 }
+
+/**
+ * @brief Invalidate the cached access point of the actual profile after a failed fast connect
+ * @return error
+ */
+bool wlan_client_cache_clear(void)
+{
+    bool error = false;
+    char key[16];
+
+    esp_task_wdt_reset();
+    memset(&wlan_client_cache_data[wlan_client_profile], 0, sizeof(wlan_client_cache_data[wlan_client_profile]));
+    snprintf(key, sizeof(key), "%s%u", WLAN_CLIENT_KEY_PROFILE, wlan_client_profile + 1);
+    if (wlan_client_preferences.begin(WLAN_CLIENT_NAMESPACE, false) == true)
+    {
+        if (wlan_client_preferences.isKey(key) == true) error = !wlan_client_preferences.remove(key);
+        wlan_client_preferences.end();
+    }
+    else error = true;
+
+    return error;
+}
+
+/**
+ * @brief Start the connection to the next profile with a cached access point or start a scan
+ */
+void wlan_client_connect(void)
+{
+    uint8_t counter = 0;
+
+    esp_task_wdt_reset();
+    for (counter = wlan_client_next; counter < wlan_client_profiles; counter = counter + 1)
+    {
+        if ((wlan_client_cache_data[counter].channel != 0) && (strcmp(wlan_client_cache_data[counter].ssid, wlan_client_ssid[counter]) == 0)) break;
+    }
+    if (counter < wlan_client_profiles)
+    {
+        WiFi.begin(wlan_client_ssid[counter], wlan_client_password[counter], wlan_client_cache_data[counter].channel, wlan_client_cache_data[counter].bssid, true);
+        wlan_client_profile = counter;
+        wlan_client_next = counter + 1;
+        wlan_client_fast = true;
+        wlan_client_timeout = WLAN_CLIENT_FAST_CONNECT_TIMEOUT;
+        wlan_client_state = WLAN_CLIENT_STATE_CONNECTING;
+    }
+    else
+    {
+        WiFi.scanNetworks(true);
+        wlan_client_state = WLAN_CLIENT_STATE_SCANNING;
+    }
+    wlan_client_millis = millis();
+}
+
+/**
+ * @brief Evaluate the scan and connect to the profile with the highest priority in range
+ */
+void wlan_client_scan(void)
+{
+    int16_t networks = 0;
+    int16_t counter1 = 0;
+    uint8_t counter2 = 0;
+    int16_t best = -1;
+
+    esp_task_wdt_reset();
+    networks = WiFi.scanComplete();
+    if ((networks == WIFI_SCAN_RUNNING) && ((unsigned long)(millis() - wlan_client_millis) < WLAN_CLIENT_SCAN_TIMEOUT)) return;
+    for (counter2 = 0; (counter2 < wlan_client_profiles) && (best < 0); counter2 = counter2 + 1)
+    {
+        for (counter1 = 0; counter1 < networks; counter1 = counter1 + 1)
+        {
+            if (strcmp(WiFi.SSID(counter1).c_str(), wlan_client_ssid[counter2]) == 0)
+            {
+                if ((best < 0) || (WiFi.RSSI(counter1) > WiFi.RSSI(best))) best = counter1;
+            }
+        }
+        if (best >= 0) wlan_client_profile = counter2;
+    }
+    if (best >= 0)
+    {
+        WiFi.begin(wlan_client_ssid[wlan_client_profile], wlan_client_password[wlan_client_profile], WiFi.channel(best), WiFi.BSSID(best), true);
+        wlan_client_fast = false;
+        wlan_client_timeout = WLAN_CLIENT_CONNECT_TIMEOUT;
+        wlan_client_state = WLAN_CLIENT_STATE_CONNECTING;
+    }
+    else
+    {
+        Serial.printf("Scan WLAN client (%d networks, retry in %lu ms)... failed\n", networks, wlan_client_retry);
+        wlan_client_state = WLAN_CLIENT_STATE_WAITING;
+    }
+    if (networks >= 0) WiFi.scanDelete();
+    wlan_client_millis = millis();
+}
+
+/**
+ * @brief Communication from the WLAN client (non-blocking state machine)
+ * @return error
+ */
+bool wlan_client(void)
+{
+    bool error = false;
+    bool got_ip = false;
+    bool lost = false;
+    uint8_t reason = 0;
+    unsigned long curr_millis = 0;
+
+    esp_task_wdt_reset();
+    portENTER_CRITICAL(&wlan_client_taskmux);
+    got_ip = wlan_client_got_ip;
+    lost = wlan_client_lost;
+    reason = wlan_client_reason;
+    wlan_client_got_ip = false;
+    wlan_client_lost = false;
+    portEXIT_CRITICAL(&wlan_client_taskmux);
+
+    if (wlan_client_profiles == 0) return true;
+    curr_millis = millis();
+    switch (wlan_client_state)
+    {
+        case WLAN_CLIENT_STATE_IDLE:
+            wlan_client_connect();
+            break;
+        case WLAN_CLIENT_STATE_SCANNING:
+            wlan_client_scan();
+            break;
+        case WLAN_CLIENT_STATE_CONNECTING:
+            if (got_ip == true)
+            {
+                Serial.printf("Connect WLAN client (profile %u, %s, %lu ms, %lu ms offline)... ok\n", wlan_client_profile + 1, (wlan_client_fast == true) ? "fast" : "scan", (unsigned long)(curr_millis - wlan_client_millis), (unsigned long)(curr_millis - wlan_client_lost_millis));
+                if (wlan_client_cache_save() == true) Serial.print(F("Save WLAN access point... failed\n"));
+                wlan_client_state = WLAN_CLIENT_STATE_CONNECTED;
+                wlan_client_retry = WLAN_CLIENT_RETRY_MIN;
+            }
+            else if ((lost == true) || ((unsigned long)(curr_millis - wlan_client_millis) > wlan_client_timeout))
+            {
+                Serial.printf("Connect WLAN client (profile %u, %s, reason %u)... failed\n", wlan_client_profile + 1, (wlan_client_fast == true) ? "fast" : "scan", reason);
+                WiFi.disconnect();
+                if (wlan_client_fast == true)
+                {
+                    if ((lost == false) || (reason == WIFI_REASON_NO_AP_FOUND))   //Keep the access point after a wrong password or a rejected association
+                    {
+                        if (wlan_client_cache_clear() == true) Serial.print(F("Clear WLAN access point... failed\n"));
+                    }
+                    wlan_client_state_next = WLAN_CLIENT_STATE_IDLE;
+                }
+                else wlan_client_state_next = WLAN_CLIENT_STATE_WAITING;
+                wlan_client_state = WLAN_CLIENT_STATE_DISCONNECTING;
+                wlan_client_millis = curr_millis;
+            }
+            break;
+        case WLAN_CLIENT_STATE_DISCONNECTING:
+            if ((lost == true) || ((unsigned long)(curr_millis - wlan_client_millis) > WLAN_CLIENT_DISCONNECT_TIMEOUT))
+            {
+                wlan_client_state = wlan_client_state_next;                  //The event of the own disconnect must not fail the next attempt
+                wlan_client_millis = curr_millis;
+            }
+            break;
+        case WLAN_CLIENT_STATE_CONNECTED:
+            if (lost == true)
+            {
+                Serial.printf("Disconnect WLAN client (reason %u)... ok\n", reason);
+                wlan_client_state = WLAN_CLIENT_STATE_IDLE;
+                wlan_client_next = 0;
+                wlan_client_lost_millis = curr_millis;
+            }
+            break;
+        case WLAN_CLIENT_STATE_WAITING:
+            if ((unsigned long)(curr_millis - wlan_client_millis) > wlan_client_retry)
+            {
+                wlan_client_retry = wlan_client_retry * 2;
+                if (wlan_client_retry > WLAN_CLIENT_RETRY_MAX) wlan_client_retry = WLAN_CLIENT_RETRY_MAX;
+                wlan_client_state = WLAN_CLIENT_STATE_IDLE;
+                wlan_client_next = 0;
+            }
+            break;
+        default:
+            wlan_client_state = WLAN_CLIENT_STATE_IDLE;
+            break;
+    }
+    if (wlan_client_state == WLAN_CLIENT_STATE_CONNECTED) error = false;
+    else error = true;
+
+    return error;
+}
+
+/**
+ * @brief Initialize the WLAN client
+ * @param [in] sd_card_config2_data
+ */
+void wlan_client_init(struct sd_card_config2 *sd_card_config2_data)
+{
+    uint8_t counter = 0;
+    char key[16];
+
+    esp_task_wdt_reset();
+    wlan_client_profiles = 0;
+    if (sd_card_config2_data->wlan_ssid[0] != '\0')
+    {
+        wlan_client_ssid[wlan_client_profiles] = sd_card_config2_data->wlan_ssid;
+        wlan_client_password[wlan_client_profiles] = sd_card_config2_data->wlan_password;
+        wlan_client_profiles = wlan_client_profiles + 1;
+    }
+    if (sd_card_config2_data->wlan2_ssid[0] != '\0')
+    {
+        wlan_client_ssid[wlan_client_profiles] = sd_card_config2_data->wlan2_ssid;
+        wlan_client_password[wlan_client_profiles] = sd_card_config2_data->wlan2_password;
+        wlan_client_profiles = wlan_client_profiles + 1;
+    }
+    if (sd_card_config2_data->wlan3_ssid[0] != '\0')
+    {
+        wlan_client_ssid[wlan_client_profiles] = sd_card_config2_data->wlan3_ssid;
+        wlan_client_password[wlan_client_profiles] = sd_card_config2_data->wlan3_password;
+        wlan_client_profiles = wlan_client_profiles + 1;
+    }
+    memset(wlan_client_cache_data, 0, sizeof(wlan_client_cache_data));
+    if (wlan_client_preferences.begin(WLAN_CLIENT_NAMESPACE, true) == true)
+    {
+        for (counter = 0; counter < wlan_client_profiles; counter = counter + 1)
+        {
+            snprintf(key, sizeof(key), "%s%u", WLAN_CLIENT_KEY_PROFILE, counter + 1);
+            if (wlan_client_preferences.getBytes(key, &wlan_client_cache_data[counter], sizeof(wlan_client_cache_data[counter])) != sizeof(wlan_client_cache_data[counter])) memset(&wlan_client_cache_data[counter], 0, sizeof(wlan_client_cache_data[counter]));
+        }
+        wlan_client_preferences.end();
+    }
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(false);
+    WiFi.onEvent(wlan_client_event);
+    wlan_client_state = WLAN_CLIENT_STATE_IDLE;
+    wlan_client_retry = WLAN_CLIENT_RETRY_MIN;
+    wlan_client_next = 0;
+    wlan_client_lost_millis = millis();
+}
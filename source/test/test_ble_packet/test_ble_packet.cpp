@@ -0,0 +1,226 @@
+/**
+ * @file test_ble_packet.cpp
+ *
+ * @brief Bluetooth LE packet test implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unity.h>
+#include "ble_packet.h"
+
+uint8_t test_stream[4096];
+uint16_t test_stream_length = 0;
+uint16_t test_sizes[256];
+uint16_t test_notifications = 0;
+uint16_t test_payload = 0;
+
+void setUp(void)
+{
+    test_stream_length = 0;
+    test_notifications = 0;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Simulated notification of the Bluetooth LE stack
+ * @param [in] data, length
+ */
+static void test_send(const uint8_t *data, uint16_t length)
+{
+    TEST_ASSERT_LESS_OR_EQUAL(test_payload, length);
+    TEST_ASSERT_GREATER_THAN(0, length);
+    memcpy(&test_stream[test_stream_length], data, length);
+    test_stream_length = test_stream_length + length;
+    test_sizes[test_notifications] = length;
+    test_notifications = test_notifications + 1;
+}
+
+/**
+ * @brief Build a fix with all fields set
+ * @param [out] ble_packet_fix_data
+ */
+static void test_fix(struct ble_packet_fix *ble_packet_fix_data)
+{
+    ble_packet_fix_data->timestamp = 345600123;
+    ble_packet_fix_data->lat = 481234567;
+    ble_packet_fix_data->lon = -123456789;
+    ble_packet_fix_data->lat_hp = -99;
+    ble_packet_fix_data->lon_hp = 42;
+    ble_packet_fix_data->height = -12345;
+    ble_packet_fix_data->acc = 14;
+    ble_packet_fix_data->fix_type = 3;
+    ble_packet_fix_data->carr_soln = 2;
+    ble_packet_fix_data->num_sv = 31;
+    ble_packet_fix_data->flags = 0x81;
+}
+
+void test_fix_round_trip(void)
+{
+    struct ble_packet_fix fix;
+    struct ble_packet_fix decoded;
+    uint8_t frame[BLE_PACKET_FIX_FRAME_LENGTH];
+
+    test_fix(&fix);
+    memset(&decoded, 0, sizeof(decoded));
+    TEST_ASSERT_EQUAL_UINT16(BLE_PACKET_FIX_FRAME_LENGTH, ble_packet_fix_encode(&fix, frame));
+    TEST_ASSERT_EQUAL_UINT8(BLE_PACKET_FIX_SYNC_CHAR_1, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(BLE_PACKET_FIX_SYNC_CHAR_2, frame[1]);
+    TEST_ASSERT_FALSE(ble_packet_fix_decode(frame, sizeof(frame), &decoded));
+    TEST_ASSERT_EQUAL_UINT32(fix.timestamp, decoded.timestamp);
+    TEST_ASSERT_EQUAL_INT32(fix.lat, decoded.lat);
+    TEST_ASSERT_EQUAL_INT32(fix.lon, decoded.lon);
+    TEST_ASSERT_EQUAL_INT8(fix.lat_hp, decoded.lat_hp);
+    TEST_ASSERT_EQUAL_INT8(fix.lon_hp, decoded.lon_hp);
+    TEST_ASSERT_EQUAL_INT32(fix.height, decoded.height);
+    TEST_ASSERT_EQUAL_UINT32(fix.acc, decoded.acc);
+    TEST_ASSERT_EQUAL_UINT8(fix.fix_type, decoded.fix_type);
+    TEST_ASSERT_EQUAL_UINT8(fix.carr_soln, decoded.carr_soln);
+    TEST_ASSERT_EQUAL_UINT8(fix.num_sv, decoded.num_sv);
+    TEST_ASSERT_EQUAL_UINT8(fix.flags, decoded.flags);
+}
+
+void test_fix_rejection(void)
+{
+    struct ble_packet_fix fix;
+    struct ble_packet_fix decoded;
+    uint8_t frame[BLE_PACKET_FIX_FRAME_LENGTH];
+    uint16_t counter = 0;
+
+    test_fix(&fix);
+    ble_packet_fix_encode(&fix, frame);
+    for (counter = 0; counter < BLE_PACKET_FIX_FRAME_LENGTH; counter = counter + 1)
+    {
+        frame[counter] = frame[counter] ^ 0x01;
+        TEST_ASSERT_TRUE(ble_packet_fix_decode(frame, sizeof(frame), &decoded));
+        frame[counter] = frame[counter] ^ 0x01;
+    }
+    TEST_ASSERT_TRUE(ble_packet_fix_decode(frame, sizeof(frame) - 1, &decoded));
+    TEST_ASSERT_FALSE(ble_packet_fix_decode(frame, sizeof(frame), &decoded));
+}
+
+/**
+ * @brief Write data in pieces through a packetizer and check the notifications
+ * @param [in] mtu, length, piece
+ */
+static void test_split(uint16_t mtu, uint16_t length, uint16_t piece)
+{
+    struct ble_packetizer ble_packetizer_data;
+    uint8_t data[2048];
+    uint16_t position = 0;
+    uint16_t part = 0;
+    uint16_t counter = 0;
+
+    for (counter = 0; counter < length; counter = counter + 1) data[counter] = (uint8_t)(counter * 7 + 1);
+    setUp();
+    ble_packet_init(&ble_packetizer_data, mtu);
+    test_payload = ble_packetizer_data.payload;
+    for (position = 0; position < length; position = position + part)
+    {
+        part = length - position;
+        if (part > piece) part = piece;
+        ble_packet_write(&ble_packetizer_data, &data[position], part, test_send);
+    }
+    ble_packet_flush(&ble_packetizer_data, test_send);
+    TEST_ASSERT_EQUAL_UINT16(length, test_stream_length);
+    TEST_ASSERT_EQUAL_MEMORY(data, test_stream, length);
+    TEST_ASSERT_EQUAL_UINT16((length + test_payload - 1) / test_payload, test_notifications);
+    for (counter = 0; (counter + 1) < test_notifications; counter = counter + 1) TEST_ASSERT_EQUAL_UINT16(test_payload, test_sizes[counter]);
+}
+
+void test_mtu_payload(void)
+{
+    struct ble_packetizer ble_packetizer_data;
+
+    ble_packet_init(&ble_packetizer_data, 0);
+    TEST_ASSERT_EQUAL_UINT16(BLE_PACKET_MTU_DEFAULT - BLE_PACKET_ATT_HEADER, ble_packetizer_data.payload);
+    ble_packet_init(&ble_packetizer_data, 23);
+    TEST_ASSERT_EQUAL_UINT16(20, ble_packetizer_data.payload);
+    ble_packet_init(&ble_packetizer_data, 185);
+    TEST_ASSERT_EQUAL_UINT16(182, ble_packetizer_data.payload);
+    ble_packet_init(&ble_packetizer_data, 247);
+    TEST_ASSERT_EQUAL_UINT16(BLE_PACKET_PAYLOAD_MAX, ble_packetizer_data.payload);
+    ble_packet_init(&ble_packetizer_data, 517);
+    TEST_ASSERT_EQUAL_UINT16(BLE_PACKET_PAYLOAD_MAX, ble_packetizer_data.payload);
+}
+
+void test_mtu_boundary(void)
+{
+    const uint16_t mtus[] = {23, 185, 247, 517};
+    const uint16_t pieces[] = {1, 7, 19, 20, 21, 82, 244, 245, 2048};
+    uint16_t payload = 0;
+    uint8_t counter1 = 0;
+    uint8_t counter2 = 0;
+    int8_t counter3 = 0;
+
+    for (counter1 = 0; counter1 < (sizeof(mtus) / sizeof(mtus[0])); counter1 = counter1 + 1)
+    {
+        payload = mtus[counter1] - BLE_PACKET_ATT_HEADER;
+        if (payload > BLE_PACKET_PAYLOAD_MAX) payload = BLE_PACKET_PAYLOAD_MAX;
+        for (counter2 = 0; counter2 < (sizeof(pieces) / sizeof(pieces[0])); counter2 = counter2 + 1)
+        {
+            for (counter3 = -1; counter3 <= 1; counter3 = counter3 + 1)
+            {
+                test_split(mtus[counter1], payload + counter3, pieces[counter2]);
+                test_split(mtus[counter1], 2 * payload + counter3, pieces[counter2]);
+            }
+            test_split(mtus[counter1], 1500, pieces[counter2]);
+        }
+    }
+}
+
+void test_fix_notification(void)
+{
+    struct ble_packetizer ble_packetizer_data;
+    struct ble_packet_fix fix;
+    struct ble_packet_fix decoded;
+    uint8_t frame[BLE_PACKET_FIX_FRAME_LENGTH];
+
+    test_fix(&fix);
+    ble_packet_init(&ble_packetizer_data, 23);
+    test_payload = ble_packetizer_data.payload;
+    ble_packet_write(&ble_packetizer_data, frame, ble_packet_fix_encode(&fix, frame), test_send);
+    ble_packet_flush(&ble_packetizer_data, test_send);
+    TEST_ASSERT_EQUAL_UINT16(2, test_notifications);
+    TEST_ASSERT_FALSE(ble_packet_fix_decode(test_stream, test_stream_length, &decoded));
+    TEST_ASSERT_EQUAL_INT32(fix.lon, decoded.lon);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fix_round_trip);
+    RUN_TEST(test_fix_rejection);
+    RUN_TEST(test_mtu_payload);
+    RUN_TEST(test_mtu_boundary);
+    RUN_TEST(test_fix_notification);
+
+    return UNITY_END();
+}
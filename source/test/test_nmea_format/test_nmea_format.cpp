@@ -0,0 +1,176 @@
+/**
+ * @file test_nmea_format.cpp
+ *
+ * @brief NMEA format test implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unity.h>
+#include "nmea_format.h"
+#include "output_hub.h"
+
+struct nmea_epoch test_epoch;
+char test_buffer[1024];
+
+void setUp(void)
+{
+    memset(&test_epoch, 0, sizeof(test_epoch));
+    test_epoch.time_valid = true;
+    test_epoch.hour = 12;
+    test_epoch.minute = 34;
+    test_epoch.second = 56;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Format one sentence and check its checksum
+ * @param [in] sentence (OUTPUT_HUB_SENTENCE_x)
+ * @return sentence without checksum
+ */
+static const char *test_format(uint32_t sentence)
+{
+    uint16_t length = 0;
+    uint16_t counter = 0;
+    uint8_t checksum = 0;
+    unsigned int value = 0;
+
+    length = nmea_format(&test_epoch, sentence, NMEA_FORMAT_PRECISION_STANDARD, test_buffer, sizeof(test_buffer) - 1);
+    TEST_ASSERT_GREATER_THAN(5, length);
+    test_buffer[length] = '\0';
+    TEST_ASSERT_EQUAL_STRING("\r\n", &test_buffer[length - 2]);
+    for (counter = 1; (counter < length) && (test_buffer[counter] != '*'); counter = counter + 1) checksum = checksum ^ (uint8_t)test_buffer[counter];
+    TEST_ASSERT_EQUAL_UINT16(length - 5, counter);
+    TEST_ASSERT_EQUAL_INT(1, sscanf(&test_buffer[counter + 1], "%2X", &value));
+    TEST_ASSERT_EQUAL_UINT8(checksum, value);
+    test_buffer[counter] = '\0';
+
+    return test_buffer;
+}
+
+/**
+ * @brief Get a field of a sentence
+ * @param [in] sentence, index (0 is the address)
+ * @param [out] field
+ */
+static void test_field(const char *sentence, uint8_t index, char *field)
+{
+    while ((index > 0) && (*sentence != '\0'))
+    {
+        if (*sentence == ',') index = index - 1;
+        sentence = sentence + 1;
+    }
+    while ((*sentence != ',') && (*sentence != '\0'))
+    {
+        *field = *sentence;
+        field = field + 1;
+        sentence = sentence + 1;
+    }
+    *field = '\0';
+}
+
+void test_zda_date_valid(void)
+{
+    test_epoch.date_valid = true;
+    test_epoch.year = 2024;
+    test_epoch.month = 3;
+    test_epoch.day = 5;
+    TEST_ASSERT_EQUAL_STRING("$GNZDA,123456.00,05,03,2024,00,00", test_format(OUTPUT_HUB_SENTENCE_ZDA));
+}
+
+void test_zda_date_invalid(void)
+{
+    char field[32];
+
+    test_epoch.date_valid = false;
+    TEST_ASSERT_EQUAL_STRING("$GNZDA,123456.00,,,,00,00", test_format(OUTPUT_HUB_SENTENCE_ZDA));
+    test_field(test_buffer, 2, field);
+    TEST_ASSERT_EQUAL_STRING("", field);
+    test_field(test_buffer, 4, field);
+    TEST_ASSERT_EQUAL_STRING("", field);
+    test_field(test_buffer, 5, field);
+    TEST_ASSERT_EQUAL_STRING("00", field);
+}
+
+void test_mode_dead_reckoning(void)
+{
+    char field[32];
+
+    test_epoch.fix_type = 1;
+    test_epoch.fix_ok = false;
+    test_format(OUTPUT_HUB_SENTENCE_GGA);
+    test_field(test_buffer, 6, field);
+    TEST_ASSERT_EQUAL_STRING("6", field);
+    test_format(OUTPUT_HUB_SENTENCE_RMC);
+    test_field(test_buffer, 12, field);
+    TEST_ASSERT_EQUAL_STRING("E", field);
+}
+
+void test_mode_no_fix(void)
+{
+    char field[32];
+
+    test_epoch.fix_type = 0;
+    test_format(OUTPUT_HUB_SENTENCE_GGA);
+    test_field(test_buffer, 6, field);
+    TEST_ASSERT_EQUAL_STRING("0", field);
+    test_format(OUTPUT_HUB_SENTENCE_RMC);
+    test_field(test_buffer, 2, field);
+    TEST_ASSERT_EQUAL_STRING("V", field);
+    test_field(test_buffer, 12, field);
+    TEST_ASSERT_EQUAL_STRING("N", field);
+}
+
+void test_mode_fix(void)
+{
+    char field[32];
+
+    test_epoch.fix_type = 3;
+    test_epoch.fix_ok = true;
+    test_epoch.carr_soln = 2;
+    test_format(OUTPUT_HUB_SENTENCE_GGA);
+    test_field(test_buffer, 6, field);
+    TEST_ASSERT_EQUAL_STRING("4", field);
+    test_format(OUTPUT_HUB_SENTENCE_RMC);
+    test_field(test_buffer, 12, field);
+    TEST_ASSERT_EQUAL_STRING("R", field);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_zda_date_valid);
+    RUN_TEST(test_zda_date_invalid);
+    RUN_TEST(test_mode_dead_reckoning);
+    RUN_TEST(test_mode_no_fix);
+    RUN_TEST(test_mode_fix);
+
+    return UNITY_END();
+}
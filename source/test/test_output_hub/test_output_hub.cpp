@@ -0,0 +1,404 @@
+/**
+ * @file test_output_hub.cpp
+ *
+ * @brief Output hub test implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unity.h>
+#include "output_hub.h"
+
+/*
+ * Simulated sinks on the output hub: a fast, a chunked, a filtered, a
+ * decimated and a slow sink. Every epoch carries its sequence number as time
+ * stamp and in every sentence, so a sink can check that no sentence is torn
+ * (checksum), mixed from another epoch or delivered out of order. The slow
+ * sink blocks between reading and releasing a run like a blocking write, so
+ * the producer laps it while the run is in use.
+ */
+
+#define TEST_HUB_SIZE 4096
+#define TEST_EPOCHS 10000
+#define TEST_PERIOD 50
+#define TEST_SINKS 5
+
+uint8_t test_buffer[TEST_HUB_SIZE];
+struct output_hub test_hub;
+
+struct test_sink
+{
+    struct output_hub_sink sink;
+    uint32_t chunk;
+    uint32_t pause;
+    uint32_t step;
+    std::string assembly;
+    uint32_t sentences;
+    uint32_t epochs;
+    uint32_t last_epoch;
+    bool first;
+    uint32_t drops;
+    uint32_t torn;
+    uint32_t errors;
+};
+
+void setUp(void)
+{
+    output_hub_init(&test_hub, test_buffer, sizeof(test_buffer));
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Build a NMEA sentence with checksum
+ * @param [in] type, sequence
+ * @param [out] sentence
+ * @return length
+ */
+static uint32_t test_sentence(const char *type, uint32_t sequence, char *sentence)
+{
+    uint8_t checksum = 0;
+    uint32_t length = 0;
+    uint32_t counter = 0;
+
+    length = sprintf(sentence, "$GN%s,%08u,1,2,3", type, sequence);
+    for (counter = 1; counter < length; counter = counter + 1) checksum = checksum ^ (uint8_t)sentence[counter];
+    length = length + sprintf(&sentence[length], "*%02X\r\n", checksum);
+
+    return length;
+}
+
+/**
+ * @brief Build an epoch of GGA, GSV and RMC sentences
+ * @param [in] sequence
+ * @param [out] epoch
+ * @return length
+ */
+static uint32_t test_epoch(uint32_t sequence, uint8_t *epoch)
+{
+    uint32_t length = 0;
+
+    length = length + test_sentence("GGA", sequence, (char *)&epoch[length]);
+    length = length + test_sentence("GSV", sequence, (char *)&epoch[length]);
+    length = length + test_sentence("RMC", sequence, (char *)&epoch[length]);
+
+    return length;
+}
+
+/**
+ * @brief Check a received sentence
+ * @param [in] sentence, length, timestamp
+ * @return error
+ */
+static bool test_check(const char *sentence, uint32_t length, uint32_t timestamp)
+{
+    uint8_t checksum = 0;
+    uint32_t counter = 0;
+    unsigned int value = 0;
+    unsigned int sequence = 0;
+
+    if ((length < 12) || (sentence[0] != '$') || (sentence[length - 2] != '\r') || (sentence[length - 1] != '\n')) return true;
+    for (counter = 1; (counter < length) && (sentence[counter] != '*'); counter = counter + 1) checksum = checksum ^ (uint8_t)sentence[counter];
+    if ((counter + 5) != length) return true;
+    if (sscanf(&sentence[counter + 1], "%2X", &value) != 1) return true;
+    if (value != checksum) return true;
+    if (sscanf(&sentence[7], "%8u", &sequence) != 1) return true;
+
+    return (sequence != timestamp);
+}
+
+/**
+ * @brief Read all pending runs of a simulated sink
+ * @param [in,out] test_sink_data
+ * @return true if something was read
+ */
+static bool test_read(struct test_sink *test_sink_data)
+{
+    const uint8_t *data = nullptr;
+    bool end = false;
+    uint32_t timestamp = 0;
+    uint32_t length = 0;
+    uint32_t drops = 0;
+    char copy[256];
+    bool read = false;
+    size_t position = 0;
+
+    while (1)
+    {
+        drops = test_sink_data->sink.drops;
+        length = output_hub_peek(&test_hub, &test_sink_data->sink, &data, &end, &timestamp);
+        if (length == 0) break;
+        read = true;
+        if (test_sink_data->sink.drops != drops) test_sink_data->assembly.clear();
+        if (length > test_sink_data->chunk) length = test_sink_data->chunk;
+        if (length > sizeof(copy)) length = sizeof(copy);
+        memcpy(copy, data, length);
+        if (test_sink_data->pause != 0) std::this_thread::sleep_for(std::chrono::microseconds(test_sink_data->pause));
+        if (output_hub_consume(&test_hub, &test_sink_data->sink, length) == true)
+        {
+            test_sink_data->torn = test_sink_data->torn + 1;
+            test_sink_data->assembly.clear();
+            continue;
+        }
+        if ((test_sink_data->assembly.empty() == true) && (test_sink_data->sink.offset == length))
+        {
+            if ((test_sink_data->first == false) && (timestamp <= test_sink_data->last_epoch)) test_sink_data->errors = test_sink_data->errors + 1;
+            if ((test_sink_data->first == false) && (test_sink_data->sink.drops == test_sink_data->drops) && ((timestamp - test_sink_data->last_epoch) != test_sink_data->step)) test_sink_data->errors = test_sink_data->errors + 1;
+            test_sink_data->first = false;
+            test_sink_data->last_epoch = timestamp;
+            test_sink_data->drops = test_sink_data->sink.drops;
+            test_sink_data->epochs = test_sink_data->epochs + 1;
+        }
+        if ((timestamp != test_sink_data->last_epoch) && (test_sink_data->first == false) && (timestamp < test_sink_data->last_epoch)) test_sink_data->errors = test_sink_data->errors + 1;
+        test_sink_data->assembly.append(copy, length);
+        while ((position = test_sink_data->assembly.find('\n')) != std::string::npos)
+        {
+            if (test_check(test_sink_data->assembly.data(), position + 1, timestamp) == true) test_sink_data->errors = test_sink_data->errors + 1;
+            test_sink_data->sentences = test_sink_data->sentences + 1;
+            test_sink_data->assembly.erase(0, position + 1);
+        }
+    }
+
+    return read;
+}
+
+/**
+ * @brief Initialize a simulated sink
+ * @param [out] test_sink_data
+ * @param [in] filter, decimation, chunk, pause
+ */
+static void test_sink_init(struct test_sink *test_sink_data, uint32_t filter, uint8_t decimation, uint32_t chunk, uint32_t pause)
+{
+    output_hub_sink_init(&test_hub, &test_sink_data->sink, filter, OUTPUT_HUB_VARIANT_ALL, decimation);
+    test_sink_data->chunk = chunk;
+    test_sink_data->pause = pause;
+    test_sink_data->step = (decimation == 0) ? 1 : decimation;
+    test_sink_data->assembly.clear();
+    test_sink_data->sentences = 0;
+    test_sink_data->epochs = 0;
+    test_sink_data->last_epoch = 0;
+    test_sink_data->first = true;
+    test_sink_data->drops = 0;
+    test_sink_data->torn = 0;
+    test_sink_data->errors = 0;
+}
+
+/**
+ * @brief Publish epochs with the sequence number as time stamp
+ * @param [in] first, count
+ */
+static void test_publish(uint32_t first, uint32_t count)
+{
+    uint8_t epoch[256];
+    uint32_t length = 0;
+    uint32_t counter = 0;
+
+    for (counter = first; counter < (first + count); counter = counter + 1)
+    {
+        length = test_epoch(counter, epoch);
+        TEST_ASSERT_FALSE(output_hub_publish(&test_hub, epoch, length, counter, OUTPUT_HUB_VARIANT_ALL));
+    }
+}
+
+void test_fast_sink(void)
+{
+    struct test_sink test_sink_data;
+    uint32_t counter = 0;
+
+    test_sink_init(&test_sink_data, OUTPUT_HUB_SENTENCE_ALL, 1, 0xFFFFFFFF, 0);
+    for (counter = 1; counter < 1000; counter = counter + 1)
+    {
+        test_publish(counter, 1);
+        TEST_ASSERT_TRUE(test_read(&test_sink_data));
+    }
+    TEST_ASSERT_EQUAL_UINT32(999, test_sink_data.epochs);
+    TEST_ASSERT_EQUAL_UINT32(999 * 3, test_sink_data.sentences);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.sink.drops);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+}
+
+void test_chunked_sink(void)
+{
+    struct test_sink test_sink_data;
+
+    test_sink_init(&test_sink_data, OUTPUT_HUB_SENTENCE_ALL, 1, 7, 0);
+    test_publish(1, 20);
+    test_read(&test_sink_data);
+    TEST_ASSERT_EQUAL_UINT32(20 * 3, test_sink_data.sentences);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.assembly.size());
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.sink.drops);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+}
+
+void test_filtered_sink(void)
+{
+    struct test_sink test_sink_data;
+    const uint8_t *data = nullptr;
+    bool end = false;
+    uint32_t timestamp = 0;
+    uint32_t length = 0;
+
+    test_sink_init(&test_sink_data, output_hub_filter("GGA,RMC"), 1, 0xFFFFFFFF, 0);
+    test_publish(1, 1);
+    length = output_hub_peek(&test_hub, &test_sink_data.sink, &data, &end, &timestamp);
+    TEST_ASSERT_EQUAL_STRING_LEN("$GNGGA", (const char *)data, 6);
+    TEST_ASSERT_FALSE(end);
+    TEST_ASSERT_FALSE(output_hub_consume(&test_hub, &test_sink_data.sink, length));
+    length = output_hub_peek(&test_hub, &test_sink_data.sink, &data, &end, &timestamp);
+    TEST_ASSERT_EQUAL_STRING_LEN("$GNRMC", (const char *)data, 6);
+    TEST_ASSERT_TRUE(end);
+    TEST_ASSERT_FALSE(output_hub_consume(&test_hub, &test_sink_data.sink, length));
+    TEST_ASSERT_EQUAL_UINT32(0, output_hub_peek(&test_hub, &test_sink_data.sink, &data, &end, &timestamp));
+
+    test_sink_init(&test_sink_data, output_hub_filter("GGA,RMC"), 1, 0xFFFFFFFF, 0);
+    test_publish(2, 20);
+    test_read(&test_sink_data);
+    TEST_ASSERT_EQUAL_UINT32(20 * 2, test_sink_data.sentences);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+}
+
+void test_decimated_sink(void)
+{
+    struct test_sink test_sink_data;
+
+    test_sink_init(&test_sink_data, OUTPUT_HUB_SENTENCE_ALL, 3, 0xFFFFFFFF, 0);
+    test_publish(1, 30);
+    test_read(&test_sink_data);
+    TEST_ASSERT_EQUAL_UINT32(10, test_sink_data.epochs);
+    TEST_ASSERT_EQUAL_UINT32(28, test_sink_data.last_epoch);
+    TEST_ASSERT_EQUAL_UINT32(10, test_sink_data.sink.epochs);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+}
+
+void test_slow_sink(void)
+{
+    struct test_sink test_sink_data;
+    struct test_sink fast_sink_data;
+
+    test_sink_init(&test_sink_data, OUTPUT_HUB_SENTENCE_ALL, 1, 0xFFFFFFFF, 0);
+    test_sink_init(&fast_sink_data, OUTPUT_HUB_SENTENCE_ALL, 1, 0xFFFFFFFF, 0);
+    test_publish(1, 1000);
+    test_read(&fast_sink_data);
+    test_read(&test_sink_data);
+    TEST_ASSERT_GREATER_THAN(0, test_sink_data.sink.drops);
+    TEST_ASSERT_EQUAL_UINT32(1000, test_sink_data.last_epoch);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+    test_publish(1001, 5);
+    test_read(&test_sink_data);
+    TEST_ASSERT_EQUAL_UINT32(1005, test_sink_data.last_epoch);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+}
+
+void test_torn_header(void)
+{
+    struct test_sink test_sink_data;
+    uint32_t garbage = 0xFFFFFFFE;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    uint32_t sequence = 0;
+
+    test_sink_init(&test_sink_data, OUTPUT_HUB_SENTENCE_ALL, 1, 0xFFFFFFFF, 0);
+    test_publish(1, 2);
+    offset = test_sink_data.sink.tail & (TEST_HUB_SIZE - 1);
+    memcpy(&test_buffer[offset], &garbage, sizeof(garbage));
+    test_read(&test_sink_data);
+    TEST_ASSERT_EQUAL_UINT32(1, test_sink_data.sink.drops);
+    TEST_ASSERT_EQUAL_UINT32(2, test_sink_data.last_epoch);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+
+    length = test_hub.head - test_hub.last;
+    for (sequence = 3; (test_hub.head - test_sink_data.sink.tail + length) <= TEST_HUB_SIZE; sequence = sequence + 1) test_publish(sequence, 1);
+    __atomic_store_n(&test_hub.reserve, test_hub.head + length, __ATOMIC_RELEASE);
+    test_read(&test_sink_data);
+    TEST_ASSERT_EQUAL_UINT32(2, test_sink_data.sink.drops);
+    TEST_ASSERT_EQUAL_UINT32(sequence - 1, test_sink_data.last_epoch);
+    TEST_ASSERT_EQUAL_UINT32(0, test_sink_data.errors);
+}
+
+void test_load(void)
+{
+    struct test_sink test_sink_data[TEST_SINKS];
+    std::thread consumers[TEST_SINKS];
+    std::atomic<bool> done(false);
+    uint32_t sequence = 0;
+    uint8_t counter = 0;
+
+    test_sink_init(&test_sink_data[0], OUTPUT_HUB_SENTENCE_ALL, 1, 0xFFFFFFFF, 0);
+    test_sink_init(&test_sink_data[1], OUTPUT_HUB_SENTENCE_ALL, 1, 5, 0);
+    test_sink_init(&test_sink_data[2], output_hub_filter("GGA"), 1, 0xFFFFFFFF, 0);
+    test_sink_init(&test_sink_data[3], OUTPUT_HUB_SENTENCE_ALL, 3, 0xFFFFFFFF, 0);
+    test_sink_init(&test_sink_data[4], OUTPUT_HUB_SENTENCE_ALL, 1, 0xFFFFFFFF, 20000);
+    for (counter = 0; counter < TEST_SINKS; counter = counter + 1)
+    {
+        consumers[counter] = std::thread([&test_sink_data, &done, counter]()
+        {
+            bool finished = false;
+
+            while (finished == false)
+            {
+                finished = done.load();
+                test_read(&test_sink_data[counter]);
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (sequence = 1; sequence <= TEST_EPOCHS; sequence = sequence + 1)
+    {
+        test_publish(sequence, 1);
+        std::this_thread::sleep_for(std::chrono::microseconds(TEST_PERIOD));
+    }
+    done.store(true);
+    for (counter = 0; counter < TEST_SINKS; counter = counter + 1) consumers[counter].join();
+
+    for (counter = 0; counter < TEST_SINKS; counter = counter + 1)
+    {
+        printf("sink %u: epochs %u sentences %u drops %u torn %u errors %u\n", counter, test_sink_data[counter].epochs, test_sink_data[counter].sentences, test_sink_data[counter].sink.drops, test_sink_data[counter].torn, test_sink_data[counter].errors);
+        TEST_ASSERT_EQUAL_UINT32(0, test_sink_data[counter].errors);
+        TEST_ASSERT_GREATER_THAN(0, test_sink_data[counter].sentences);
+    }
+    TEST_ASSERT_GREATER_THAN(0, test_sink_data[4].sink.drops);
+    TEST_ASSERT_EQUAL_UINT32(TEST_EPOCHS, test_hub.epochs);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fast_sink);
+    RUN_TEST(test_chunked_sink);
+    RUN_TEST(test_filtered_sink);
+    RUN_TEST(test_decimated_sink);
+    RUN_TEST(test_slow_sink);
+    RUN_TEST(test_torn_header);
+    RUN_TEST(test_load);
+
+    return UNITY_END();
+}
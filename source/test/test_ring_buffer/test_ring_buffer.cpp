@@ -0,0 +1,180 @@
+/**
+ * @file test_ring_buffer.cpp
+ *
+ * @brief Ring buffer test implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unity.h>
+#include "ring_buffer.h"
+
+/*
+ * The NTRIP caster writes every RTCM frame into one ring buffer per client
+ * and every client sends from its own buffer as far as its socket allows.
+ * The tests check that a frame is written whole or not at all and that a
+ * stalled client only drops its own frames.
+ */
+
+#define TEST_SIZE 4096
+#define TEST_CLIENTS 3
+
+uint8_t test_buffer[TEST_CLIENTS][TEST_SIZE];
+struct ring_buffer test_ring_buffer[TEST_CLIENTS];
+
+void setUp(void)
+{
+    uint8_t counter = 0;
+
+    for (counter = 0; counter < TEST_CLIENTS; counter = counter + 1) ring_buffer_init(&test_ring_buffer[counter], test_buffer[counter], TEST_SIZE);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Build a frame (sequence, length, payload derived from the sequence)
+ * @param [in] sequence
+ * @param [out] frame
+ * @return length
+ */
+static uint32_t test_frame(uint32_t sequence, uint8_t *frame)
+{
+    uint32_t length = 8 + (sequence * 7) % 200;
+    uint32_t counter = 0;
+
+    memcpy(&frame[0], &sequence, sizeof(sequence));
+    memcpy(&frame[4], &length, sizeof(length));
+    for (counter = 8; counter < length; counter = counter + 1) frame[counter] = (uint8_t)(sequence + counter);
+
+    return length;
+}
+
+/**
+ * @brief Read the frames of a client and check that they are whole and in order
+ * @param [in] ring_buffer_data
+ * @param [in,out] sequence (of the last frame)
+ * @return frames
+ */
+static uint32_t test_drain(struct ring_buffer *ring_buffer_data, uint32_t *sequence)
+{
+    uint8_t frame[512];
+    uint8_t expected[512];
+    uint32_t length = 0;
+    uint32_t next = 0;
+    uint32_t frames = 0;
+
+    while (ring_buffer_used(ring_buffer_data) > 0)
+    {
+        TEST_ASSERT_EQUAL_UINT32(8, ring_buffer_read(ring_buffer_data, frame, 8));
+        memcpy(&length, &frame[4], sizeof(length));
+        TEST_ASSERT_EQUAL_UINT32(length - 8, ring_buffer_read(ring_buffer_data, &frame[8], length - 8));
+        memcpy(&next, &frame[0], sizeof(next));
+        TEST_ASSERT_GREATER_THAN(*sequence, next);
+        *sequence = next;
+        TEST_ASSERT_EQUAL_UINT32(length, test_frame(next, expected));
+        TEST_ASSERT_EQUAL_MEMORY(expected, frame, length);
+        frames = frames + 1;
+    }
+
+    return frames;
+}
+
+void test_write_all_or_nothing(void)
+{
+    uint8_t data[TEST_SIZE];
+    const uint8_t *block = nullptr;
+
+    memset(data, 0x55, sizeof(data));
+    TEST_ASSERT_TRUE(ring_buffer_write(&test_ring_buffer[0], data, TEST_SIZE - 10));
+    TEST_ASSERT_FALSE(ring_buffer_write(&test_ring_buffer[0], data, 11));
+    TEST_ASSERT_EQUAL_UINT32(1, test_ring_buffer[0].drops);
+    TEST_ASSERT_EQUAL_UINT32(TEST_SIZE - 10, ring_buffer_used(&test_ring_buffer[0]));
+    TEST_ASSERT_TRUE(ring_buffer_write(&test_ring_buffer[0], data, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buffer_free(&test_ring_buffer[0]));
+    TEST_ASSERT_EQUAL_UINT32(TEST_SIZE, ring_buffer_peek(&test_ring_buffer[0], &block));
+}
+
+void test_wrap_around(void)
+{
+    uint8_t data[300];
+    uint8_t read[300];
+    const uint8_t *block = nullptr;
+    uint32_t counter = 0;
+
+    for (counter = 0; counter < sizeof(data); counter = counter + 1) data[counter] = (uint8_t)counter;
+    TEST_ASSERT_TRUE(ring_buffer_write(&test_ring_buffer[0], data, 200));
+    ring_buffer_consume(&test_ring_buffer[0], 200);
+    for (counter = 0; counter < 12; counter = counter + 1)
+    {
+        TEST_ASSERT_TRUE(ring_buffer_write(&test_ring_buffer[0], data, sizeof(data)));
+        TEST_ASSERT_EQUAL_UINT32(sizeof(data), ring_buffer_read(&test_ring_buffer[0], read, sizeof(read)));
+        TEST_ASSERT_EQUAL_MEMORY(data, read, sizeof(data));
+    }
+    TEST_ASSERT_TRUE(ring_buffer_write(&test_ring_buffer[0], data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(TEST_SIZE - (test_ring_buffer[0].tail & (TEST_SIZE - 1)), ring_buffer_peek(&test_ring_buffer[0], &block));
+    TEST_ASSERT_EQUAL_MEMORY(data, block, TEST_SIZE - (test_ring_buffer[0].tail & (TEST_SIZE - 1)));
+    ring_buffer_clear(&test_ring_buffer[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, ring_buffer_used(&test_ring_buffer[0]));
+}
+
+void test_stalled_client(void)
+{
+    uint8_t frame[512];
+    uint32_t length = 0;
+    uint32_t sequence = 0;
+    uint32_t last[TEST_CLIENTS] = {0};
+    uint32_t frames[TEST_CLIENTS] = {0};
+    uint8_t counter = 0;
+
+    for (sequence = 1; sequence <= 1000; sequence = sequence + 1)
+    {
+        length = test_frame(sequence, frame);
+        for (counter = 0; counter < TEST_CLIENTS; counter = counter + 1) ring_buffer_write(&test_ring_buffer[counter], frame, length);
+        frames[0] = frames[0] + test_drain(&test_ring_buffer[0], &last[0]);
+        if ((sequence % 20) == 0) frames[1] = frames[1] + test_drain(&test_ring_buffer[1], &last[1]);
+    }
+    for (counter = 0; counter < TEST_CLIENTS; counter = counter + 1) frames[counter] = frames[counter] + test_drain(&test_ring_buffer[counter], &last[counter]);
+
+    TEST_ASSERT_EQUAL_UINT32(1000, frames[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, test_ring_buffer[0].drops);
+    TEST_ASSERT_EQUAL_UINT32(1000, frames[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, test_ring_buffer[1].drops);
+    TEST_ASSERT_GREATER_THAN(0, test_ring_buffer[2].drops);
+    TEST_ASSERT_EQUAL_UINT32(1000, frames[2] + test_ring_buffer[2].drops);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_write_all_or_nothing);
+    RUN_TEST(test_wrap_around);
+    RUN_TEST(test_stalled_client);
+
+    return UNITY_END();
+}
@@ -0,0 +1,353 @@
+/**
+ * @file test_rtcm.cpp
+ *
+ * @brief RTCM ingest test implementation.
+ *
+ (c) 2023 Forstner Michael and its subsidiaries.
+
+     Subject to your compliance with these terms,you may use this software and
+     any derivatives exclusively with Forstner Michael products.It is your responsibility
+     to comply with third party license terms applicable to your use of third party
+     software (including open source software) that may accompany Forstner Michael software.
+
+     THIS SOFTWARE IS SUPPLIED BY Forstner Michael "AS IS". NO WARRANTIES, WHETHER
+     EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+     WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+     PARTICULAR PURPOSE.
+
+     IN NO EVENT WILL Forstner Michael BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+     INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+     WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF Forstner Michael HAS
+     BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+     FULLEST EXTENT ALLOWED BY LAW, Forstner Michael'S TOTAL LIABILITY ON ALL CLAIMS IN
+     ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+     THAT YOU HAVE PAID DIRECTLY TO Forstner Michael FOR THIS SOFTWARE.
+ *
+ */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <unity.h>
+#include "rtcm.h"
+
+/*
+ * Host harness of the RTCM ingest path. A stream is replayed like
+ * rtcm_replay (rtcm_parse, rtcm_pacer_delay on a simulated clock, batches of
+ * up to 2048 bytes) into the equivalent of correction_push (rtcm_parse per
+ * source, frames batched into the 2048 byte buffer that goes to the caster
+ * and the GNSS). The harness reports the ingest latency from the last byte of
+ * a frame to its hand over to the GNSS and the ingest throughput of the host.
+ * By default the stream is a generated 4 constellation MSM7 stream at 1 Hz,
+ * RTCM_FILE=<file> replays a recorded file instead.
+ */
+
+#define TEST_EPOCHS 600
+#define TEST_BUFFER 2048
+
+struct test_ingest
+{
+    struct rtcm_parser rtcm_parser_data;
+    uint8_t buffer[TEST_BUFFER];
+    uint16_t buffer_length;
+    std::chrono::steady_clock::time_point complete[TEST_BUFFER / 6];
+    uint16_t pending;
+    uint32_t frames;
+    uint32_t pushes;
+    uint64_t bytes;
+    std::vector<uint32_t> latency;
+};
+
+struct test_ingest test_ingest_data;
+std::vector<uint8_t> test_stream;
+
+void setUp(void)
+{
+    rtcm_parser_init(&test_ingest_data.rtcm_parser_data);
+    test_ingest_data.buffer_length = 0;
+    test_ingest_data.pending = 0;
+    test_ingest_data.frames = 0;
+    test_ingest_data.pushes = 0;
+    test_ingest_data.bytes = 0;
+    test_ingest_data.latency.clear();
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Append a RTCM frame with valid CRC to the stream
+ * @param [in] type, epoch, length (payload)
+ */
+static void test_frame(uint16_t type, uint32_t epoch, uint16_t length)
+{
+    uint8_t frame[RTCM_FRAME_LENGTH_MAX];
+    uint16_t counter = 0;
+    uint32_t crc = 0;
+
+    frame[0] = RTCM_PREAMBLE;
+    frame[1] = (uint8_t)((length >> 8) & 0x03);
+    frame[2] = (uint8_t)length;
+    for (counter = 3; counter < (length + 3); counter = counter + 1) frame[counter] = (uint8_t)(counter * 31 + epoch);
+    frame[3] = (uint8_t)(type >> 4);
+    frame[4] = (uint8_t)((type << 4) | 0x00);
+    frame[5] = 0x01;
+    frame[6] = (uint8_t)(epoch >> 22);
+    frame[7] = (uint8_t)(epoch >> 14);
+    frame[8] = (uint8_t)(epoch >> 6);
+    frame[9] = (uint8_t)((epoch << 2) | (frame[9] & 0x03));
+    crc = rtcm_crc24q(frame, length + 3);
+    frame[length + 3] = (uint8_t)(crc >> 16);
+    frame[length + 4] = (uint8_t)(crc >> 8);
+    frame[length + 5] = (uint8_t)crc;
+    test_stream.insert(test_stream.end(), frame, &frame[length + 6]);
+}
+
+/**
+ * @brief Generate a base station stream (1005, MSM7 of GPS, GLONASS, Galileo, BeiDou)
+ * @param [in] first (GPS time of week in ms), epochs
+ */
+static void test_generate(uint32_t first, uint32_t epochs)
+{
+    uint32_t counter = 0;
+    uint32_t epoch = 0;
+
+    test_stream.clear();
+    for (counter = 0; counter < epochs; counter = counter + 1)
+    {
+        epoch = (first + counter * 1000) % 604800000;
+        if ((counter % 10) == 0) test_frame(1005, 0, 19);
+        test_frame(1077, epoch, 420);
+        test_frame(1087, ((epoch / 86400000) << 27) | ((epoch + 10800000 - 18000) % 86400000), 340);
+        test_frame(1097, epoch, 380);
+        test_frame(1127, (epoch + 604800000 - 14000) % 604800000, 400);
+    }
+}
+
+/**
+ * @brief Hand the batch over to the GNSS and take the latency of its frames
+ * @param [in,out] test_ingest_data
+ */
+static void test_flush(struct test_ingest *test_ingest_data)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    uint16_t counter = 0;
+
+    if (test_ingest_data->buffer_length == 0) return;
+    for (counter = 0; counter < test_ingest_data->pending; counter = counter + 1) test_ingest_data->latency.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - test_ingest_data->complete[counter]).count());
+    test_ingest_data->pushes = test_ingest_data->pushes + 1;
+    test_ingest_data->buffer_length = 0;
+    test_ingest_data->pending = 0;
+}
+
+/**
+ * @brief Equivalent of correction_push: frame the data and batch the frames for the GNSS
+ * @param [in,out] test_ingest_data
+ * @param [in] data, length
+ */
+static void test_push(struct test_ingest *test_ingest_data, const uint8_t *data, uint16_t length)
+{
+    uint16_t counter = 0;
+
+    for (counter = 0; counter < length; counter = counter + 1)
+    {
+        if (rtcm_parse(&test_ingest_data->rtcm_parser_data, data[counter]) == true)
+        {
+            if ((test_ingest_data->buffer_length + test_ingest_data->rtcm_parser_data.frame_length) > sizeof(test_ingest_data->buffer)) test_flush(test_ingest_data);
+            memcpy(&test_ingest_data->buffer[test_ingest_data->buffer_length], test_ingest_data->rtcm_parser_data.frame, test_ingest_data->rtcm_parser_data.frame_length);
+            test_ingest_data->buffer_length = test_ingest_data->buffer_length + test_ingest_data->rtcm_parser_data.frame_length;
+            test_ingest_data->complete[test_ingest_data->pending] = std::chrono::steady_clock::now();
+            test_ingest_data->pending = test_ingest_data->pending + 1;
+            test_ingest_data->frames = test_ingest_data->frames + 1;
+        }
+    }
+    test_flush(test_ingest_data);
+    test_ingest_data->bytes = test_ingest_data->bytes + length;
+}
+
+/**
+ * @brief Replay the stream like rtcm_replay on a simulated clock
+ * @param [in] paced (false: as fast as possible)
+ * @param [out] duration (simulated ms)
+ * @return frames read from the stream
+ */
+static uint32_t test_replay(bool paced, uint32_t *duration)
+{
+    struct rtcm_parser rtcm_parser_data;
+    struct rtcm_pacer rtcm_pacer_data;
+    uint8_t data[TEST_BUFFER];
+    uint16_t length = 0;
+    uint32_t clock = 1000;
+    uint32_t delay = 0;
+    uint32_t frames = 0;
+    size_t position = 0;
+    bool pending = false;
+
+    rtcm_parser_init(&rtcm_parser_data);
+    rtcm_pacer_init(&rtcm_pacer_data);
+    while ((position < test_stream.size()) || (pending == true))
+    {
+        length = 0;
+        while (1)
+        {
+            if (pending == true)
+            {
+                delay = (paced == true) ? rtcm_pacer_delay(&rtcm_pacer_data, rtcm_parser_data.frame, clock) : 0;
+                if (delay > 0) break;
+                if ((length + rtcm_parser_data.frame_length) > sizeof(data)) break;
+                memcpy(&data[length], rtcm_parser_data.frame, rtcm_parser_data.frame_length);
+                length = length + rtcm_parser_data.frame_length;
+                pending = false;
+                frames = frames + 1;
+            }
+            if (position >= test_stream.size()) break;
+            while ((position < test_stream.size()) && (pending == false))
+            {
+                pending = rtcm_parse(&rtcm_parser_data, test_stream[position]);
+                position = position + 1;
+            }
+        }
+        if (length > 0) test_push(&test_ingest_data, data, length);
+        if (delay > 0) clock = clock + delay;
+    }
+    *duration = clock - 1000;
+
+    return frames;
+}
+
+/**
+ * @brief Print the ingest figures
+ * @param [in] name, nanoseconds (host time of the ingest)
+ */
+static void test_report(const char *name, uint64_t nanoseconds)
+{
+    std::vector<uint32_t> latency = test_ingest_data.latency;
+    size_t count = latency.size();
+
+    std::sort(latency.begin(), latency.end());
+    printf("%s: %u frames, %llu bytes, %u pushes, %.1f MB/s, latency p50 %u ns p99 %u ns max %u ns\n", name, test_ingest_data.frames, (unsigned long long)test_ingest_data.bytes, test_ingest_data.pushes,
+        (nanoseconds > 0) ? (double)test_ingest_data.bytes * 1000.0 / (double)nanoseconds : 0.0,
+        (count > 0) ? latency[count / 2] : 0, (count > 0) ? latency[(count * 99) / 100] : 0, (count > 0) ? latency[count - 1] : 0);
+}
+
+void test_crc(void)
+{
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+    TEST_ASSERT_EQUAL_UINT32(0xCDE703, rtcm_crc24q(data, sizeof(data)));
+}
+
+void test_parse_errors(void)
+{
+    size_t position = 0;
+    uint32_t frames = 0;
+
+    test_generate(100000, 3);
+    test_stream[10] = test_stream[10] ^ 0x55;
+    test_stream.insert(test_stream.begin() + 500, RTCM_PREAMBLE);
+    for (position = 0; position < test_stream.size(); position = position + 1)
+    {
+        if (rtcm_parse(&test_ingest_data.rtcm_parser_data, test_stream[position]) == true) frames = frames + 1;
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, test_ingest_data.rtcm_parser_data.errors);
+    TEST_ASSERT_EQUAL_UINT32(1 + 3 * 4 - 2, frames);
+}
+
+void test_false_preamble(void)
+{
+    const uint8_t header[] = {RTCM_PREAMBLE, 0x00, 0x40};
+    size_t position = 0;
+    uint32_t frames = 0;
+    uint16_t types[5];
+
+    test_generate(100000, 1);
+    test_stream.insert(test_stream.begin(), header, &header[sizeof(header)]);
+    for (position = 0; position < test_stream.size(); position = position + 1)
+    {
+        if (rtcm_parse(&test_ingest_data.rtcm_parser_data, test_stream[position]) == true)
+        {
+            if (frames < 5) types[frames] = rtcm_message_type(test_ingest_data.rtcm_parser_data.frame);
+            frames = frames + 1;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, test_ingest_data.rtcm_parser_data.errors);
+    TEST_ASSERT_EQUAL_UINT32(5, frames);
+    TEST_ASSERT_EQUAL_UINT16(1005, types[0]);
+    TEST_ASSERT_EQUAL_UINT16(1077, types[1]);
+    TEST_ASSERT_EQUAL_UINT16(1127, types[4]);
+}
+
+void test_pacer(void)
+{
+    struct rtcm_pacer rtcm_pacer_data;
+    uint32_t duration = 0;
+
+    test_generate(604800000 - 30000, 60);
+    TEST_ASSERT_EQUAL_UINT32(6 + 60 * 4, test_replay(true, &duration));
+    TEST_ASSERT_EQUAL_UINT32(59000, duration);
+    TEST_ASSERT_EQUAL_UINT32(6 + 60 * 4, test_ingest_data.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, test_ingest_data.rtcm_parser_data.errors);
+
+    rtcm_pacer_init(&rtcm_pacer_data);
+    test_generate(200000, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, rtcm_pacer_delay(&rtcm_pacer_data, &test_stream[25], 0));
+    test_generate(200000 + RTCM_PACER_RESYNC + 1000, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, rtcm_pacer_delay(&rtcm_pacer_data, &test_stream[25], 5));
+    test_generate(200000 + RTCM_PACER_RESYNC + 2000, 1);
+    TEST_ASSERT_EQUAL_UINT32(990, rtcm_pacer_delay(&rtcm_pacer_data, &test_stream[25], 15));
+    TEST_ASSERT_EQUAL_UINT32(0, rtcm_pacer_delay(&rtcm_pacer_data, &test_stream[25], 1005));
+}
+
+void test_ingest(void)
+{
+    std::chrono::steady_clock::time_point start;
+    uint64_t nanoseconds = 0;
+    uint32_t duration = 0;
+    uint32_t frames = 0;
+    const char *file = getenv("RTCM_FILE");
+    FILE *stream = nullptr;
+    uint8_t data[4096];
+    size_t length = 0;
+
+    if (file != nullptr)
+    {
+        stream = fopen(file, "rb");
+        TEST_ASSERT_NOT_NULL(stream);
+        test_stream.clear();
+        while ((length = fread(data, 1, sizeof(data), stream)) > 0) test_stream.insert(test_stream.end(), data, &data[length]);
+        fclose(stream);
+    }
+    else test_generate(100000, TEST_EPOCHS);
+
+    start = std::chrono::steady_clock::now();
+    frames = test_replay(false, &duration);
+    nanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL_UINT32(frames, test_ingest_data.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, test_ingest_data.rtcm_parser_data.errors);
+    test_report("unpaced", nanoseconds);
+
+    setUp();
+    frames = test_replay(true, &duration);
+    TEST_ASSERT_EQUAL_UINT32(frames, test_ingest_data.frames);
+    printf("paced: %u frames over %u ms stream time, %u pushes, %.1f frames per push\n", frames, duration, test_ingest_data.pushes, (test_ingest_data.pushes > 0) ? (double)frames / test_ingest_data.pushes : 0.0);
+    if (file == nullptr) TEST_ASSERT_EQUAL_UINT32((TEST_EPOCHS - 1) * 1000, duration);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc);
+    RUN_TEST(test_parse_errors);
+    RUN_TEST(test_false_preamble);
+    RUN_TEST(test_pacer);
+    RUN_TEST(test_ingest);
+
+    return UNITY_END();
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Summarise the startup benchmark written by the firmware.
+
+Every benchmark run of the firmware appends one line to
+/data/benchmark.csv on the SD card. This script groups the runs by start
+type and prints the distribution of every milestone in seconds since boot.
+
+    python3 benchmark_summary.py benchmark.csv
+    python3 benchmark_summary.py before.csv after.csv
+"""
+
+import argparse
+import csv
+
+MILESTONES = ["receiver_up_ms", "fix_ok_ms", "dgnss_ms", "float_ms", "fixed_ms"]
+
+
+def percentile(values, fraction):
+    """Nearest rank percentile of a sorted list."""
+    index = max(0, min(len(values) - 1, int(round(fraction * (len(values) - 1)))))
+    return values[index]
+
+
+def summarise(name, rows):
+    print(f"{name}: {len(rows)} runs")
+    print(f"  {'milestone':<16}{'n':>5}{'miss':>6}{'min':>9}{'median':>9}{'p90':>9}{'max':>9}")
+    for milestone in MILESTONES:
+        values = sorted(int(row[milestone]) / 1000 for row in rows if row.get(milestone, "") != "")
+        missing = len(rows) - len(values)
+        if len(values) == 0:
+            print(f"  {milestone:<16}{0:>5}{missing:>6}")
+            continue
+        print(f"  {milestone:<16}{len(values):>5}{missing:>6}"
+              f"{values[0]:>9.1f}{percentile(values, 0.5):>9.1f}"
+              f"{percentile(values, 0.9):>9.1f}{values[-1]:>9.1f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="+", help="benchmark CSV files")
+    args = parser.parse_args()
+
+    for path in args.files:
+        with open(path, newline="") as file:
+            rows = list(csv.DictReader(file))
+        starts = {}
+        for row in rows:
+            starts.setdefault(row["start"], []).append(row)
+        print(path)
+        for start in sorted(starts):
+            summarise(start, starts[start])
+        print()
+
+
+if __name__ == "__main__":
+    main()
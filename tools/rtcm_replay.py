@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Replay a recorded RTCM file as a local NTRIP caster.
+
+The frames are paced by the epoch time of the MSM messages like the RTCM
+replay of the firmware, so a rover (or the NTRIP client of the firmware)
+gets the corrections at their original timing without a live caster.
+
+    python3 rtcm_replay.py corrections.rtcm3 --port 2101 --mount ZED-F9P
+    python3 rtcm_replay.py corrections.rtcm3 --speed 0    # as fast as possible
+"""
+
+import argparse
+import socket
+import threading
+import time
+
+PREAMBLE = 0xD3
+RESYNC = 60000
+
+
+def crc24q(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 16
+        for _ in range(8):
+            crc <<= 1
+            if crc & 0x1000000:
+                crc ^= 0x1864CFB
+    return crc & 0xFFFFFF
+
+
+def frames(data):
+    """Yield the CRC-valid RTCM frames of a byte string."""
+    position = 0
+    while position + 6 <= len(data):
+        if data[position] != PREAMBLE or data[position + 1] & 0xFC:
+            position += 1
+            continue
+        length = ((data[position + 1] & 0x03) << 8 | data[position + 2]) + 6
+        frame = data[position:position + length]
+        if len(frame) == length and crc24q(frame[:-3]) == int.from_bytes(frame[-3:], "big"):
+            yield frame
+            position += length
+        else:
+            position += 1
+
+
+def msm_epoch(frame):
+    """Return (system, epoch in ms) of a MSM frame or None."""
+    message_type = frame[3] << 4 | frame[4] >> 4
+    if not 1071 <= message_type <= 1127 or not 1 <= message_type % 10 <= 7:
+        return None
+    system = message_type // 10
+    epoch = int.from_bytes(frame[6:10], "big") >> 2 & 0x3FFFFFFF
+    if system == 108:
+        epoch &= 0x07FFFFFF
+    return system, epoch
+
+
+class Pacer:
+    """Same pacing as rtcm_pacer_delay() of the firmware."""
+
+    def __init__(self, speed):
+        self.speed = speed
+        self.system = None
+        self.epoch = 0
+        self.timestamp = 0.0
+
+    def wait(self, frame):
+        msm = msm_epoch(frame)
+        if msm is None or self.speed == 0:
+            return
+        system, epoch = msm
+        now = time.monotonic()
+        if self.system is None:
+            self.system, self.epoch, self.timestamp = system, epoch, now
+            return
+        if system != self.system:
+            return
+        period = 86400000 if system == 108 else 604800000
+        delta = (epoch - self.epoch) % period
+        if delta > RESYNC:
+            self.epoch, self.timestamp = epoch, now
+            return
+        target = self.timestamp + delta / 1000.0 / self.speed
+        if target > now:
+            time.sleep(target - now)
+        self.epoch = epoch
+        self.timestamp = target if time.monotonic() - target < 1.0 else time.monotonic()
+
+
+class Caster:
+    def __init__(self, mount):
+        self.mount = mount
+        self.clients = []
+        self.lock = threading.Lock()
+
+    def serve(self, port):
+        server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        server.bind(("", port))
+        server.listen(5)
+        while True:
+            client, address = server.accept()
+            threading.Thread(target=self.request, args=(client, address), daemon=True).start()
+
+    def request(self, client, address):
+        client.settimeout(5)
+        request = b""
+        try:
+            while b"\r\n\r\n" not in request and len(request) < 4096:
+                data = client.recv(1024)
+                if not data:
+                    break
+                request += data
+        except OSError:
+            client.close()
+            return
+        line = request.split(b"\r\n", 1)[0].decode(errors="replace").split()
+        if len(line) >= 2 and line[0] == "GET" and line[1] == "/" + self.mount:
+            client.sendall(b"ICY 200 OK\r\n\r\n")
+            client.settimeout(None)
+            with self.lock:
+                self.clients.append(client)
+            print(f"client {address[0]}:{address[1]} connected")
+        elif len(line) >= 2 and line[0] == "GET" and line[1] == "/":
+            table = f"STR;{self.mount};{self.mount};RTCM 3.3;;2;GNSS;REPLAY;;0.00;0.00;0;0;rtcm_replay;none;N;N;0;\r\nENDSOURCETABLE\r\n"
+            client.sendall(f"SOURCETABLE 200 OK\r\nContent-Length: {len(table)}\r\n\r\n{table}".encode())
+            client.close()
+        else:
+            client.sendall(b"HTTP/1.0 404 Not Found\r\n\r\n")
+            client.close()
+
+    def push(self, frame):
+        with self.lock:
+            for client in list(self.clients):
+                try:
+                    client.sendall(frame)
+                except OSError:
+                    self.clients.remove(client)
+                    client.close()
+                    print("client disconnected")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("file", help="recorded RTCM 3 file")
+    parser.add_argument("--port", type=int, default=2101, help="caster port (default 2101)")
+    parser.add_argument("--mount", default="ZED-F9P", help="mount point (default ZED-F9P)")
+    parser.add_argument("--speed", type=float, default=1.0, help="replay speed factor, 0 = unpaced (default 1)")
+    parser.add_argument("--once", action="store_true", help="stop at the end of the file instead of looping")
+    args = parser.parse_args()
+
+    with open(args.file, "rb") as file:
+        recording = list(frames(file.read()))
+    if not recording:
+        parser.error("no valid RTCM frames in " + args.file)
+    print(f"{len(recording)} frames, {sum(len(frame) for frame in recording)} bytes")
+
+    caster = Caster(args.mount)
+    threading.Thread(target=caster.serve, args=(args.port,), daemon=True).start()
+
+    total = 0
+    last = time.monotonic()
+    while True:
+        pacer = Pacer(args.speed)
+        for frame in recording:
+            pacer.wait(frame)
+            caster.push(frame)
+            total += len(frame)
+            now = time.monotonic()
+            if now - last >= 1.0:
+                print(f"{total / (now - last):.0f} B/s, {len(caster.clients)} clients")
+                total = 0
+                last = now
+        if args.once:
+            break
+
+
+if __name__ == "__main__":
+    main()